@@ -3,8 +3,12 @@
 #ifndef STDCORELIB_CONSOLE_H
 #define STDCORELIB_CONSOLE_H
 
+#include <chrono>
 #include <cstdarg>
 #include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
 
 #include <stdcorelib/str.h>
 
@@ -100,7 +104,14 @@ namespace stdc {
         /// How many columns \a utf8 takes up when written to a terminal.
         ///
         /// Neither its length in bytes nor its length in characters: one CJK ideograph occupies
-        /// two columns, and a combining mark occupies none.
+        /// two columns, and a combining mark occupies none. An emoji sequence a terminal draws as
+        /// one picture, joined by U+200D, with a skin tone, or a pair of flag letters, counts as
+        /// that one picture.
+        ///
+        /// \note The widths come from Unicode's East Asian Width property and general categories,
+        ///       in tables generated by \c scripts/gen_width_tables.py. The text is read where it
+        ///       is, with nothing allocated, and a byte that is not valid UTF-8 counts as the
+        ///       replacement character would.
         STDC_EXPORT int display_width(const std::string_view &utf8);
 
         // @overload: display_width
@@ -254,6 +265,165 @@ namespace stdc {
         }
 
         /// @}
+
+        /// \name Batched output
+        /// @{
+
+        /// Styled text built up in memory and written out in one go.
+        ///
+        /// Every fputs() takes the console lock, writes the attributes, the text and the reset,
+        /// and lets go again, so a table drawn a cell at a time costs several writes and a lock
+        /// round trip for each cell. This collects the cells instead, each with its attributes,
+        /// and write() renders the lot into one string, with an escape sequence only where the
+        /// attributes actually change, and hands it over in one \c fwrite under one lock.
+        ///
+        /// \code
+        ///   console::styled_buffer out;
+        ///   for (const auto &test : results) {
+        ///       out.append(bold, nocolor, nocolor, test.name);
+        ///       if (test.ok) {
+        ///           out.append(nostyle, green, nocolor, " ok\n");
+        ///       } else {
+        ///           out.append(nostyle, red, nocolor, " failed\n");
+        ///       }
+        ///   }
+        ///   out.write(stdout);
+        /// \endcode
+        ///
+        /// \note Whether the attributes are written at all rests on resolve_color_mode() for the
+        ///       target, as it does for fputs(), so redirected output receives the text alone.
+        class STDC_EXPORT styled_buffer {
+        public:
+            styled_buffer() = default;
+
+            /// Appends \a text with the given attributes, which are the same as fputs() takes.
+            styled_buffer &append(int style, int fg, int bg, const std::string_view &text);
+
+            // @overload: append
+            inline styled_buffer &append(const std::string_view &text) {
+                return append(nostyle, nocolor, nocolor, text);
+            }
+
+            /// Like append(), with formatN() placeholders (\c %1, \c %2, ...).
+            template <class... Args>
+            inline styled_buffer &print(int style, int fg, int bg, const std::string_view &format,
+                                        Args &&...args) {
+                return append(style, fg, bg, formatN(format, std::forward<Args>(args)...));
+            }
+
+            /// The text so far, without any attributes.
+            inline const std::string &text() const {
+                return _text;
+            }
+
+            inline bool empty() const {
+                return _text.empty();
+            }
+
+            /// Empties the buffer, keeping its memory for the next frame.
+            void clear();
+
+            /// The text as write() would send it under \a mode: with escape sequences for \c vt,
+            /// and plain for anything else.
+            std::string render(color_mode mode) const;
+
+            /// Writes everything to \a file.
+            ///
+            /// \return the number of bytes of text written, escape sequences not counted, or
+            ///         \c EOF if the target took less than all of it
+            int write(FILE *file = stdout) const;
+
+        private:
+            struct run {
+                size_t end; // where it stops in _text
+                int style;
+                int fg;
+                int bg;
+            };
+
+            std::string _text;
+            std::vector<run> _runs;
+
+            friend class live_region;
+        };
+
+        /// A few status lines kept at the bottom of the terminal and redrawn in place, for the
+        /// progress of a long job.
+        ///
+        /// Reprinting a progress line for every step floods the terminal and costs more than the
+        /// step. This takes the lines as often as they change, draws them at most once an
+        /// interval, and then writes only the cells that differ from what is already on the
+        /// screen, each frame in one write. It has no thread of its own: a change made during
+        /// the interval is drawn by the first call after it, by refresh(), or by finish().
+        ///
+        /// Anything else to be printed while the region is up goes through println(), which
+        /// writes it above the region and draws the region again below it.
+        ///
+        /// Where resolve_color_mode() says the target is not a terminal, so that there is no
+        /// cursor to move, the lines are printed plainly instead, whenever they have changed
+        /// and at most once per plain interval, which suits a log file or a CI console.
+        ///
+        /// \code
+        ///   console::live_region status(2);
+        ///   for (size_t i = 0; i < files.size(); ++i) {
+        ///       status.set_line(0, formatN("%1 of %2", i + 1, files.size()));
+        ///       status.set_line(1, files[i]);
+        ///       process(files[i]);
+        ///   }
+        ///   status.finish();
+        /// \endcode
+        ///
+        /// \note Thread safe. A line wider than the terminal is cut at its edge, and a control
+        ///       character in one is drawn as a space, since either would put the cursor
+        ///       somewhere other than where the next redraw expects it.
+        class STDC_EXPORT live_region {
+        public:
+            /// \param lines how many lines the region keeps, at least one
+            /// \param file the target, which is decided to be a terminal or not here, once
+            explicit live_region(int lines, FILE *file = stdout);
+
+            /// Finishes the region, as finish() does.
+            ~live_region();
+
+            STDC_DISABLE_COPY_MOVE(live_region)
+
+            int lines() const;
+
+            /// Whether the lines are drawn in place, rather than printed one after another.
+            bool is_live() const;
+
+            /// The shortest time between two frames drawn in place. 100 ms by default.
+            void set_interval(std::chrono::milliseconds interval);
+
+            /// The shortest time between two printings of the lines when the target is not a
+            /// terminal. 5 seconds by default.
+            void set_plain_interval(std::chrono::milliseconds interval);
+
+            /// Replaces line \a index, and draws if the interval has passed since the last frame.
+            void set_line(int index, const styled_buffer &line);
+
+            // @overload: set_line
+            void set_line(int index, const std::string_view &text);
+
+            /// Writes \a line, and a newline, above the region.
+            void println(const styled_buffer &line);
+
+            // @overload: println
+            void println(const std::string_view &text);
+
+            /// Draws whatever has changed now, whatever the interval says.
+            void refresh();
+
+            /// Draws the last change and leaves the lines where they are, with the cursor below
+            /// them. Nothing is drawn in place after this, and println() writes plainly.
+            void finish();
+
+        private:
+            class impl;
+            std::unique_ptr<impl> _impl;
+        };
+
+        /// @}
     }
 
     using console::u8printf;
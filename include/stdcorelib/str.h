@@ -3,6 +3,7 @@
 #ifndef STDCORELIB_STR_H
 #define STDCORELIB_STR_H
 
+#include <charconv>
 #include <string>
 #include <string_view>
 #include <sstream>
@@ -65,6 +66,10 @@ namespace stdc {
         template <class T>
         struct conv;
 
+        // A specialization may also provide a static append(std::string &, const T &), which
+        // append_to() and so formatN() use in preference to operator(), to write straight into
+        // the output rather than into a string of its own first.
+
         template <>
         struct conv<std::string> {
             inline std::string operator()(const std::string &s) const {
@@ -75,6 +80,10 @@ namespace stdc {
             inline std::string operator()(std::string &&s) const {
                 return s;
             }
+
+            static inline void append(std::string &out, const std::string &s) {
+                out.append(s);
+            }
         };
 
         template <>
@@ -82,6 +91,10 @@ namespace stdc {
             inline std::string operator()(const std::string_view &s) const {
                 return {s.data(), s.size()};
             }
+
+            static inline void append(std::string &out, const std::string_view &s) {
+                out.append(s);
+            }
         };
 
         template <>
@@ -89,6 +102,10 @@ namespace stdc {
             inline std::string operator()(const char *s) const {
                 return s;
             }
+
+            static inline void append(std::string &out, const char *s) {
+                out.append(s);
+            }
         };
 
         template <>
@@ -171,6 +188,62 @@ namespace stdc {
                                                                       bool native);
         };
 
+        namespace detail {
+
+            template <class T, class = void>
+            struct has_conv_append : std::false_type {};
+
+            template <class T>
+            struct has_conv_append<T, std::void_t<decltype(conv<T>::append(
+                                          std::declval<std::string &>(), std::declval<const T &>()))>>
+                : std::true_type {};
+
+        }
+
+        /// Appends \a value as <tt>%g</tt> would print it, which is what an \c std::ostream
+        /// gives with its default flags and precision.
+        STDC_EXPORT void append_number(std::string &out, double value);
+
+        // @overload: append_number(string, double)
+        STDC_EXPORT void append_number(std::string &out, long double value);
+
+        /// Appends \a t to \a out as to_string() would render it, without a string in between
+        /// where the type allows.
+        template <class T>
+        void append_to(std::string &out, const T &t) {
+            if constexpr (std::is_pointer_v<T> || std::is_array_v<T>) {
+                using T2 = std::add_pointer_t<
+                    std::remove_cv_t<std::remove_pointer_t<std::decay_t<T>>>>;
+                if constexpr (detail::has_conv_append<T2>::value) {
+                    conv<T2>::append(out, t);
+                } else {
+                    out.append(conv<T2>()(t));
+                }
+            } else if constexpr (std::is_same_v<T, bool>) {
+                out.append(t ? "true" : "false");
+            } else if constexpr (std::is_same_v<T, char>) {
+                out.push_back(t);
+            } else if constexpr (std::is_same_v<T, wchar_t>) {
+                out.append(conv<std::wstring>::to_utf8(&t, 1));
+            } else if constexpr (std::is_integral_v<T>) {
+                // Promoted first, as std::to_string() would have it, so that the character types
+                // come out as numbers.
+                char buf[48];
+                auto res = std::to_chars(buf, buf + sizeof(buf), +t);
+                out.append(buf, res.ptr);
+            } else if constexpr (std::is_floating_point_v<T>) {
+                if constexpr (std::is_same_v<T, long double>) {
+                    append_number(out, t);
+                } else {
+                    append_number(out, double(t));
+                }
+            } else if constexpr (detail::has_conv_append<T>::value) {
+                conv<T>::append(out, t);
+            } else {
+                out.append(conv<T>()(t));
+            }
+        }
+
         /// Renders \a t as UTF-8.
         ///
         /// Handles the arithmetic types, \c char and \c wchar_t, and anything \c str::conv has a
@@ -185,18 +258,10 @@ namespace stdc {
                 return str::conv<T2>()(t);
             } else {
                 using T2 = std::decay_t<std::remove_cv_t<T1>>;
-                if constexpr (std::is_same_v<T2, bool>) {
-                    return t ? "true" : "false";
-                } else if constexpr (std::is_same_v<T2, char>) {
-                    return std::string(1, t);
-                } else if constexpr (std::is_same_v<T2, wchar_t>) {
-                    return conv<std::wstring>::to_utf8(&t, 1);
-                } else if constexpr (std::is_integral_v<T2>) {
-                    return std::to_string(t);
-                } else if constexpr (std::is_floating_point_v<T2>) {
-                    std::ostringstream oss;
-                    oss << std::noshowpoint << t;
-                    return oss.str();
+                if constexpr (std::is_arithmetic_v<T2>) {
+                    std::string res;
+                    append_to(res, static_cast<T2>(t));
+                    return res;
                 } else {
                     return str::conv<T2>()(std::forward<T>(t));
                 }
@@ -242,7 +307,49 @@ namespace stdc {
         STDC_EXPORT std::string format(const std::string_view &fmt,
                                              const array_view<std::string> &args);
 
-        /// format() with the arguments spelled out, each run through to_string() first.
+        /// One argument to format_to(), with the type taken out: where it is, and how to append
+        /// it to the output.
+        struct format_arg {
+            const void *value;
+            void (*append)(std::string &out, const void *value);
+
+            template <class T>
+            static format_arg of(const T &value) {
+                return {
+                    &value,
+                    [](std::string &out, const void *v) { append_to(out, *static_cast<const T *>(v)); },
+                };
+            }
+        };
+
+        /// The engine under format() and formatN(), appending to \a out instead of returning a
+        /// string of its own.
+        ///
+        /// Each argument is converted as its placeholder is reached and written straight into
+        /// \a out, so the only allocation is \a out growing, and not even that once a buffer that
+        /// is reused has grown to fit.
+        STDC_EXPORT void format_to(std::string &out, const std::string_view &fmt,
+                                   const format_arg *args, size_t count);
+
+        /// formatN(), appending to \a out rather than returning a new string, for a caller
+        /// that keeps a buffer to format into.
+        ///
+        /// \code
+        ///   thread_local std::string buf;
+        ///   buf.clear();
+        ///   formatN_to(buf, "%1 took %2 ms", name, elapsed);
+        /// \endcode
+        template <class... Args>
+        void formatN_to(std::string &out, const std::string_view &fmt, const Args &...args) {
+            if constexpr (sizeof...(Args) == 0) {
+                out.append(fmt); // as formatN(fmt) has it, without looking at the placeholders
+            } else {
+                const format_arg list[] = {format_arg::of(args)...};
+                format_to(out, fmt, list, sizeof...(Args));
+            }
+        }
+
+        /// format() with the arguments spelled out, each converted as to_string() would.
         ///
         /// The placeholders are \c %1, \c %2, not printf conversions, so the arguments carry
         /// their own types and there is no conversion specifier to get wrong.
@@ -251,13 +358,12 @@ namespace stdc {
         ///   formatN("%1 took %2 ms", name, elapsed);
         /// \endcode
         ///
-        /// \sa format(), to_string()
+        /// \sa format(), to_string(), formatN_to()
         template <class Arg1, class... Args>
         std::string formatN(const std::string_view &fmt, Arg1 &&arg1, Args &&...args) {
-            return format(fmt, {
-                                   to_string(std::forward<Arg1>(arg1)),
-                                   to_string(std::forward<Args>(args))...,
-                               });
+            std::string res;
+            formatN_to(res, fmt, arg1, args...);
+            return res;
         }
 
         // @overload: formatN(string_view)
@@ -306,6 +412,7 @@ namespace stdc {
     using str::split;
     using str::format;
     using str::formatN;
+    using str::formatN_to;
 
     using wstring_conv = str::conv<std::wstring>;
 
@@ -0,0 +1,80 @@
+// SPDX-License-Identifier: MIT
+
+#ifndef STDCORELIB_FORKSERVER_H
+#define STDCORELIB_FORKSERVER_H
+
+#include <string>
+
+#include <stdcorelib/stdc_global.h>
+
+#ifndef _WIN32
+
+namespace stdc {
+
+    /// \addtogroup process
+    /// @{
+
+    /// A small helper process that forks children on this process's behalf.
+    ///
+    /// What fork() costs grows with the memory of the process calling it: the page tables are
+    /// copied whole, and copy on write then faults in every page either side touches before the
+    /// child gets to exec. For a parent with gigabytes mapped that is the bulk of starting a
+    /// child, and vfork(), where Popen can use it, avoids only the first half. The server is
+    /// forked once, while this process is still small, and forks every child after that from
+    /// its own few megabytes.
+    ///
+    /// \code
+    ///   int main(int argc, char *argv[]) {
+    ///       stdc::ForkServer::start(); // before the process grows, and before any threads
+    ///       ...
+    ///   }
+    /// \endcode
+    ///
+    /// Nothing changes for Popen. start() sends the server what the child is to be, along with
+    /// its pipes and descriptors, over a Unix socket. The child is then set up by the same code
+    /// as one forked here. The server reaps it and reports the exit status and resource usage
+    /// back, so wait(), poll(), exit_fd() and resource_usage() answer as for any other child.
+    /// kill() never goes by the bare pid, which the server's reaping frees while this process
+    /// may not know yet: it goes through a pidfd the server passes back on Linux 5.3 and
+    /// later, and otherwise through the server, which signals only a child it has not reaped.
+    ///
+    /// The standard streams, the working directory and the environment go with each child as
+    /// they are at the time. What a child inherits from whoever forks it, and is not sent, is
+    /// the server's: the signal dispositions, the signal mask, the umask and the resource
+    /// limits this process had when the server started. The child's parent is the server,
+    /// which is what \c getppid() says in it.
+    ///
+    /// \note A Popen with preexec_fn() or detached() set is forked here as before, since the
+    ///       function is in this process's memory and the launcher for a detached child already
+    ///       forks twice.
+    /// \note The server stops taking children when this process ends, or at stop(), and exits
+    ///       once every child it started has exited and been reported. It is not a child of
+    ///       this process, so there is nothing here to wait for it.
+    class STDC_EXPORT ForkServer {
+    public:
+        /// Starts the server, if it is not running already.
+        ///
+        /// \param err_msg filled in with a readable description when this fails, if not null
+        /// \retval false there is no server, and children are forked here as without one
+        /// \warning It is forked from the calling thread alone, as any child is. Call this
+        ///          before other threads start, so that none of them holds a lock the server
+        ///          will need.
+        static bool start(std::string *err_msg = nullptr);
+
+        /// Lets the server go, after the children already asked for have started. Later starts
+        /// fork here again. Does not wait.
+        static void stop();
+
+        static bool is_running();
+
+        /// The server's pid, or -1 when it is not running.
+        static int pid();
+    };
+
+    /// @}
+
+}
+
+#endif
+
+#endif // STDCORELIB_FORKSERVER_H
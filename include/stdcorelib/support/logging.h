@@ -3,6 +3,15 @@
 #ifndef STDCORELIB_LOGGING_H
 #define STDCORELIB_LOGGING_H
 
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+
 #include <stdcorelib/str.h>
 
 /// \defgroup logging Logging
@@ -22,7 +31,20 @@
 /// \endcode
 ///
 /// \c Logger::setLogCallback() replaces the sink, which is how records reach a file or a UI instead
-/// of the terminal.
+/// of the terminal, and \c Logger::startAsync() moves that sink onto a background thread.
+
+/// The lowest level the logging macros compile in, numbered as Logger::Level is: 2 drops
+/// \c stdcTrace, 3 drops \c stdcDebug as well, and so on. Calls below it compile to nothing and
+/// their arguments are never evaluated. \c Fatal is kept whatever this says, since the abort after
+/// it is not something to compile away.
+///
+/// It is read at each expansion, so a file may set its own ahead of the include, though it is
+/// usually one definition for the whole build. Only the macros look at it. The filter rules still
+/// decide at run time about whatever is compiled in, and LogCategory::log() called directly is not
+/// affected.
+#ifndef STDC_LOG_MIN_LEVEL
+#  define STDC_LOG_MIN_LEVEL 0
+#endif
 
 namespace stdc {
 
@@ -41,8 +63,146 @@ namespace stdc {
         const char *file = nullptr;
         const char *function = nullptr;
         const char *category = nullptr;
+
+        /// When the record was made, in nanoseconds since the Unix epoch as
+        /// Logger::timestampClock() tells it, or zero before any record has been made with this
+        /// context. Stamped once, on the thread that logs, so a sink need not read a clock.
+        int64_t time = 0;
+
+        /// The system's id for the thread the record was made on, as a debugger or \c top
+        /// shows it, or zero along with \c time.
+        uint64_t thread = 0;
+    };
+
+    /// One typed key/value pair attached to a record, which stdcLogKV() and the macros beside it
+    /// take. A sink is handed them as they are, and one that writes for a machine can keep the
+    /// types rather than parse them back out of the text.
+    ///
+    /// Like the record it belongs to, a field points into memory it does not own: the key and a
+    /// string value are views.
+    struct STDC_EXPORT LogField {
+        enum Type {
+            Bool,
+            Int,
+            UInt,
+            Double,
+            String,
+        };
+
+        template <class T>
+        LogField(std::string_view key, const T &value) : key(key) {
+            if constexpr (std::is_same_v<T, bool>) {
+                type = Bool;
+                b = value;
+            } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+                type = Int;
+                i = value;
+            } else if constexpr (std::is_integral_v<T>) {
+                type = UInt;
+                u = value;
+            } else if constexpr (std::is_floating_point_v<T>) {
+                type = Double;
+                d = double(value);
+            } else {
+                static_assert(std::is_convertible_v<const T &, std::string_view>,
+                              "a log field is a bool, a number or a string");
+                type = String;
+                s = std::string_view(value);
+            }
+        }
+
+        std::string_view key;
+        Type type = String;
+        union {
+            bool b;
+            int64_t i = 0;
+            uint64_t u;
+            double d;
+        };
+        std::string_view s;
+
+        /// Appends \a fields as <tt> key=value</tt> pairs, each with a space in front, which is
+        /// how they reach the callback and a sink that writes text. A string that would not read
+        /// back as one token is quoted.
+        static void appendTo(std::string &out, const array_view<LogField> &fields);
+    };
+
+    /// One record as a LogSink is handed it. Everything in it belongs to the caller and lasts
+    /// for the duration of the call only, so a sink that keeps a record copies what it needs.
+    struct LogRecord {
+        int level = 0;
+        LogContext context;
+        std::string_view message;
+
+        /// Empty unless the record came from stdcLogKV() or Logger::print() was given some. The
+        /// message does not repeat them.
+        array_view<LogField> fields;
     };
 
+    class LogSink;
+
+    namespace detail {
+
+        // What a deferred log record can capture: values whose formatting depends on nothing but
+        // themselves, so that formatting them later on another thread gives the same text.
+        template <class T>
+        inline constexpr bool log_capturable_v =
+            std::is_arithmetic_v<T> || std::is_same_v<T, std::string> ||
+            std::is_same_v<T, std::string_view> || std::is_same_v<T, const char *> ||
+            std::is_same_v<T, char *>;
+
+        // Arithmetic values are stored as their bytes, strings as a length and their bytes.
+        template <class T>
+        inline void log_encode(std::string &out, const T &value) {
+            if constexpr (std::is_arithmetic_v<T>) {
+                out.append(reinterpret_cast<const char *>(&value), sizeof(T));
+            } else {
+                std::string_view s;
+                if constexpr (std::is_pointer_v<T>) {
+                    // The eager path would have built a std::string from the null and crashed,
+                    // which is not worth reproducing on the writer thread.
+                    if (value) {
+                        s = value;
+                    }
+                } else {
+                    s = value;
+                }
+                size_t size = s.size();
+                out.append(reinterpret_cast<const char *>(&size), sizeof(size));
+                out.append(s.data(), size);
+            }
+        }
+
+        template <class T>
+        inline auto log_decode(const char *&p) {
+            if constexpr (std::is_arithmetic_v<T>) {
+                T value;
+                std::memcpy(&value, p, sizeof(T));
+                p += sizeof(T);
+                return value;
+            } else {
+                size_t size;
+                std::memcpy(&size, p, sizeof(size));
+                p += sizeof(size);
+                std::string_view s(p, size);
+                p += size;
+                return s;
+            }
+        }
+
+        // Instantiated once per argument list and handed over as a function pointer, which is
+        // all the writer thread needs to know about the types.
+        template <class... Args>
+        std::string log_format(const std::string_view &format, const std::string_view &payload) {
+            const char *p = payload.data();
+            // Braced, so the arguments decode in order.
+            std::tuple<decltype(log_decode<Args>(p))...> values{log_decode<Args>(p)...};
+            return std::apply(
+                [&](const auto &...value) { return stdc::formatN(format, value...); }, values);
+        }
+
+    }
+
     class STDC_EXPORT Logger {
     public:
         enum Level {
@@ -64,51 +224,155 @@ namespace stdc {
 
         template <class... Args>
         inline void trace(const std::string_view &format, Args &&...args) {
-            print(Trace, stdc::formatN(format, std::forward<Args>(args)...));
+            dispatch(Trace, format, std::forward<Args>(args)...);
         }
 
         template <class... Args>
         inline void debug(const std::string_view &format, Args &&...args) {
-            print(Debug, stdc::formatN(format, std::forward<Args>(args)...));
+            dispatch(Debug, format, std::forward<Args>(args)...);
         }
 
         template <class... Args>
         inline void success(const std::string_view &format, Args &&...args) {
-            print(Success, stdc::formatN(format, std::forward<Args>(args)...));
+            dispatch(Success, format, std::forward<Args>(args)...);
         }
 
         template <class... Args>
         inline void info(const std::string_view &format, Args &&...args) {
-            print(Information, stdc::formatN(format, std::forward<Args>(args)...));
+            dispatch(Information, format, std::forward<Args>(args)...);
         }
 
         template <class... Args>
         inline void warning(const std::string_view &format, Args &&...args) {
-            print(Warning, stdc::formatN(format, std::forward<Args>(args)...));
+            dispatch(Warning, format, std::forward<Args>(args)...);
         }
 
         template <class... Args>
         inline void critical(const std::string_view &format, Args &&...args) {
-            print(Critical, stdc::formatN(format, std::forward<Args>(args)...));
+            dispatch(Critical, format, std::forward<Args>(args)...);
         }
 
         template <class... Args>
         [[noreturn]] inline void fatal(const std::string_view &format, Args &&...args) {
-            print(Fatal, stdc::formatN(format, std::forward<Args>(args)...));
+            dispatch(Fatal, format, std::forward<Args>(args)...);
             abort();
         }
 
         template <class... Args>
         inline void log(int level, const std::string_view &format, Args &&...args) {
-            print(level, stdc::formatN(format, std::forward<Args>(args)...));
+            dispatch(level, format, std::forward<Args>(args)...);
         }
 
-        void print(int level, const std::string_view &message);
+        /// Emits \a message as it is, with \a fields attached. The callback sees the fields
+        /// appended to the message as text, and a sink is handed them apart.
+        void print(int level, const std::string_view &message,
+                   const array_view<LogField> &fields = {});
 
         void printf(int level, const char *fmt, ...);
 
         [[noreturn]] static void abort();
 
+        /// The lowercase name of \a level, the same one a logging rule uses, or \c "unknown" for
+        /// anything that is not a Level.
+        static const char *levelName(int level);
+
+        /// Where the timestamp in LogContext::time comes from. Each is monotonic and counts
+        /// nanoseconds since the Unix epoch, so a sink can format any of them the same way: the
+        /// system clock is read once, at the first timestamp, and the time elapsed since then
+        /// added to it. Setting the system clock afterwards moves no timestamp, and they drift
+        /// apart by as much.
+        enum TimestampClock {
+            /// \c std::chrono::steady_clock, the default.
+            PreciseClock,
+
+            /// The time as of the last timer tick, a few milliseconds behind at worst but a
+            /// fraction of the cost: \c CLOCK_MONOTONIC_COARSE on Linux, and
+            /// \c GetTickCount64() on Windows.
+            CoarseClock,
+
+            /// The processor's invariant time stamp counter, calibrated against the precise clock
+            /// when it is selected and counted from there, costing about as much as a
+            /// multiplication. x86 only.
+            CycleCounter,
+        };
+
+        /// Selects the clock for the whole process, and returns whether this platform has it.
+        /// Selecting \c CycleCounter takes some milliseconds to calibrate.
+        ///
+        /// \note Meant to be called before logging starts, like setLogCallback().
+        static bool setTimestampClock(TimestampClock clock);
+        static TimestampClock timestampClock();
+
+        /// Now, by the selected clock.
+        static int64_t timestamp();
+
+        /// The system's id for the calling thread, looked up once per thread and kept.
+        static uint64_t currentThreadId();
+
+    public:
+        struct FlightRecorderOptions {
+            /// How many records each thread keeps, the oldest written over first.
+            size_t slotsPerThread = 2048;
+
+            /// The size of one slot, the record's header included. A longer message is cut.
+            size_t slotSize = 256;
+
+            /// Where a dump goes, appended to, or standard error if empty.
+            std::string dumpPath;
+
+            /// Also dump from a handler for \c SIGSEGV, \c SIGBUS, \c SIGILL, \c SIGFPE and
+            /// \c SIGABRT, which then puts back whatever handled the signal before, a crash
+            /// reporter say, and raises it again for that to run or to take the process down.
+            bool crashHandler = false;
+        };
+
+        /// Starts keeping the last records of every thread in memory, for a dump to show what
+        /// led up to a crash.
+        ///
+        /// Every record goes in, whatever the sinks take, and the levels the filter rules have
+        /// switched off as well: with the recorder on, a \c stdcTrace that prints nothing is
+        /// still formatted and kept. Each thread writes into a ring of its own, so keeping a
+        /// record is a copy into memory nobody else writes to, and takes no lock.
+        ///
+        /// The rings are dumped, oldest record first across all threads, by abort(), so on every
+        /// \c stdcFatal, and from the crash handler if one was asked for.
+        ///
+        /// \note Levels below #STDC_LOG_MIN_LEVEL are compiled out and so never kept. Changing
+        ///       the sizes on a later start leaves the rings of the earlier one to the dump,
+        ///       without new records, rather than free them under a thread that may be writing.
+        static bool startFlightRecorder(const FlightRecorderOptions &options);
+        static bool startFlightRecorder();
+        static void stopFlightRecorder();
+
+        static inline bool isFlightRecording() {
+            return _flightRecording.load(std::memory_order_relaxed);
+        }
+
+        /// Writes out what the rings hold, to where the options said. Only async-signal-safe
+        /// calls are made, so this may be called from a signal handler of your own. While
+        /// another dump is under way this one does nothing.
+        static void dumpFlightRecorder();
+
+        /// Keeps a record in the flight recorder and sends it nowhere else. What the macros do
+        /// for a level that is switched off while the recorder is on.
+        template <class... Args>
+        inline void remember(int level, const std::string_view &format, Args &&...args) {
+            thread_local std::string buffer;
+            thread_local bool buffered = false;
+            if (buffered) {
+                rememberText(level, stdc::formatN(format, std::forward<Args>(args)...));
+                return;
+            }
+            buffered = true;
+            buffer.clear();
+            stdc::formatN_to(buffer, format, args...);
+            rememberText(level, buffer);
+            buffered = false;
+        }
+
+        // @overload: remember(), for a message that is already text
+        void rememberText(int level, const std::string_view &message);
+
     public:
         using LogCallback = void (*)(int, const LogContext &, const std::string_view &);
 
@@ -119,8 +383,314 @@ namespace stdc {
         /// \param callback the new sink, or \c nullptr to put the built-in one back
         static void setLogCallback(LogCallback callback);
 
+    public:
+        /// What a thread does with a record when the async queue has no room for it.
+        enum OverflowPolicy {
+            Block,      ///< wait for the writer to make room, so nothing is lost
+            DropNewest, ///< discard the record being logged
+            DropOldest, ///< discard the oldest queued record to make room for this one
+        };
+
+        /// Moves delivery onto a background thread.
+        ///
+        /// Records then go into a bounded lock-free queue, and a writer thread hands them to the
+        /// callback in order, so the thread that logs no longer waits on the terminal or the disk
+        /// or on the lock around them.
+        ///
+        /// \param capacity how many records the queue holds, rounded up to a power of two
+        /// \param policy what to do when it is full
+        /// \return \c false if the async mode was already on, in which case nothing changes
+        ///
+        /// Formatting moves to the writer thread as well, for records whose arguments are all
+        /// numbers or strings. Those are copied as they are, and the message is only put together
+        /// once the record comes off the queue.
+        ///
+        /// \note \c Fatal records skip the queue. Everything queued before one is flushed, and it
+        ///       is then delivered on the calling thread, so it is written before abort() runs.
+        ///       A record logged from inside the callback is delivered on the spot as well.
+        static bool startAsync(size_t capacity = 8192, OverflowPolicy policy = Block);
+
+        /// Delivers whatever is still queued, stops the writer thread, and goes back to calling
+        /// the callback on the thread that logs.
+        static void stopAsync();
+
+        static bool isAsync();
+
+        /// Waits until every record queued before the call has reached the callback and the
+        /// sinks, then has each sink flush whatever it buffers.
+        static void flush();
+
+        /// How many records the overflow policy has discarded since startAsync().
+        static uint64_t droppedCount();
+
+    public:
+        /// Adds a sink that every record goes to, beside the callback rather than instead of
+        /// it. Records reach it on whichever thread delivers them, which is the logging thread,
+        /// or the writer thread in the async mode.
+        ///
+        /// \return \c false if \a sink was already added, or is null
+        static bool addSink(std::shared_ptr<LogSink> sink);
+
+        /// Adds a sink with a queue and a thread of its own, so that a slow one holds up nobody
+        /// but itself. It is handed records in batches, through LogSink::writeBatch().
+        ///
+        /// \param capacity how many records its queue holds, rounded up to a power of two
+        /// \param policy what to do when that queue is full
+        static bool addSink(std::shared_ptr<LogSink> sink, size_t capacity,
+                            OverflowPolicy policy = Block);
+
+        /// addSink() for a function, with whatever context it captures standing in for a
+        /// subclass of LogSink.
+        ///
+        /// \return the sink made around \a func, which is what removeSink() takes
+        static std::shared_ptr<LogSink> addSink(std::function<void(const LogRecord &)> func,
+                                                int minimumLevel = Trace);
+
+        /// Removes a sink, delivering whatever is still in its queue first.
+        static bool removeSink(const std::shared_ptr<LogSink> &sink);
+
+    public:
+        /// Turns a format string and the arguments captured for it back into the message.
+        ///
+        /// \internal
+        using LogFormatter = std::string (*)(const std::string_view &format,
+                                             const std::string_view &payload);
+
     protected:
+        /// Queues a record whose arguments were captured by value, for \a formatter to format on
+        /// the writer thread. Formats on the spot instead when the async mode is off by now.
+        void printDeferred(int level, const std::string_view &format, LogFormatter formatter,
+                           const std::string_view &payload);
+
+        /// The common path of the templates above.
+        ///
+        /// With the async mode on, and every argument a number or a string, formatting is left
+        /// to the writer thread: the arguments are copied into a buffer of the calling thread's
+        /// own, and what the caller pays for is those copies rather than a to_string() each, the
+        /// vector holding them and the message built out of them. Anything else, a path or a
+        /// wide string say, is formatted here as before, since the conversion may depend on state
+        /// that the writer would see later or not at all.
+        template <class... Args>
+        inline void dispatch(int level, const std::string_view &format, Args &&...args) {
+            if constexpr (sizeof...(Args) > 0 &&
+                          (detail::log_capturable_v<std::decay_t<Args>> && ...)) {
+                if (level < Fatal && isAsync()) {
+                    thread_local std::string payload;
+                    payload.clear();
+                    (detail::log_encode(payload, args), ...);
+                    printDeferred(level, format, &detail::log_format<std::decay_t<Args>...>,
+                                  payload);
+                    return;
+                }
+            }
+            // Formatted into a buffer the thread keeps, so that once it has grown a record costs
+            // no allocation. A sink that logs comes back through here while the outer message
+            // still lives in that buffer, and gets a string of its own instead.
+            thread_local std::string buffer;
+            thread_local bool buffered = false;
+            if (buffered) {
+                print(level, stdc::formatN(format, std::forward<Args>(args)...));
+                return;
+            }
+            buffered = true;
+            buffer.clear();
+            stdc::formatN_to(buffer, format, args...);
+            print(level, buffer);
+            buffered = false;
+        }
+
         LogContext _context;
+
+        static std::atomic<bool> _flightRecording;
+    };
+
+    /// Somewhere for records to go, which Logger::addSink() puts beside the callback.
+    ///
+    /// Each sink chooses what it takes: a minimum level, and optionally a category pattern with
+    /// the same \c * wildcards the filter rules use. Those are looked at before the record is
+    /// handed over, and on the logging thread even for a queued sink, so a record the sink does
+    /// not want never takes a place in its queue.
+    ///
+    /// \code
+    ///   class MetricsSink : public stdc::LogSink {
+    ///   public:
+    ///       void write(const stdc::LogRecord &record) override {
+    ///           counters[record.level]++;
+    ///       }
+    ///   };
+    ///
+    ///   auto sink = std::make_shared<MetricsSink>();
+    ///   sink->setMinimumLevel(stdc::Logger::Warning);
+    ///   stdc::Logger::addSink(sink);
+    /// \endcode
+    ///
+    /// \note The level and the pattern are read without a lock, so set them before adding the
+    ///       sink.
+    class STDC_EXPORT LogSink {
+    public:
+        LogSink();
+        virtual ~LogSink();
+
+        virtual void write(const LogRecord &record) = 0;
+
+        /// Takes several records at once, which is how a queued sink is handed them. The default
+        /// writes them one at a time, and a sink that can do better with a batch, one system call
+        /// for the lot say, overrides this as well.
+        virtual void writeBatch(const array_view<LogRecord> &records);
+
+        /// Called by Logger::flush(), and before a \c Fatal record takes the process down.
+        virtual void flush();
+
+        inline int minimumLevel() const {
+            return _minimumLevel;
+        }
+        inline void setMinimumLevel(int level) {
+            _minimumLevel = level;
+        }
+
+        inline const std::string &categoryFilter() const {
+            return _categoryFilter;
+        }
+
+        /// Restricts the sink to matching categories: \c "app.io" exactly, \c "app.*" by
+        /// prefix, \c "*.io" by suffix, \c "*io*" anywhere. Empty, the default, takes all of
+        /// them.
+        void setCategoryFilter(std::string pattern);
+
+        /// Whether a record at \a level in \a category is one this sink takes.
+        bool accepts(int level, const char *category) const;
+
+    protected:
+        int _minimumLevel = Logger::Trace;
+        std::string _categoryFilter;
+        int _matchMode = 0;
+        std::string _matchText;
+
+        STDC_DISABLE_COPY_MOVE(LogSink)
+    };
+
+    /// Turns LogContext::time into text, <tt>2026-10-18 15:30:00.123</tt> say, and does as
+    /// little of the work again as it can.
+    ///
+    /// Consecutive records mostly fall within the same minute, so the date and the hour and
+    /// minute are kept from the record before, and only the seconds and the fraction are
+    /// written over. The calendar arithmetic runs once a minute rather than once a record.
+    ///
+    /// \note Not thread safe. Each thread, or each sink under its own lock, keeps its own.
+    class STDC_EXPORT LogTimeFormatter {
+    public:
+        enum Precision {
+            Seconds,
+            Milliseconds,
+            Microseconds,
+            Nanoseconds,
+        };
+
+        /// \param utc UTC, or the local time zone if not
+        explicit LogTimeFormatter(bool utc = true, Precision precision = Milliseconds);
+
+        /// The text for \a time, nanoseconds since the epoch, valid until the next call.
+        std::string_view format(int64_t time);
+
+    protected:
+        bool _utc;
+        Precision _precision;
+        int64_t _minute; // the minute the text holds the date and time of
+        size_t _prefix;  // where the seconds go, after the date, the hour and the minute
+        char _text[48];
+    };
+
+    /// The state behind one rate-limited call site, which stdcLogEveryN() and the macros beside
+    /// it keep in a static of their own.
+    ///
+    /// A record the limiter holds back costs a relaxed increment or two and nothing else: its
+    /// arguments are never evaluated, and the next record that does go out says how many were
+    /// held back before it.
+    class LogLimiter {
+    public:
+        enum Kind {
+            EveryN,    ///< the first record, and every Nth after it
+            FirstN,    ///< the first N records, and none after them
+            PerSecond, ///< at most N records in any one second
+        };
+
+        /// What admit() decided.
+        struct Admission {
+            bool pass = false;
+            uint64_t suppressed = 0; ///< held back since the last record that passed
+            bool last = false;       ///< the last record a FirstN limiter lets through
+
+            explicit operator bool() const {
+                return pass;
+            }
+
+            /// \a message with a note of what was held back, if anything was.
+            std::string annotate(std::string message) const {
+                if (suppressed > 0) {
+                    message += " (";
+                    message += std::to_string(suppressed);
+                    message += " similar suppressed)";
+                }
+                if (last) {
+                    message += " (limit reached, further ones suppressed)";
+                }
+                return message;
+            }
+        };
+
+        /// \param n zero is taken as one
+        constexpr LogLimiter(Kind kind, uint32_t n) : _kind(kind), _n(n ? n : 1) {
+        }
+
+        inline Admission admit() {
+            Admission result;
+            switch (_kind) {
+                case EveryN:
+                    result.pass = _count.fetch_add(1, std::memory_order_relaxed) % _n == 0;
+                    break;
+                case FirstN: {
+                    auto count = _count.fetch_add(1, std::memory_order_relaxed);
+                    result.pass = count < _n;
+                    result.last = count + 1 == _n;
+                    break;
+                }
+                default:
+                    result.pass = admitThisSecond();
+                    break;
+            }
+            if (!result.pass) {
+                _suppressed.fetch_add(1, std::memory_order_relaxed);
+                return result;
+            }
+            // A read first, since nothing was held back far more often than something was, and
+            // the exchange would write the line for nothing.
+            if (_suppressed.load(std::memory_order_relaxed) > 0) {
+                result.suppressed = _suppressed.exchange(0, std::memory_order_relaxed);
+            }
+            return result;
+        }
+
+    protected:
+        // The second in the high half and the count within it in the low half, so that moving
+        // on to a new second and counting the first record in it is one compare and swap.
+        inline bool admitThisSecond() {
+            using namespace std::chrono;
+            uint64_t now =
+                uint64_t(duration_cast<seconds>(steady_clock::now().time_since_epoch()).count());
+            now &= 0xffffffff;
+
+            uint64_t state = _count.load(std::memory_order_relaxed);
+            if ((state >> 32) != now &&
+                _count.compare_exchange_strong(state, (now << 32) | 1, std::memory_order_relaxed)) {
+                return true;
+            }
+            return (_count.fetch_add(1, std::memory_order_relaxed) & 0xffffffff) < _n;
+        }
+
+        Kind _kind;
+        uint32_t _n;
+        std::atomic<uint64_t> _count{0};
+        std::atomic<uint64_t> _suppressed{0};
     };
 
     /// A named channel with independently switchable levels, after Qt's \c QLoggingCategory.
@@ -128,6 +698,10 @@ namespace stdc {
     /// Each category registers itself on construction and picks up whatever filter rules are
     /// already in effect.
     ///
+    /// The levels a category has enabled are one atomic mask, which a rules change replaces
+    /// whole. A logging thread reads it without a lock, so it never waits on a rules change, on
+    /// other categories being created, or on anything else.
+    ///
     /// \sa setFilterRules()
     class STDC_EXPORT LogCategory {
     public:
@@ -138,10 +712,23 @@ namespace stdc {
             return _name;
         }
         inline bool isLevelEnabled(int level) const {
-            return levelEnabled[level];
+            return (_levels.load(std::memory_order_relaxed) >> level) & 1;
         }
         inline void setLevelEnabled(int level, bool enabled) {
-            levelEnabled[level] = enabled;
+            if (enabled) {
+                _levels.fetch_or(uint32_t(1) << level);
+            } else {
+                _levels.fetch_and(~(uint32_t(1) << level));
+            }
+        }
+
+        /// Every level at once, bit \c n for level \c n, so that a filter can publish what it
+        /// worked out in one store rather than one level after another.
+        inline uint32_t levelMask() const {
+            return _levels.load(std::memory_order_relaxed);
+        }
+        inline void setLevelMask(uint32_t mask) {
+            _levels.store(mask);
         }
 
         using LogCategoryFilter = void (*)(LogCategory *);
@@ -172,6 +759,11 @@ namespace stdc {
         ///
         /// Rules apply in order over an all-enabled baseline, so a later match wins.
         ///
+        /// The rules are compiled once here, and what a category then costs, here or when it is
+        /// created later, goes with the length of its name and the rules that match it rather
+        /// than with how many rules there are. Logging carries on meanwhile: each category's
+        /// levels change in one store, and nothing on the logging path waits for the rest.
+        ///
         /// \code
         ///   *.debug = false          // silence debug everywhere
         ///   stdc.io = false          // silence the stdc.io category
@@ -188,6 +780,10 @@ namespace stdc {
         void log(const char *fileName, int lineNumber, const char *functionName,
                  const std::string_view &format, Args &&...args) const {
             if (!isLevelEnabled(Level)) {
+                if (Logger::isFlightRecording()) {
+                    Logger(fileName, lineNumber, functionName, _name)
+                        .remember(Level, format, std::forward<Args>(args)...);
+                }
                 return;
             }
             Logger(fileName, lineNumber, functionName, _name)
@@ -201,6 +797,10 @@ namespace stdc {
         void logf(const char *fileName, int lineNumber, const char *functionName, const char *fmt,
                   Args &&...args) const {
             if (!isLevelEnabled(Level)) {
+                if (Logger::isFlightRecording()) {
+                    Logger(fileName, lineNumber, functionName, _name)
+                        .rememberText(Level, asprintf(fmt, std::forward<Args>(args)...));
+                }
                 return;
             }
             Logger(fileName, lineNumber, functionName, _name)
@@ -210,17 +810,145 @@ namespace stdc {
             }
         }
 
+        /// What the macros expand to. \a args is handed a callable to pass the arguments to,
+        /// and is only called if \a Level is enabled, so the arguments are only evaluated then,
+        /// or if the flight recorder is on and wants the record anyway.
+        /// Unless \a CompiledIn, which the macros work out from #STDC_LOG_MIN_LEVEL where they
+        /// expand, it is not even instantiated.
+        ///
+        /// \internal
+        template <int Level, bool CompiledIn, class ArgsFunc>
+        inline void logIf(const char *fileName, int lineNumber, const char *functionName,
+                          ArgsFunc &&args) const {
+            if constexpr (CompiledIn || Level >= Logger::Fatal) {
+                if (!isLevelEnabled(Level) && !Logger::isFlightRecording()) {
+                    return;
+                }
+                args([&](auto &&...a) {
+                    log<Level>(fileName, lineNumber, functionName, std::forward<decltype(a)>(a)...);
+                });
+            }
+        }
+
+        // @overload: logIf(), for the printf-style macros
+        template <int Level, bool CompiledIn, class ArgsFunc>
+        inline void logfIf(const char *fileName, int lineNumber, const char *functionName,
+                           ArgsFunc &&args) const {
+            if constexpr (CompiledIn || Level >= Logger::Fatal) {
+                if (!isLevelEnabled(Level) && !Logger::isFlightRecording()) {
+                    return;
+                }
+                args([&](auto &&...a) {
+                    logf<Level>(fileName, lineNumber, functionName, std::forward<decltype(a)>(a)...);
+                });
+            }
+        }
+
+        /// What the rate-limited macros expand to: logIf(), with the \a limiter call site's
+        /// LogLimiter consulted once the level is found enabled. A switched off level still
+        /// reaches the flight recorder, as with logIf(), and without the limiter, which is there
+        /// to spare the sinks rather than the recorder's ring.
+        ///
+        /// \internal
+        template <int Level, bool CompiledIn, class LimiterFunc, class ArgsFunc>
+        inline void logLimitedIf(const char *fileName, int lineNumber, const char *functionName,
+                                 LimiterFunc &&limiter, ArgsFunc &&args) const {
+            static_assert(Level < Logger::Fatal, "a fatal record is never rate limited");
+            if constexpr (CompiledIn) {
+                if (!isLevelEnabled(Level)) {
+                    if (Logger::isFlightRecording()) {
+                        args([&](auto &&...a) {
+                            log<Level>(fileName, lineNumber, functionName,
+                                       std::forward<decltype(a)>(a)...);
+                        });
+                    }
+                    return;
+                }
+                auto admission = limiter().admit();
+                if (!admission) {
+                    return;
+                }
+                if (admission.suppressed == 0 && !admission.last) {
+                    args([&](auto &&...a) {
+                        log<Level>(fileName, lineNumber, functionName,
+                                   std::forward<decltype(a)>(a)...);
+                    });
+                    return;
+                }
+                args([&](const std::string_view &format, const auto &...a) {
+                    Logger(fileName, lineNumber, functionName, _name)
+                        .print(Level, admission.annotate(formatN(format, a...)));
+                });
+            }
+        }
+
+        // @overload: logLimitedIf(), for the printf-style macro
+        template <int Level, bool CompiledIn, class LimiterFunc, class ArgsFunc>
+        inline void logfLimitedIf(const char *fileName, int lineNumber, const char *functionName,
+                                  LimiterFunc &&limiter, ArgsFunc &&args) const {
+            static_assert(Level < Logger::Fatal, "a fatal record is never rate limited");
+            if constexpr (CompiledIn) {
+                if (!isLevelEnabled(Level)) {
+                    if (Logger::isFlightRecording()) {
+                        args([&](auto &&...a) {
+                            logf<Level>(fileName, lineNumber, functionName,
+                                        std::forward<decltype(a)>(a)...);
+                        });
+                    }
+                    return;
+                }
+                auto admission = limiter().admit();
+                if (!admission) {
+                    return;
+                }
+                if (admission.suppressed == 0 && !admission.last) {
+                    args([&](auto &&...a) {
+                        logf<Level>(fileName, lineNumber, functionName,
+                                    std::forward<decltype(a)>(a)...);
+                    });
+                    return;
+                }
+                args([&](const char *fmt, const auto &...a) {
+                    Logger(fileName, lineNumber, functionName, _name)
+                        .print(Level, admission.annotate(asprintf(fmt, a...)));
+                });
+            }
+        }
+
+        /// What stdcLogKV() expands to. \a args is handed a callable taking the message and the
+        /// fields, and like logIf() it is only called if \a Level is enabled, or if the flight
+        /// recorder is on, which keeps the message as it does for an enabled one.
+        ///
+        /// \internal
+        template <int Level, bool CompiledIn, class ArgsFunc>
+        inline void logKVIf(const char *fileName, int lineNumber, const char *functionName,
+                            ArgsFunc &&args) const {
+            if constexpr (CompiledIn || Level >= Logger::Fatal) {
+                if (!isLevelEnabled(Level)) {
+                    if (Logger::isFlightRecording()) {
+                        args([&](const std::string_view &message, std::initializer_list<LogField>) {
+                            Logger(fileName, lineNumber, functionName, _name)
+                                .rememberText(Level, message);
+                        });
+                    }
+                    return;
+                }
+                args([&](const std::string_view &message, std::initializer_list<LogField> fields) {
+                    Logger(fileName, lineNumber, functionName, _name).print(Level, message, fields);
+                });
+                if constexpr (Level == stdc::Logger::Fatal) {
+                    Logger::abort();
+                }
+            }
+        }
+
         inline const LogCategory &stdcGetLogCategory() const {
             return *this;
         }
 
     protected:
         const char *_name;
-
-        union {
-            bool levelEnabled[8];
-            uint64_t enabled;
-        };
+        std::atomic<uint32_t> _levels{0xff};
     };
 
     /// @}
@@ -240,9 +968,9 @@ static inline const stdc::LogCategory &stdcGetLogCategory() {
 /// message uses formatN() placeholders (\c %1, \c %2, ...), and the \c F variants below take
 /// printf conversions instead.
 ///
-/// \warning This expands to an ordinary call, so the arguments are evaluated whether the level
-///          is enabled or not. Unlike Qt's \c qCDebug, which short circuits, anything expensive
-///          belongs behind an isLevelEnabled() check of your own.
+/// Like Qt's \c qCDebug it short circuits: the arguments are only evaluated once the level has
+/// been found enabled, so an expensive one costs nothing while its level is off. Below
+/// #STDC_LOG_MIN_LEVEL the call is compiled out altogether.
 ///
 /// \code
 ///   stdc::LogCategory lc("app.io");
@@ -251,8 +979,15 @@ static inline const stdc::LogCategory &stdcGetLogCategory() {
 ///
 ///   stdcWarning("something to say about nothing in particular");
 /// \endcode
+///
+/// \note The arguments travel inside a lambda capturing by reference, which is what lets the
+///       macro keep the <tt>lc.</tt> prefix working. That lambda is why these cannot be used
+///       outside a function body, in a namespace-scope initializer say.
 #define stdcLog(LEVEL, ...)                                                                        \
-    stdcGetLogCategory().log<stdc::Logger::LEVEL>(__FILE__, __LINE__, __FUNCTION__, __VA_ARGS__)
+    stdcGetLogCategory().logIf<stdc::Logger::LEVEL,                                                \
+        (stdc::Logger::LEVEL >= STDC_LOG_MIN_LEVEL)>(                                              \
+        __FILE__, __LINE__, __FUNCTION__,                                                          \
+        [&](auto &&stdcLogEmit) { stdcLogEmit(__VA_ARGS__); })
 #define stdcTrace(...)    stdcLog(Trace, __VA_ARGS__)
 #define stdcDebug(...)    stdcLog(Debug, __VA_ARGS__)
 #define stdcSuccess(...)  stdcLog(Success, __VA_ARGS__)
@@ -262,7 +997,10 @@ static inline const stdc::LogCategory &stdcGetLogCategory() {
 #define stdcFatal(...)    stdcLog(Fatal, __VA_ARGS__)
 
 #define stdcLogF(LEVEL, ...)                                                                       \
-    stdcGetLogCategory().logf<stdc::Logger::LEVEL>(__FILE__, __LINE__, __FUNCTION__, __VA_ARGS__)
+    stdcGetLogCategory().logfIf<stdc::Logger::LEVEL,                                               \
+        (stdc::Logger::LEVEL >= STDC_LOG_MIN_LEVEL)>(                                              \
+        __FILE__, __LINE__, __FUNCTION__,                                                          \
+        [&](auto &&stdcLogEmit) { stdcLogEmit(__VA_ARGS__); })
 #define stdcTraceF(...)    stdcLogF(Trace, __VA_ARGS__)
 #define stdcDebugF(...)    stdcLogF(Debug, __VA_ARGS__)
 #define stdcSuccessF(...)  stdcLogF(Success, __VA_ARGS__)
@@ -271,4 +1009,77 @@ static inline const stdc::LogCategory &stdcGetLogCategory() {
 #define stdcCriticalF(...) stdcLogF(Critical, __VA_ARGS__)
 #define stdcFatalF(...)    stdcLogF(Fatal, __VA_ARGS__)
 
+/// stdcLog(), with typed key/value fields in place of formatting: \a MESSAGE is taken as it is,
+/// and each argument after it is a <tt>{key, value}</tt> pair, the value a bool, a number or a
+/// string.
+///
+/// A sink is handed the fields apart from the message, so one that writes for a machine, a
+/// StructuredLogSink say, keeps them typed and nothing downstream has to parse the text. The
+/// callback, which only takes text, sees them appended to the message as
+/// <tt>key=value</tt> pairs.
+///
+/// \code
+///   lc.stdcLogKV(Warning, "request failed", {"status", status}, {"peer", peer.name()});
+///   lc.stdcInfoKV("request done", {"bytes", n}, {"ms", elapsed});
+/// \endcode
+///
+/// \note The fields are built and handed over in one expression, so a temporary such as the
+///       string \c peer.name() returns lives until every sink has seen it.
+#define stdcLogKV(LEVEL, MESSAGE, ...)                                                             \
+    stdcGetLogCategory().logKVIf<stdc::Logger::LEVEL,                                              \
+        (stdc::Logger::LEVEL >= STDC_LOG_MIN_LEVEL)>(                                              \
+        __FILE__, __LINE__, __FUNCTION__,                                                          \
+        [&](auto &&stdcLogEmit) { stdcLogEmit(MESSAGE, {__VA_ARGS__}); })
+#define stdcTraceKV(...)    stdcLogKV(Trace, __VA_ARGS__)
+#define stdcDebugKV(...)    stdcLogKV(Debug, __VA_ARGS__)
+#define stdcSuccessKV(...)  stdcLogKV(Success, __VA_ARGS__)
+#define stdcInfoKV(...)     stdcLogKV(Information, __VA_ARGS__)
+#define stdcWarningKV(...)  stdcLogKV(Warning, __VA_ARGS__)
+#define stdcCriticalKV(...) stdcLogKV(Critical, __VA_ARGS__)
+#define stdcFatalKV(...)    stdcLogKV(Fatal, __VA_ARGS__)
+
+/// stdcLog(), for a call site that may fire far more often than anybody wants to read: \a KIND
+/// is one of the LogLimiter kinds and \a N its count. A misbehaving peer can make a warning in a
+/// request loop fire a million times a minute, and this keeps it to what \a N allows, with a
+/// note on the next record of how many were held back in between.
+///
+/// Each call site keeps its own count, in a static that is constant initialized, so the limiter
+/// is a couple of relaxed atomic operations and nothing more. A disabled level is looked at
+/// first and does not count.
+///
+/// \code
+///   lc.stdcLogEveryN(Warning, 1000, "retrying %1", peer);    // the 1st, 1001st, ...
+///   lc.stdcLogFirstN(Information, 5, "using fallback %1", name);
+///   lc.stdcLogPerSecond(Warning, 10, "bad frame from %1", peer);
+/// \endcode
+///
+/// \note \a N is read where the static is initialized, so it has to be a constant, and the
+///       limit is shared by every thread that passes through the call site. \c Fatal cannot be
+///       limited, since what follows it is an abort.
+#define stdcLogLimited(LEVEL, KIND, N, ...)                                                        \
+    stdcGetLogCategory().logLimitedIf<stdc::Logger::LEVEL,                                         \
+        (stdc::Logger::LEVEL >= STDC_LOG_MIN_LEVEL)>(                                              \
+        __FILE__, __LINE__, __FUNCTION__,                                                          \
+        []() -> stdc::LogLimiter & {                                                               \
+            static stdc::LogLimiter stdcLogLimiter(stdc::LogLimiter::KIND, N);                     \
+            return stdcLogLimiter;                                                                 \
+        },                                                                                         \
+        [&](auto &&stdcLogEmit) { stdcLogEmit(__VA_ARGS__); })
+#define stdcLogEveryN(LEVEL, N, ...)    stdcLogLimited(LEVEL, EveryN, N, __VA_ARGS__)
+#define stdcLogFirstN(LEVEL, N, ...)    stdcLogLimited(LEVEL, FirstN, N, __VA_ARGS__)
+#define stdcLogPerSecond(LEVEL, N, ...) stdcLogLimited(LEVEL, PerSecond, N, __VA_ARGS__)
+
+#define stdcLogLimitedF(LEVEL, KIND, N, ...)                                                       \
+    stdcGetLogCategory().logfLimitedIf<stdc::Logger::LEVEL,                                        \
+        (stdc::Logger::LEVEL >= STDC_LOG_MIN_LEVEL)>(                                              \
+        __FILE__, __LINE__, __FUNCTION__,                                                          \
+        []() -> stdc::LogLimiter & {                                                               \
+            static stdc::LogLimiter stdcLogLimiter(stdc::LogLimiter::KIND, N);                     \
+            return stdcLogLimiter;                                                                 \
+        },                                                                                         \
+        [&](auto &&stdcLogEmit) { stdcLogEmit(__VA_ARGS__); })
+#define stdcLogEveryNF(LEVEL, N, ...)    stdcLogLimitedF(LEVEL, EveryN, N, __VA_ARGS__)
+#define stdcLogFirstNF(LEVEL, N, ...)    stdcLogLimitedF(LEVEL, FirstN, N, __VA_ARGS__)
+#define stdcLogPerSecondF(LEVEL, N, ...) stdcLogLimitedF(LEVEL, PerSecond, N, __VA_ARGS__)
+
 #endif // STDCORELIB_LOGGING_H
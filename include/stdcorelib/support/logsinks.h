@@ -0,0 +1,157 @@
+// SPDX-License-Identifier: MIT
+
+#ifndef STDCORELIB_LOGSINKS_H
+#define STDCORELIB_LOGSINKS_H
+
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <system_error>
+
+#include <stdcorelib/support/json.h>
+#include <stdcorelib/support/logging.h>
+
+namespace stdc {
+
+    /// \addtogroup logging
+    /// @{
+
+    /// Writes records to a file, through a buffer of its own, and rotates it.
+    ///
+    /// Records are formatted into a userspace buffer, which goes to the file in one \c write(2)
+    /// when it fills or when it has held something for the flush interval, whichever comes
+    /// first. Under load that is one system call for as many records as fit in the buffer,
+    /// rather than one for each.
+    ///
+    /// The file can be rotated by size, by wall-clock period, or both. A rotated segment is
+    /// renamed beside the live file with the UTC time of the rotation in its name, so
+    /// <tt>app.log</tt> becomes <tt>app.20261018-153000.log</tt>. What happens to it after that,
+    /// the archive callback and the pruning of old segments, runs on a background thread, as
+    /// does the \c fsync when one is asked for, so none of it holds up the thread that logs.
+    ///
+    /// \code
+    ///   stdc::FileLogSink::Options options;
+    ///   options.path = "logs/app.log";
+    ///   options.maxFileSize = 64 << 20;
+    ///   options.maxFiles = 10;
+    ///
+    ///   auto sink = std::make_shared<stdc::FileLogSink>(options);
+    ///   if (!sink->isOpen()) {
+    ///       return sink->error();
+    ///   }
+    ///   stdc::Logger::addSink(sink);
+    /// \endcode
+    ///
+    /// \note Thread safe. Records may come in from any number of threads, and each one is
+    ///       written whole.
+    class STDC_EXPORT FileLogSink : public LogSink {
+    public:
+        struct Options {
+            /// The live file, created if missing and appended to if not. Its directory has to
+            /// exist already.
+            std::filesystem::path path;
+
+            /// How much is buffered before it is written out.
+            size_t bufferSize = 256 * 1024;
+
+            /// The longest a record waits in the buffer, or zero to wait for it to fill.
+            std::chrono::milliseconds flushInterval{1000};
+
+            /// Rotate once the file would grow past this many bytes, or zero for never. A file
+            /// is never rotated empty, so one flush larger than this still goes out whole.
+            uint64_t maxFileSize = 0;
+
+            /// Rotate at every multiple of this since the epoch, in UTC, or zero for never. A
+            /// day rotates at midnight UTC, an hour on the hour.
+            std::chrono::seconds rotateInterval{0};
+
+            /// How many rotated segments to keep, oldest deleted first, or zero to keep them
+            /// all. Anything in the directory named like a segment counts, which includes what
+            /// the archive callback made of one.
+            int maxFiles = 0;
+
+            /// Called on the background thread with each segment once it is rotated out, to
+            /// compress it, say. It may replace the file with another of the same stem.
+            std::function<void(const std::filesystem::path &segment)> archive;
+
+            /// \c fsync the file after each flush. The call is made on the background thread,
+            /// so flushes do not wait for it, and a crash can still lose what was written in the
+            /// last moments before it.
+            bool syncOnFlush = false;
+        };
+
+        explicit FileLogSink(Options options);
+        ~FileLogSink();
+
+        /// Whether the file is open. A sink that failed to open drops what it is given.
+        bool isOpen() const;
+
+        /// The reason the last open, write or rotation failed, or empty if none has.
+        std::error_code error() const;
+
+        const Options &options() const;
+
+        void write(const LogRecord &record) override;
+        void writeBatch(const array_view<LogRecord> &records) override;
+
+        /// Writes out whatever is buffered, at once.
+        void flush() override;
+
+        /// Rotates now, whatever the size and the time, and returns whether it could.
+        bool rotate();
+
+    protected:
+        /// Appends one record to \a out, with its newline. The default writes the time in UTC,
+        /// the level, the category, the message and the fields as <tt>key=value</tt> pairs, and
+        /// a subclass overrides this for a format of its own.
+        virtual void formatRecord(std::string &out, const LogRecord &record);
+
+    private:
+        class Impl;
+        std::unique_ptr<Impl> _impl;
+    };
+
+    /// A FileLogSink that writes for a machine rather than a person: each record as one JSON
+    /// object a line, or as one CBOR item after another, a CBOR sequence as RFC 8742 has it.
+    ///
+    /// Both go through JsonValue's encoder, and the fields a record carries keep their types, so
+    /// whatever reads the log back needs no parsing of text. CBOR comes out several times smaller
+    /// than the text the default format writes for the same records.
+    ///
+    /// Each record is an object with the level's name, the message, the category, file, line and
+    /// function when there are any, the time in nanoseconds since the epoch and the thread id
+    /// once the record has been stamped with them, and the fields as an object of their own:
+    ///
+    /// \code
+    ///   {"category":"app.net","fields":{"ms":12.5,"status":503},"level":"warning",
+    ///    "message":"request failed"}
+    /// \endcode
+    class STDC_EXPORT StructuredLogSink : public FileLogSink {
+    public:
+        enum Encoding {
+            JsonLines,
+            Cbor,
+        };
+
+        explicit StructuredLogSink(Options options, Encoding encoding = JsonLines);
+        ~StructuredLogSink();
+
+        inline Encoding encoding() const {
+            return _encoding;
+        }
+
+        /// The object \a record is written as.
+        static JsonValue toJsonValue(const LogRecord &record);
+
+    protected:
+        void formatRecord(std::string &out, const LogRecord &record) override;
+
+        Encoding _encoding;
+    };
+
+    /// @}
+
+}
+
+#endif // STDCORELIB_LOGSINKS_H
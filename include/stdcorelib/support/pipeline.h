@@ -0,0 +1,129 @@
+// SPDX-License-Identifier: MIT
+
+#ifndef STDCORELIB_PIPELINE_H
+#define STDCORELIB_PIPELINE_H
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <stdcorelib/support/popen.h>
+
+namespace stdc {
+
+    /// \addtogroup process
+    /// @{
+
+    /// Runs \c producer \c | \c filter \c | \c consumer without a shell, each stage's stdout
+    /// connected straight to the next one's stdin.
+    ///
+    /// The pipes between stages are made here and handed to the children, and this process keeps
+    /// no end of them once they have started, so what one stage writes goes to the next without
+    /// passing through here. Reading each stage's output and writing it to the next would copy
+    /// every byte twice and hold the slower of the two back on this process.
+    ///
+    /// \code
+    ///   stdc::Popen producer, filter, consumer;
+    ///   producer.args({"git", "log", "--format=%an"});
+    ///   filter.args({"sort"}).stderr_(stdc::Popen::PIPE);
+    ///   consumer.args({"uniq", "-c"}).stdout_(stdc::Popen::PIPE);
+    ///
+    ///   stdc::Pipeline pipeline;
+    ///   pipeline.add(std::move(producer)).add(std::move(filter)).add(std::move(consumer));
+    ///   if (!pipeline.start(&err)) {
+    ///       return err;
+    ///   }
+    ///   auto [out, errs] = pipeline.communicate();
+    ///   auto status = pipeline.returncodes(); // as PIPESTATUS has it
+    /// \endcode
+    ///
+    /// Each stage is an ordinary Popen and keeps everything it was set up with, except the two
+    /// ends the pipeline takes over: the stdout of every stage but the last, and the stdin of
+    /// every stage but the first. The first stage's stdin and the last one's stdout are the
+    /// caller's to set, as for a single Popen. stderr stays with each stage: \c Popen::STDOUT
+    /// sends it down the pipe along with its stdout, which is \c 2>&1 in a shell, and \c PIPE
+    /// captures it for communicate().
+    class STDC_EXPORT Pipeline {
+    public:
+        /// What communicate() collects.
+        struct Output {
+            /// The last stage's stdout, empty if it was not a \c PIPE.
+            std::string out;
+
+            /// Every stage's stderr, in the order of the stages, each empty if it was not a
+            /// \c PIPE.
+            std::vector<std::string> err;
+        };
+
+        Pipeline();
+        ~Pipeline();
+
+        Pipeline(Pipeline &&RHS) noexcept;
+        Pipeline &operator=(Pipeline &&RHS) noexcept;
+
+        /// Appends a stage, set up and not started.
+        Pipeline &add(Popen stage);
+
+        /// The capacity of the pipes between stages, in bytes, as Popen::pipesize() has it.
+        Pipeline &pipesize(int pipesize); // linux only (ignored on other platforms)
+
+        /// Makes the pipes and starts every stage, first to last.
+        ///
+        /// \param err_msg filled in with a readable description when this fails, if not null,
+        ///        which says which stage it was
+        /// \retval true every stage is running
+        /// \retval false nothing is left running: the stages already started were killed and
+        ///         waited for, with the reason in error_code()
+        bool start(std::string *err_msg = nullptr);
+
+        /// The error from the last operation, cleared at the start of each one.
+        std::error_code error_code() const;
+
+        /// Writes \a input to the first stage, reads the last stage's stdout and every stderr
+        /// that is a \c PIPE to the end, and waits for every stage.
+        ///
+        /// \param timeout how long to allow for the whole of it, in milliseconds, or negative
+        ///        for no limit. A stage still running at the end of it is killed, and
+        ///        error_code() then reports a timeout.
+        Output communicate(const std::string &input = {}, int timeout = -1);
+
+        /// Waits for every stage to exit.
+        ///
+        /// \param timeout how long to wait for all of them together, in milliseconds, or
+        ///        negative to wait forever
+        /// \retval false the timeout ran out, or a wait failed
+        bool wait(int timeout = -1);
+
+        /// Kills every stage still running.
+        bool kill();
+
+        size_t size() const;
+
+        /// A stage, in the order added, for its pid and its streams.
+        ///
+        /// \warning A reference into the pipeline, so it does not outlive it.
+        Popen &stage(size_t index) const;
+
+        /// The exit status of every stage, in order, each as Popen::returncode() gives it, like
+        /// \c PIPESTATUS in bash.
+        std::vector<std::optional<int>> returncodes() const;
+
+        /// The exit status of the last stage, which is what a shell reports for the whole
+        /// pipeline.
+        ///
+        /// \note A stage failing earlier on does not show here, as it does not in a shell
+        ///       without \c pipefail. returncodes() is what says which stage it was.
+        std::optional<int> returncode() const;
+
+    protected:
+        class Impl;
+        std::unique_ptr<Impl> _impl;
+    };
+
+    /// @}
+
+}
+
+#endif // STDCORELIB_PIPELINE_H
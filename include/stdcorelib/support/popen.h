@@ -3,6 +3,7 @@
 #ifndef STDCORELIB_POPEN_H
 #define STDCORELIB_POPEN_H
 
+#include <chrono>
 #include <filesystem>
 #include <vector>
 #include <istream>
@@ -11,6 +12,7 @@
 #include <optional>
 #include <system_error>
 #include <functional>
+#include <string_view>
 
 #include <stdcorelib/stdc_global.h>
 #include <stdcorelib/adt/array_view.h>
@@ -132,6 +134,66 @@ namespace stdc {
             } data;
         };
 
+        /// What a child used over its whole life, as the kernel accounted for it when the child
+        /// was reaped.
+        ///
+        /// \note Children of the child count once they have been waited for, as they do in
+        ///       \c RUSAGE_CHILDREN. Windows counts the process alone.
+        struct ResourceUsage {
+            /// CPU time spent in its own code, and in the kernel on its behalf.
+            std::chrono::microseconds user_time{0};
+            std::chrono::microseconds system_time{0};
+
+            /// The most memory it had resident at once, in bytes. The peak working set on
+            /// Windows.
+            long long max_rss = 0;
+
+            /// Times it gave up the CPU to wait for something, and times it was made to give it
+            /// up. Windows does not count these, and leaves them 0.
+            long long voluntary_switches = 0;
+            long long involuntary_switches = 0;
+        };
+
+        /// Where communicate() sends one of the child's output streams as it arrives, rather than
+        /// keeping all of it in a string. Built the way IODev is, from what it is given.
+        ///
+        /// - nothing: read and dropped, so the child is never held up by a full pipe
+        /// - a callback: given each piece as it is read, in order
+        /// - a buffer and a callback: read straight into the buffer, which the callback is
+        ///   given each time it fills and once more with what is left at the end. The same
+        ///   buffer is then filled again from the start, so nothing but it is allocated for
+        ///   the stream, however much the child writes.
+        /// - a descriptor: written to it. On Linux that is \c splice(2), which moves the data
+        ///   from the pipe to the descriptor inside the kernel and never copies it out here.
+        ///   Anywhere else, or for a descriptor \c splice refuses, it is read and written.
+        ///
+        /// \note The descriptor is the caller's, and is neither closed nor made non-blocking.
+        /// \note A callback is never called for both streams at once. On Windows, where each
+        ///       stream has a thread of its own, it is called on those threads.
+        struct Sink {
+            enum Kind {
+                Discard,
+                Callback,
+                Buffer,
+                FD,
+            };
+            Sink() : kind(Discard) {
+            }
+            Sink(std::function<void(std::string_view)> on_data)
+                : kind(Callback), on_data(std::move(on_data)) {
+            }
+            Sink(char *data, size_t size, std::function<void(std::string_view)> on_full)
+                : kind(Buffer), on_data(std::move(on_full)), data(data), size(size) {
+            }
+            Sink(int fd) : kind(FD), fd(fd) {
+            }
+            int kind;
+            std::function<void(std::string_view)> on_data;
+            char *data = nullptr;
+            size_t size = 0;
+            int fd = -1;
+        };
+
 #ifdef _WIN32
         struct StartupInfo {
             // winapi members
@@ -168,15 +230,25 @@ namespace stdc {
 
             bool is_open() const;
 
-            /// The same pipe as a \c FILE *, for the C interfaces that take nothing else.
+            /// The same pipe as a \c FILE *, for the C interfaces that take nothing else. Made
+            /// on the first call, after writing out what this stream still holds.
             ///
             /// \warning Owned by the Stream. Do not \c fclose it, and do not keep it past
             ///          close(), which leaves it dangling.
             FILE *file() const;
 
+            /// The descriptor this stream reads or writes, or -1 when it is not open. It is
+            /// what an event loop of the caller's waits on.
+            ///
+            /// \warning Read from or write to one of this stream, file() and the descriptor,
+            ///          not several. The first two buffer what passes through them, and the
+            ///          others do not see what they hold.
+            /// \note Owned by the Stream, and gone at close().
+            int fd() const;
+
         private:
             friend class Popen;
-            void open(FILE *file);
+            void open(int fd, bool writable, bool text, size_t bufsize);
 
             class Buf;
             std::unique_ptr<Buf> _buf;
@@ -315,6 +387,14 @@ namespace stdc {
         /// and caps it at \c /proc/sys/fs/pipe-max-size for an unprivileged caller.
         Popen &pipesize(int pipesize); // linux only (ignored on other platforms)
 
+        /// The buffer behind each stream of stdin_(), stdout_() and stderr_(), in bytes, or 0
+        /// for none, so that every write goes straight to the pipe. Negative, the default,
+        /// means 64 KiB.
+        ///
+        /// \note A read or write at least this large skips the buffer and goes to the pipe in
+        ///       one call.
+        Popen &bufsize(int bufsize);
+
 #ifdef _WIN32
         /// The \c STARTUPINFO fields to start the child with, and the attributes to give it.
         ///
@@ -332,6 +412,10 @@ namespace stdc {
         /// \warning The child has one thread, the one that called \c fork. Any lock another
         ///          thread held at that moment is still held and will never be released, so
         ///          allocating or locking here can deadlock the child outright.
+        /// \note On Linux a child is started with \c vfork() where that is safe, which saves
+        ///       copying the page tables of a large parent. Setting this is one of the things
+        ///       that rules it out, along with user(), group() and extra_groups(), so a real
+        ///       \c fork() is what it runs after.
         Popen &preexec_fn(std::function<void()> preexec_fn); // unix only
 
         /// Puts the signal dispositions this process changed back to their defaults, so the
@@ -362,6 +446,23 @@ namespace stdc {
 
         /// The process group to join, or 0 to start one of its own. -1 inherits ours.
         Popen &process_group(int process_group); // unix only
+
+        /// A \c setrlimit() limit for the child, put in place before exec. Each call adds one,
+        /// and a later one for the same resource wins.
+        ///
+        /// \code
+        ///   p.rlimit(RLIMIT_CPU, 60)             // seconds of CPU, then SIGXCPU
+        ///       .rlimit(RLIMIT_AS, 2LL << 30)    // bytes of address space
+        ///       .rlimit(RLIMIT_NOFILE, 256, 256) // descriptors, ceiling included
+        /// \endcode
+        ///
+        /// \param resource one of the \c RLIMIT_ constants from \c <sys/resource.h>
+        /// \param soft the limit, or negative for none
+        /// \param hard the ceiling, negative for none, or nothing to keep the one inherited.
+        ///        An unprivileged child can lower it but not raise it, and start() then fails
+        ///        with \c EPERM.
+        Popen &rlimit(int resource, long long soft,
+                      std::optional<long long> hard = std::nullopt); // unix only
 #endif
 
         /// @}
@@ -377,6 +478,8 @@ namespace stdc {
         /// \retval false nothing was started, with the reason in error_code()
         /// \note One Popen runs one child. Calling this again after a child has been started is
         ///       not supported. Use another Popen.
+        /// \note On unix, while a ForkServer is running, it is what forks the child unless
+        ///       preexec_fn() or detached() is set. Nothing else about the child changes.
         bool start(std::string *err_msg = nullptr);
 
         /// The error from the last operation, cleared at the start of each one.
@@ -400,6 +503,10 @@ namespace stdc {
         /// \param timeout how long to wait, in milliseconds, or negative to wait forever
         /// \retval false the timeout ran out, or the wait failed
         /// \note The pipes stay readable afterwards, so output can still be collected.
+        /// \note With a timeout, Linux waits on a pidfd for the child and returns as soon as it
+        ///       exits. Where there is no pidfd, the first such wait installs a \c SIGCHLD
+        ///       handler that passes the signal on to whatever handler was there before. None
+        ///       is installed if \c SIGCHLD is ignored, and the wait then polls as it always did.
         bool wait(int timeout = -1);
 
         /// Writes \a input to the child, reads stdout and stderr to the end, and waits.
@@ -418,6 +525,24 @@ namespace stdc {
         std::tuple<std::string, std::string> communicate(const std::string &input = {},
                                                          int timeout = -1);
 
+        /// The same, with the output handed on as it arrives rather than kept, for a child that
+        /// says more than is worth holding in memory.
+        ///
+        /// \code
+        ///   // a gigabyte dump to a file, without ever passing through this process
+        ///   int file = ::open("dump.sql", O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        ///   proc.communicate({}, file, Popen::Sink(), 600000);
+        /// \endcode
+        ///
+        /// \param out where stdout goes, if it is a \c PIPE
+        /// \param err where stderr goes, if it is a \c PIPE
+        /// \retval true the child ran to the end and returncode() holds its status
+        /// \retval false it was killed at \a timeout, or writing to a sink failed, with the
+        ///         reason in error_code(). A sink that fails is dropped for the rest of the
+        ///         stream, which is still read so that the child can finish.
+        /// \note The reads are as large as the pipe, which pipesize() decides on Linux.
+        bool communicate(const std::string &input, Sink out, Sink err, int timeout = -1);
+
         /// Sends \a sig to the child. On Windows only \c WS_CTRL_C_EVENT and
         /// \c WS_CTRL_BREAK_EVENT are accepted.
         bool send_signal(int sig);
@@ -459,6 +584,20 @@ namespace stdc {
 
         int pid() const;
 
+#ifndef _WIN32
+        /// A descriptor that becomes readable once the child has exited, for an event loop to
+        /// wait on alongside the pipes. wait() or poll() is still what collects the status.
+        ///
+        /// It is a pidfd, so this is -1 anywhere other than Linux 5.3 and later, and for a
+        /// child that was never started or was detached. A loop without it learns of the exit
+        /// from \c SIGCHLD, or by calling poll() now and then. A child the ForkServer started
+        /// always has one, on every platform: the pipe the server reports its exit on.
+        ///
+        /// \note Owned by the Popen and open for as long as it is. Do not close it.
+        /// \sa ProcessReactor, which does all of this for many children at once
+        int exit_fd() const; // unix only
+#endif
+
         bool detached() const;
 
         /// The exit status, or nothing while the child is still running.
@@ -467,11 +606,20 @@ namespace stdc {
         ///       a \c SIGKILL comes back as -9.
         std::optional<int> returncode() const;
 
+        /// What the child used, collected when it was reaped, or nothing while it is still
+        /// running.
+        ///
+        /// \note Also nothing on unix when this process ignores \c SIGCHLD, which leaves the
+        ///       kernel nothing to report, and returncode() a 0 it made up.
+        std::optional<ResourceUsage> resource_usage() const;
+
         /// @}
 
     protected:
         class Impl;
         std::unique_ptr<Impl> _impl;
+
+        friend class ForkServer;
     };
 
     /// @}
@@ -0,0 +1,119 @@
+// SPDX-License-Identifier: MIT
+
+#ifndef STDCORELIB_PROCESSPOOL_H
+#define STDCORELIB_PROCESSPOOL_H
+
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <stdcorelib/support/popen.h>
+
+namespace stdc {
+
+    /// \addtogroup process
+    /// @{
+
+    /// Runs a queue of commands, so many at a time, and collects what each of them said.
+    ///
+    /// What \c xargs \c -P and GNU \c parallel do, without a thread per child. On POSIX the
+    /// calling thread drives every child through a ProcessReactor: on Linux a single \c epoll set
+    /// of their pipes, the input still to be written to them, and a pidfd for each that says when
+    /// it has exited, and \c poll and a \c SIGCHLD handler elsewhere. On Windows, where an
+    /// anonymous pipe cannot be waited on, there is a thread for each child that is running, and
+    /// no more.
+    ///
+    /// \code
+    ///   stdc::ProcessPool pool(8);
+    ///   for (const auto &file : files) {
+    ///       stdc::Popen p;
+    ///       p.args({"clang-format", "--dry-run", file}).stderr_(stdc::Popen::PIPE);
+    ///       pool.submit(std::move(p), {}, 30000);
+    ///   }
+    ///   for (const auto &result : pool.run()) {
+    ///       if (result.returncode != 0) {
+    ///           report(files[result.index], result.err);
+    ///       }
+    ///   }
+    /// \endcode
+    ///
+    /// \note Each job's streams are what its Popen was set up with. Only those set to \c PIPE
+    ///       are read, and only a \c PIPE stdin is given the input.
+    class STDC_EXPORT ProcessPool {
+    public:
+        /// What became of one job.
+        struct Result {
+            /// Where it was in the order of submit().
+            size_t index = 0;
+
+            int pid = -1;
+
+            /// The exit status, as Popen::returncode() gives it, or nothing if the job never
+            /// started.
+            std::optional<int> returncode;
+
+            /// What it used, as Popen::resource_usage() gives it, for finding the jobs that cost
+            /// the most and sizing the pool to the machine.
+            std::optional<Popen::ResourceUsage> usage;
+
+            std::string out;
+            std::string err;
+
+            /// Why it failed to start or to finish, or empty if it did neither. A job that ran
+            /// past its timeout was killed and reports \c std::errc::timed_out.
+            std::error_code error;
+
+            /// A readable description to go with \a error, where start() gave one.
+            std::string error_msg;
+        };
+
+        enum Order {
+            Submitted, ///< in the order of submit()
+            Completed, ///< in the order the jobs finished
+        };
+
+        /// \param max_running the most children to run at once, or 0 for as many as there are
+        ///        hardware threads
+        explicit ProcessPool(int max_running = 0);
+        ~ProcessPool();
+
+        int max_running() const;
+
+        /// Queues a job for the next run().
+        ///
+        /// \param popen set up and not started
+        /// \param input written to its stdin, which is then closed
+        /// \param timeout how long it may run, in milliseconds from its start, or negative for
+        ///        no limit
+        /// \return its index in the results
+        size_t submit(Popen popen, std::string input = {}, int timeout = -1);
+
+        /// Runs every job queued and returns once all of them have finished. The queue is empty
+        /// afterwards.
+        std::vector<Result> run(Order order = Submitted);
+
+        /// Runs every job queued and hands each result to \a on_result as its job finishes, on
+        /// the thread that called this. Nothing is kept, which suits a queue whose output would
+        /// not fit in memory all at once.
+        void run(const std::function<void(Result &&)> &on_result);
+
+    protected:
+        class Impl;
+        std::unique_ptr<Impl> _impl;
+
+        STDC_DISABLE_COPY_MOVE(ProcessPool)
+    };
+
+    /// Runs \a jobs at most \a max_running at a time and returns their results in the order
+    /// given. \a timeout applies to each job on its own.
+    STDC_EXPORT std::vector<ProcessPool::Result> run_many(std::vector<Popen> jobs,
+                                                          int max_running = 0, int timeout = -1);
+
+    /// @}
+
+}
+
+#endif // STDCORELIB_PROCESSPOOL_H
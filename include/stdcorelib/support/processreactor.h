@@ -0,0 +1,134 @@
+// SPDX-License-Identifier: MIT
+
+#ifndef STDCORELIB_PROCESSREACTOR_H
+#define STDCORELIB_PROCESSREACTOR_H
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+#include <stdcorelib/support/popen.h>
+
+#ifndef _WIN32
+
+namespace stdc {
+
+    /// \addtogroup process
+    /// @{
+
+    /// Supervises any number of running children from one thread, and says what each of them
+    /// writes as it writes it and when it is done.
+    ///
+    /// communicate() blocks on one child and keeps everything it says until it exits. This takes
+    /// children that are already started, reads their pipes as they fill, and hands each piece
+    /// over as it arrives. It is driven one of two ways:
+    ///
+    ///   - by itself, with run() or a loop around process_events();
+    ///   - by an event loop of the caller's, which waits on fd() along with its own descriptors,
+    ///     and calls process_events() with a timeout of 0 when fd() is readable or when
+    ///     next_timeout() has run out.
+    ///
+    /// \code
+    ///   stdc::ProcessReactor reactor;
+    ///   for (auto &proc : started) {
+    ///       stdc::ProcessReactor::Handlers handlers;
+    ///       handlers.on_stdout_chunk = [](std::string_view chunk) { log.write(chunk); };
+    ///       handlers.on_exit = [](stdc::Popen &p, std::error_code) { report(p.returncode()); };
+    ///       reactor.add(std::move(proc), std::move(handlers));
+    ///   }
+    ///   reactor.run();
+    /// \endcode
+    ///
+    /// On Linux the descriptors go into one \c epoll set, and that set is fd(). Each child's exit
+    /// is its pidfd, see Popen::exit_fd(). Elsewhere there is \c poll, a \c SIGCHLD handler for
+    /// the exits, and no fd() to give out, so the caller's loop has to come back by
+    /// next_timeout().
+    ///
+    /// \note Unix only. A Windows anonymous pipe cannot be waited on, which is why communicate()
+    ///       and ProcessPool use a thread for each child there.
+    /// \note Not thread safe. Every call, and every handler, is on the thread that drives it.
+    class STDC_EXPORT ProcessReactor {
+    public:
+        /// What to tell the caller about one child. Any of them may be left empty.
+        struct Handlers {
+            /// Each piece of stdout as it is read, in order. What a piece holds follows the
+            /// pipe rather than the lines of the output, so a line may be split across two.
+            std::function<void(std::string_view chunk)> on_stdout_chunk;
+
+            /// The same, for stderr.
+            std::function<void(std::string_view chunk)> on_stderr_chunk;
+
+            /// Once the child has exited and both pipes are read to the end, after the last
+            /// chunk. The Popen goes once this returns.
+            ///
+            /// \param error empty if it ran to the end, \c std::errc::timed_out if it was killed
+            ///        for running past its timeout, or what went wrong while waiting on it
+            std::function<void(Popen &popen, std::error_code error)> on_exit;
+        };
+
+        ProcessReactor();
+
+        /// Kills the children still here, as destroying their Popen would, without telling
+        /// their handlers.
+        ~ProcessReactor();
+
+        /// Takes over a child, which from here on belongs to the reactor.
+        ///
+        /// A pipe that was not set to \c PIPE is not read, and its handler is not called. The
+        /// output of one that was is read whether there is a handler for it or not, since a
+        /// child whose pipe nobody drains stops once it fills.
+        ///
+        /// \param popen started, and not detached
+        /// \param input written to its stdin, which is then closed. A \c PIPE stdin with no
+        ///        input is closed at once, so a child reading to end of input can finish
+        /// \param timeout how long it may run from now, in milliseconds, or negative for no limit
+        /// \retval true the reactor has it
+        /// \retval false it has no child to watch, or its descriptors could not be added, with
+        ///         the reason in \c errno. Nothing was taken, and \a popen is as it was
+        bool add(Popen &&popen, Handlers handlers, std::string input = {}, int timeout = -1);
+
+        /// How many children are still here, which is those whose on_exit has not been called.
+        size_t size() const;
+
+        bool empty() const {
+            return size() == 0;
+        }
+
+        /// A descriptor that is readable whenever process_events() has something to do, for an
+        /// event loop of the caller's to wait on. -1 where there is no such thing, which is
+        /// anywhere other than Linux.
+        int fd() const;
+
+        /// The longest the caller may wait before calling process_events(), in milliseconds, or
+        /// -1 for as long as it likes. A child's timeout shortens it, and so does a child whose
+        /// exit nothing announces and has to be polled for.
+        int next_timeout() const;
+
+        /// Reads what is ready, writes what input there is room for, and reports each child that
+        /// has finished, kills those out of time, calling the handlers as it goes.
+        ///
+        /// \param timeout how long to wait for something to happen, in milliseconds, or
+        ///        negative for as long as it takes. Never longer than next_timeout(), and 0
+        ///        does not wait at all.
+        /// \return how many children are still here
+        size_t process_events(int timeout = -1);
+
+        /// Calls process_events() until every child is done.
+        void run();
+
+    protected:
+        class Impl;
+        std::unique_ptr<Impl> _impl;
+
+        STDC_DISABLE_COPY_MOVE(ProcessReactor)
+    };
+
+    /// @}
+
+}
+
+#endif // _WIN32
+
+#endif // STDCORELIB_PROCESSREACTOR_H
@@ -0,0 +1,101 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: MIT
+
+"""Generates src/console_width_p.h, the column widths console::display_width() looks up.
+
+    python3 scripts/gen_width_tables.py > src/console_width_p.h
+
+The data comes from the unicodedata module, so the tables follow whichever Unicode version the
+Python running this was built with, and the header says which. Run it again with a newer Python to
+move to a newer Unicode.
+
+Every code point gets one of three widths: zero for what attaches to the character before it
+(general categories Mn, Me and Cf, and the Hangul vowels and finals that join a syllable), two
+for East Asian Wide and Fullwidth, and one for everything else. Unassigned code points in the
+blocks Unicode reserves for ideographs count as wide, as EastAsianWidth.txt has them.
+
+The widths take two bits each and go into a two-level table: the high bits of a code point pick
+a block of 256, and blocks that come out the same are stored once. Most of the code space is one
+block of ones, which is what keeps the whole thing to a few kilobytes.
+"""
+
+import sys
+import unicodedata
+
+NARROW, ZERO, WIDE = 0, 1, 2
+
+# Unassigned, but reserved for ideographs and wide by default.
+WIDE_RESERVED = [
+    (0x3400, 0x4DBF),
+    (0x4E00, 0x9FFF),
+    (0xF900, 0xFAFF),
+    (0x20000, 0x2FFFD),
+    (0x30000, 0x3FFFD),
+]
+
+# Conjoining jamo: a vowel or a final that only ever appears inside a syllable an initial
+# consonant has already taken two columns for.
+ZERO_EXTRA = [
+    (0x1160, 0x11FF),
+    (0xD7B0, 0xD7FF),
+]
+
+
+def width_of(c):
+    ch = chr(c)
+    category = unicodedata.category(ch)
+    if any(lo <= c <= hi for lo, hi in ZERO_EXTRA):
+        return ZERO
+    if category in ('Mn', 'Me', 'Cf'):
+        return ZERO
+    if unicodedata.east_asian_width(ch) in ('W', 'F'):
+        return WIDE
+    if category == 'Cn' and any(lo <= c <= hi for lo, hi in WIDE_RESERVED):
+        return WIDE
+    return NARROW
+
+
+def main():
+    blocks = []
+    index = {}
+    stage1 = []
+    for base in range(0, 0x110000, 256):
+        packed = bytearray(64)
+        for i in range(256):
+            packed[i >> 2] |= width_of(base + i) << ((i & 3) * 2)
+        key = bytes(packed)
+        if key not in index:
+            index[key] = len(blocks)
+            blocks.append(key)
+        stage1.append(index[key])
+    assert len(blocks) <= 256
+
+    out = sys.stdout
+    out.write('// SPDX-License-Identifier: MIT\n\n')
+    out.write('// Generated by scripts/gen_width_tables.py from Unicode %s. Do not edit.\n\n'
+              % unicodedata.unidata_version)
+    out.write('#ifndef STDCORELIB_CONSOLE_WIDTH_P_H\n#define STDCORELIB_CONSOLE_WIDTH_P_H\n\n')
+    out.write('#include <cstdint>\n\n')
+    out.write('namespace stdc::console::detail {\n\n')
+    out.write('    /// The Unicode version the tables below were generated from.\n')
+    out.write('    inline constexpr const char *width_unicode_version = "%s";\n\n'
+              % unicodedata.unidata_version)
+    out.write('    /// Which block of width_blocks each 256 code points use.\n')
+    out.write('    inline constexpr uint8_t width_index[%d] = {\n' % len(stage1))
+    for i in range(0, len(stage1), 16):
+        out.write('        ' + ' '.join('%d,' % v for v in stage1[i:i + 16]) + '\n')
+    out.write('    };\n\n')
+    out.write('    /// Two bits a code point, four to a byte, lowest first: 0 for one column, 1 for\n')
+    out.write('    /// none, 2 for two.\n')
+    out.write('    inline constexpr uint8_t width_blocks[%d][64] = {\n' % len(blocks))
+    for block in blocks:
+        out.write('        {\n')
+        for i in range(0, 64, 16):
+            out.write('            ' + ' '.join('%d,' % v for v in block[i:i + 16]) + '\n')
+        out.write('        },\n')
+    out.write('    };\n\n')
+    out.write('}\n\n#endif // STDCORELIB_CONSOLE_WIDTH_P_H\n')
+
+
+if __name__ == '__main__':
+    main()
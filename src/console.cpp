@@ -20,7 +20,9 @@
 #include "utf.h"
 
 #include "console_p.h"
+#include "console_width_p.h"
 #include "str_p.h"
+#include "utf_p.h"
 
 namespace stdc {
 
@@ -550,45 +552,121 @@ namespace stdc {
 
         namespace {
 
-            /// The code point ranges that take two columns, from Unicode's East Asian Width
-            /// property. The Wide and Fullwidth blocks a program prints in practice, rather than
-            /// the whole table, which would be several hundred ranges and a generator to keep it.
-            bool is_wide(char32_t c) {
-                return (c >= 0x1100 && c <= 0x115F) ||   // Hangul Jamo, initial consonants
-                       (c >= 0x2E80 && c <= 0x303E) ||   // CJK radicals, Kangxi, CJK symbols
-                       (c >= 0x3041 && c <= 0x33FF) ||   // kana through CJK compatibility
-                       (c >= 0x3400 && c <= 0x4DBF) ||   // CJK extension A
-                       (c >= 0x4E00 && c <= 0x9FFF) ||   // CJK unified ideographs
-                       (c >= 0xA000 && c <= 0xA4CF) ||   // Yi
-                       (c >= 0xAC00 && c <= 0xD7A3) ||   // Hangul syllables
-                       (c >= 0xF900 && c <= 0xFAFF) ||   // CJK compatibility ideographs
-                       (c >= 0xFE30 && c <= 0xFE6F) ||   // CJK compatibility forms
-                       (c >= 0xFF00 && c <= 0xFF60) ||   // fullwidth forms
-                       (c >= 0xFFE0 && c <= 0xFFE6) ||   // fullwidth signs
-                       (c >= 0x1F300 && c <= 0x1F64F) || // pictographs and emoticons
-                       (c >= 0x1F900 && c <= 0x1F9FF) || // supplemental symbols
-                       (c >= 0x20000 && c <= 0x3FFFD);   // CJK extension B and later
+            /// The columns \a c takes on its own, from the generated tables: none for a mark
+            /// that attaches to the character before it, two for East Asian Wide and Fullwidth,
+            /// one for the rest.
+            inline int column_width(char32_t c) {
+                if (c > utf::max_code_point) {
+                    return 1;
+                }
+                const auto &block = detail::width_blocks[detail::width_index[c >> 8]];
+                const int bits = (block[(c & 0xFF) >> 2] >> ((c & 3) * 2)) & 3;
+                return bits == 0 ? 1 : bits == 1 ? 0 : 2;
+            }
+
+            constexpr char32_t zero_width_joiner = 0x200D;
+            constexpr char32_t emoji_presentation_selector = 0xFE0F;
+
+            inline bool is_regional_indicator(char32_t c) {
+                return c >= 0x1F1E6 && c <= 0x1F1FF;
             }
 
-            /// Marks that attach to the character before them, taking no column of their own.
-            bool is_combining(char32_t c) {
-                return (c >= 0x0300 && c <= 0x036F) || (c >= 0x1AB0 && c <= 0x1AFF) ||
-                       (c >= 0x20D0 && c <= 0x20FF) || (c >= 0xFE20 && c <= 0xFE2F);
+            inline bool is_emoji_modifier(char32_t c) {
+                return c >= 0x1F3FB && c <= 0x1F3FF;
             }
 
         }
 
         int display_width(char32_t c) {
-            if (is_combining(c)) {
-                return 0;
-            }
-            return is_wide(c) ? 2 : 1;
+            return column_width(c);
         }
 
         int display_width(const std::string_view &utf8) {
+            const char *const data = utf8.data();
+            const size_t size = utf8.size();
+
             int columns = 0;
-            for (char32_t c : utf::utf8_to_utf32(utf8)) {
-                columns += display_width(c);
+            size_t pos = 0;
+
+            // What a terminal draws as one picture is a cluster of code points, and only the
+            // first of them takes room: the joiner between two emoji, a skin tone after one, the
+            // second of a pair of flags. The cluster in progress is its width, or 0 when there
+            // is none that anything could still join, which is the case after plain ASCII.
+            int cluster = 0;
+            bool joining = false;     // the last code point was a joiner after an emoji
+            bool open_flag = false;   // the last code point was the first half of a flag
+
+            while (pos < size) {
+                // ASCII eight bytes at a time, a column each, which is most of what is measured.
+                // Nothing joins onto it, so it closes whatever cluster was in progress.
+                if (static_cast<unsigned char>(data[pos]) < 0x80) {
+                    size_t start = pos;
+                    while (pos + 8 <= size) {
+                        uint64_t word;
+                        std::memcpy(&word, data + pos, 8);
+                        if (word & 0x8080808080808080ULL) {
+                            break;
+                        }
+                        pos += 8;
+                    }
+                    while (pos < size && static_cast<unsigned char>(data[pos]) < 0x80) {
+                        ++pos;
+                    }
+                    columns += int(pos - start);
+                    cluster = 0;
+                    joining = false;
+                    open_flag = false;
+                    continue;
+                }
+
+                char32_t c;
+                if (!utf::detail::decode_utf8(utf8, pos, c)) {
+                    c = utf::replacement_character;
+                }
+
+                if (c == zero_width_joiner) {
+                    joining = cluster == 2;
+                    continue;
+                }
+                if (joining) {
+                    // The next picture of the sequence, drawn into the same two columns.
+                    joining = false;
+                    if (column_width(c) > 0) {
+                        continue;
+                    }
+                }
+                if (c == emoji_presentation_selector) {
+                    // A symbol that has a text form and an emoji form, asked for the emoji one,
+                    // which takes two columns where the text one took one.
+                    if (cluster == 1) {
+                        columns += 1;
+                        cluster = 2;
+                    }
+                    continue;
+                }
+                if (is_emoji_modifier(c) && cluster == 2) {
+                    continue;
+                }
+                if (is_regional_indicator(c)) {
+                    // Two of them are one flag, of two columns, and one alone is a letter.
+                    if (open_flag) {
+                        open_flag = false;
+                        columns += 1;
+                        cluster = 2;
+                    } else {
+                        open_flag = true;
+                        columns += 1;
+                        cluster = 1;
+                    }
+                    continue;
+                }
+                open_flag = false;
+
+                int width = column_width(c);
+                if (width > 0) {
+                    columns += width;
+                    cluster = width;
+                }
             }
             return columns;
         }
@@ -949,6 +1027,90 @@ namespace stdc {
             return cvfprintf(stdout, fmt, args);
         }
 
+        styled_buffer &styled_buffer::append(int style, int fg, int bg,
+                                             const std::string_view &text) {
+            if (text.empty()) {
+                return *this;
+            }
+            _text.append(text);
+            // Text in the attributes of the run before it only moves that run's end, so the
+            // runs are the attribute changes and nothing else.
+            if (!_runs.empty()) {
+                auto &last = _runs.back();
+                if (last.style == style && last.fg == fg && last.bg == bg) {
+                    last.end = _text.size();
+                    return *this;
+                }
+            }
+            _runs.push_back({_text.size(), style, fg, bg});
+            return *this;
+        }
+
+        void styled_buffer::clear() {
+            _text.clear();
+            _runs.clear();
+        }
+
+        std::string styled_buffer::render(color_mode mode) const {
+            if (mode != color_mode::vt) {
+                return _text;
+            }
+
+            std::string out;
+            out.reserve(_text.size() + _runs.size() * 8);
+
+            detail::attributes current;
+            size_t start = 0;
+            for (const auto &r : _runs) {
+                detail::attributes next{r.style, r.fg, r.bg};
+                if (next != current) {
+                    // There is no code for turning one attribute off, so dropping anything, a
+                    // style bit or a color for one without a code, goes through the reset.
+                    bool drops = (current.style & ~next.style) ||
+                                 (current.fg != next.fg && !detail::fg_code(next.fg)) ||
+                                 (current.bg != next.bg && !detail::bg_code(next.bg));
+                    if (drops) {
+                        out += detail::sgr_reset_sequence(current);
+                        current = {};
+                    }
+                    out += detail::sgr_sequence(current, next);
+                    current = next;
+                }
+                out.append(_text, start, r.end - start);
+                start = r.end;
+            }
+            out += detail::sgr_reset_sequence(current);
+            return out;
+        }
+
+        int styled_buffer::write(FILE *file) const {
+            auto mode = resolve_color_mode(file);
+
+#ifdef _WIN32
+            // The console API styles whatever is written after each call, so here it still
+            // comes down to one write for each run, though under the one lock all the same.
+            if (mode == color_mode::windows_legacy) {
+                ConsoleOutputGuard cog(file);
+                size_t start = 0;
+                size_t written = 0;
+                for (const auto &r : _runs) {
+                    cog.reset();
+                    cog.change(r.style, r.fg, r.bg);
+                    written += std::fwrite(_text.data() + start, sizeof(char), r.end - start, file);
+                    start = r.end;
+                }
+                return written == _text.size() ? int(written) : EOF;
+            }
+#endif
+
+            // Rendered before the lock is taken, so that the lock covers the write alone.
+            auto frame = render(mode);
+
+            ConsoleOutputGuard cog(file);
+            size_t written = std::fwrite(frame.data(), sizeof(char), frame.size(), file);
+            return written == frame.size() ? int(_text.size()) : EOF;
+        }
+
     }
 
 }
@@ -0,0 +1,366 @@
+// SPDX-License-Identifier: MIT
+
+#include "console.h"
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "utf_p.h"
+
+namespace stdc::console {
+
+    namespace {
+
+        using steady = std::chrono::steady_clock;
+
+        /// What one position on the screen holds: the code points drawn there, the zero width
+        /// ones that hang on the first included, and the attributes they are drawn in.
+        struct cell {
+            std::string text;
+            int width;
+            int style;
+            int fg;
+            int bg;
+
+            friend bool operator==(const cell &lhs, const cell &rhs) {
+                return lhs.width == rhs.width && lhs.style == rhs.style && lhs.fg == rhs.fg &&
+                       lhs.bg == rhs.bg && lhs.text == rhs.text;
+            }
+            friend bool operator!=(const cell &lhs, const cell &rhs) {
+                return !(lhs == rhs);
+            }
+        };
+
+        using row = std::vector<cell>;
+
+        int width_of(const row &r, size_t begin, size_t end) {
+            int columns = 0;
+            for (size_t i = begin; i < end; ++i) {
+                columns += r[i].width;
+            }
+            return columns;
+        }
+
+        void append_cells(styled_buffer &frame, const row &r, size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                frame.append(r[i].style, r[i].fg, r[i].bg, r[i].text);
+            }
+        }
+
+        // Cursor movements, which have to be numbered from one: a count of zero means one.
+        std::string cursor_up(int n) {
+            return "\033[" + std::to_string(n) + "A";
+        }
+
+        std::string cursor_down(int n) {
+            return "\033[" + std::to_string(n) + "B";
+        }
+
+        std::string cursor_to_column(int column) {
+            return "\033[" + std::to_string(column + 1) + "G";
+        }
+
+        constexpr std::string_view clear_to_end = "\033[K";
+
+    }
+
+    class live_region::impl {
+    public:
+        impl(int lines, FILE *file)
+            : file(file), lines(lines < 1 ? 1 : lines), live(resolve_color_mode(file) == vt),
+              content(size_t(this->lines)), shown(size_t(this->lines)) {
+        }
+
+        /// Cuts \a line into the cells it is drawn as, as many as fit in \a columns.
+        static row split(const styled_buffer &line, int columns) {
+            row r;
+            int used = 0;
+            bool joining = false;
+            size_t pos = 0;
+            for (const auto &run : line._runs) {
+                std::string_view text(line._text.data(), run.end);
+                while (pos < run.end) {
+                    size_t start = pos;
+                    char32_t c;
+                    if (!utf::detail::decode_utf8(text, pos, c)) {
+                        c = utf::replacement_character;
+                    }
+                    std::string_view bytes = text.substr(start, pos - start);
+                    if (c < 0x20 || c == 0x7F) {
+                        c = U' ';
+                        bytes = " ";
+                    }
+
+                    int width = display_width(c);
+                    // What hangs on the cell before it goes in with it, which includes the
+                    // second picture of an emoji sequence.
+                    if ((width == 0 || joining) && !r.empty()) {
+                        r.back().text.append(bytes);
+                        joining = c == 0x200D;
+                        continue;
+                    }
+                    joining = c == 0x200D;
+                    if (width == 0) {
+                        continue;
+                    }
+                    if (used + width > columns) {
+                        return r;
+                    }
+                    used += width;
+                    r.push_back({std::string(bytes), width, run.style, run.fg, run.bg});
+                }
+            }
+            return r;
+        }
+
+        bool due() const {
+            return steady::now() - last_draw >= (live ? interval : plain_interval);
+        }
+
+        /// Draws the lines in place. The cursor rests at the start of the line below the region
+        /// between frames, which is where anything that comes after them has to start.
+        ///
+        /// \a here draws every line again from where the cursor is, rather than what changed.
+        void draw_live(bool here, styled_buffer &frame) {
+            int columns = console::width(file);
+            std::vector<row> next(static_cast<size_t>(lines));
+            for (int i = 0; i < lines; ++i) {
+                next[i] = split(content[i], columns);
+            }
+
+            if (!drawn || here || columns != shown_columns) {
+                // A resized terminal may have wrapped the old frame onto lines of its own, which
+                // nothing can find again, so the best there is is to start over from the top.
+                if (drawn && !here) {
+                    frame.append(cursor_up(lines));
+                }
+                for (const auto &r : next) {
+                    append_cells(frame, r, 0, r.size());
+                    if (drawn) {
+                        frame.append(clear_to_end);
+                    }
+                    frame.append("\n");
+                }
+            } else {
+                int at = lines;
+                for (int i = 0; i < lines; ++i) {
+                    const row &before = shown[i];
+                    const row &after = next[i];
+
+                    size_t first = 0;
+                    while (first < before.size() && first < after.size() &&
+                           before[first] == after[first]) {
+                        ++first;
+                    }
+                    if (first == before.size() && first == after.size()) {
+                        continue;
+                    }
+
+                    // With the width unchanged, what is the same at the end sits in the same
+                    // columns as before and needs no writing either.
+                    size_t last = after.size();
+                    int old_width = width_of(before, 0, before.size());
+                    int new_width = width_of(after, 0, after.size());
+                    if (old_width == new_width) {
+                        size_t b = before.size();
+                        while (last > first && b > first && before[b - 1] == after[last - 1]) {
+                            --b;
+                            --last;
+                        }
+                    }
+
+                    frame.append(i < at ? cursor_up(at - i) : cursor_down(i - at));
+                    at = i;
+                    frame.append(cursor_to_column(width_of(after, 0, first)));
+                    append_cells(frame, after, first, last);
+                    if (new_width < old_width) {
+                        frame.append(clear_to_end);
+                    }
+                }
+                if (at == lines) {
+                    return; // nothing changed
+                }
+                frame.append(cursor_down(lines - at));
+                frame.append("\r");
+            }
+
+            shown = std::move(next);
+            shown_columns = columns;
+            drawn = true;
+        }
+
+        /// Prints the lines that have something in them, one after another.
+        void draw_plain(styled_buffer &frame) {
+            for (const auto &line : content) {
+                if (!line.empty()) {
+                    frame.append(line.render(never));
+                    frame.append("\n");
+                }
+            }
+        }
+
+        void draw(bool force) {
+            if (!dirty || (!force && !due())) {
+                return;
+            }
+            styled_buffer frame;
+            if (live) {
+                draw_live(false, frame);
+            } else {
+                draw_plain(frame);
+            }
+            write(frame);
+            dirty = false;
+            last_draw = steady::now();
+        }
+
+        void write(const styled_buffer &frame) {
+            if (!frame.empty()) {
+                frame.write(file);
+                std::fflush(file);
+            }
+        }
+
+        void set_line(int index, const styled_buffer &line) {
+            if (index < 0 || index >= lines || finished) {
+                return;
+            }
+            auto &current = content[index];
+            if (current._text == line._text && same_runs(current, line)) {
+                return;
+            }
+            current = line;
+            dirty = true;
+            draw(false);
+        }
+
+        static bool same_runs(const styled_buffer &lhs, const styled_buffer &rhs) {
+            if (lhs._runs.size() != rhs._runs.size()) {
+                return false;
+            }
+            for (size_t i = 0; i < lhs._runs.size(); ++i) {
+                const auto &a = lhs._runs[i];
+                const auto &b = rhs._runs[i];
+                if (a.end != b.end || a.style != b.style || a.fg != b.fg || a.bg != b.bg) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        void println(const styled_buffer &line) {
+            styled_buffer frame;
+            if (!live || finished || !drawn) {
+                frame = line;
+                frame.append("\n");
+                write(frame);
+                return;
+            }
+
+            // Over the top of the region, clearing what each line leaves of it, and then the
+            // region again underneath.
+            frame.append(cursor_up(lines));
+            size_t start = 0;
+            for (const auto &run : line._runs) {
+                std::string_view text(line._text.data() + start, run.end - start);
+                for (size_t nl; (nl = text.find('\n')) != std::string_view::npos;) {
+                    frame.append(run.style, run.fg, run.bg, text.substr(0, nl));
+                    frame.append(clear_to_end);
+                    frame.append("\n");
+                    text.remove_prefix(nl + 1);
+                }
+                frame.append(run.style, run.fg, run.bg, text);
+                start = run.end;
+            }
+            frame.append(clear_to_end);
+            frame.append("\n");
+
+            // The region starts over on the line below.
+            draw_live(true, frame);
+            write(frame);
+            dirty = false;
+            last_draw = steady::now();
+        }
+
+        std::mutex mutex;
+
+        FILE *const file;
+        const int lines;
+        const bool live;
+        std::chrono::milliseconds interval{100};
+        std::chrono::milliseconds plain_interval{5000};
+
+        std::vector<styled_buffer> content; // what the lines should say
+        std::vector<row> shown;             // what the terminal shows, live only
+        int shown_columns = 0;
+        bool drawn = false;
+        bool dirty = false;
+        bool finished = false;
+        steady::time_point last_draw{};
+    };
+
+    live_region::live_region(int lines, FILE *file) : _impl(std::make_unique<impl>(lines, file)) {
+    }
+
+    live_region::~live_region() {
+        finish();
+    }
+
+    int live_region::lines() const {
+        return _impl->lines;
+    }
+
+    bool live_region::is_live() const {
+        return _impl->live;
+    }
+
+    void live_region::set_interval(std::chrono::milliseconds interval) {
+        std::lock_guard lock(_impl->mutex);
+        _impl->interval = interval;
+    }
+
+    void live_region::set_plain_interval(std::chrono::milliseconds interval) {
+        std::lock_guard lock(_impl->mutex);
+        _impl->plain_interval = interval;
+    }
+
+    void live_region::set_line(int index, const styled_buffer &line) {
+        std::lock_guard lock(_impl->mutex);
+        _impl->set_line(index, line);
+    }
+
+    void live_region::set_line(int index, const std::string_view &text) {
+        styled_buffer line;
+        line.append(text);
+        set_line(index, line);
+    }
+
+    void live_region::println(const styled_buffer &line) {
+        std::lock_guard lock(_impl->mutex);
+        _impl->println(line);
+    }
+
+    void live_region::println(const std::string_view &text) {
+        styled_buffer line;
+        line.append(text);
+        println(line);
+    }
+
+    void live_region::refresh() {
+        std::lock_guard lock(_impl->mutex);
+        if (!_impl->finished) {
+            _impl->draw(true);
+        }
+    }
+
+    void live_region::finish() {
+        std::lock_guard lock(_impl->mutex);
+        if (_impl->finished) {
+            return;
+        }
+        _impl->draw(true);
+        _impl->finished = true;
+    }
+
+}
@@ -9,6 +9,8 @@
 #  include "winextra.h"
 #endif
 
+#include <charconv>
+#include <cstdio>
 #include <cstring>
 #include <cstdarg>
 
@@ -215,17 +217,11 @@ namespace stdc {
             return res;
         }
 
-        std::string format(const std::string_view &fmt, const array_view<std::string> &args) {
-            struct Part {
-                const char *data;
-                size_t size;
-            };
-            vlarray<Part, 10> parts;
-
-            const auto &push_back = [&parts](const char *data, size_t size) {
-                parts.push_back({data, size});
-            };
-
+        // The one parser both format() and format_to() run, handing each placeholder with a
+        // valid index to append_arg.
+        template <class AppendArg>
+        static void format_impl(std::string &out, const std::string_view &fmt, size_t count,
+                                AppendArg &&append_arg) {
             auto segment_start = fmt.data();
             auto format_end = fmt.data() + fmt.size();
             const auto &is_end = [format_end](const char *p) {
@@ -237,10 +233,7 @@ namespace stdc {
                 if (*p == '%' && !is_end(p + 1)) {
                     auto next = *(p + 1);
                     if (next == '%') { // Literal '%'
-                        if (p > segment_start) {
-                            push_back(segment_start, p - segment_start);
-                        }
-                        push_back("%", 1); // Add '%'
+                        out.append(segment_start, p + 1); // up to and including the first '%'
                         p += 2;
                         segment_start = p; // Skip "%%"
                         continue;
@@ -253,11 +246,9 @@ namespace stdc {
                             q++;
                         }
                         index--; // %1 -> index 0
-                        if (index >= 0 && index < args.size()) {
-                            if (p > segment_start) {
-                                push_back(segment_start, p - segment_start);
-                            }
-                            push_back(args[index].data(), args[index].size());
+                        if (index >= 0 && size_t(index) < count) {
+                            out.append(segment_start, p);
+                            append_arg(size_t(index));
                             segment_start = q;
                         } else {
                             // Invalid index, as literal
@@ -268,27 +259,52 @@ namespace stdc {
                 }
                 p++;
             }
-            if (p > segment_start) {
-                push_back(segment_start, p - segment_start); // Add last part
-            }
+            out.append(segment_start, p); // Add last part
+        }
 
-            size_t total_length = 0;
-            for (int i = 0; i < parts.size(); i++) {
-                total_length += parts[i].size;
+        std::string format(const std::string_view &fmt, const array_view<std::string> &args) {
+            // Enough for every argument to appear once, which is the usual case, so that the
+            // result is allocated once.
+            size_t capacity = fmt.size();
+            for (const auto &arg : args) {
+                capacity += arg.size();
             }
-
-            // Construct result
             std::string res;
-            res.resize(total_length);
-
-            auto dest = res.data();
-            for (int i = 0; i < parts.size(); i++) {
-                memcpy(dest, parts[i].data, parts[i].size);
-                dest += parts[i].size;
-            }
+            res.reserve(capacity);
+            format_impl(res, fmt, args.size(), [&](size_t i) { res.append(args[i]); });
             return res;
         }
 
+        void format_to(std::string &out, const std::string_view &fmt, const format_arg *args,
+                       size_t count) {
+            out.reserve(out.size() + fmt.size() + 16 * count);
+            format_impl(out, fmt, count, [&](size_t i) { args[i].append(out, args[i].value); });
+        }
+
+        // std::ostream prints a floating point value with its default flags as %g with a
+        // precision of 6 would, which to_chars() reproduces without a stream or a locale.
+        void append_number(std::string &out, double value) {
+            char buf[64];
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+            auto res = std::to_chars(buf, buf + sizeof(buf), value, std::chars_format::general, 6);
+            out.append(buf, res.ptr);
+#else
+            int n = std::snprintf(buf, sizeof(buf), "%g", value);
+            out.append(buf, n > 0 ? size_t(n) : 0);
+#endif
+        }
+
+        void append_number(std::string &out, long double value) {
+            char buf[64];
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+            auto res = std::to_chars(buf, buf + sizeof(buf), value, std::chars_format::general, 6);
+            out.append(buf, res.ptr);
+#else
+            int n = std::snprintf(buf, sizeof(buf), "%Lg", value);
+            out.append(buf, n > 0 ? size_t(n) : 0);
+#endif
+        }
+
         std::string varexp(const std::string_view &s,
                            const std::function<std::string(const std::string_view &)> &find) {
             vlarray<varexp_part, 10> parts;
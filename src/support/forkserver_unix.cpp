@@ -0,0 +1,1014 @@
+// SPDX-License-Identifier: MIT
+
+#include "forkserver.h"
+#include "popen_p.h"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#ifdef __linux__
+#  include <sys/syscall.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "str.h"
+
+extern char **environ;
+
+namespace stdc {
+
+    // One request is a header, sent together with every descriptor the request carries, and
+    // then a body of integers and strings. The descriptors are, in order: the child's socket
+    // to its Popen, the working directory when there is one, and one for each entry of the
+    // child's descriptor table.
+    struct fork_request_header {
+        uint64_t body_size;
+        uint32_t fd_count;
+        uint32_t reserved;
+    };
+
+    enum fork_request_flag : int64_t {
+        request_close_fds = 1,
+        request_restore_signals = 2,
+        request_start_new_session = 4,
+        request_has_cwd_fd = 8,
+    };
+
+    // Each child has a socket of its own between the Popen and the server. The first thing
+    // on it is this, once the child is forked or has failed to be, with the child's pidfd
+    // riding along where the server could open one.
+    struct fork_spawn_report {
+        int32_t pid; // -1 on failure
+        int32_t error;
+    };
+
+    // The last thing on it, once the server has reaped the child.
+    struct fork_exit_report {
+        int32_t status;
+        int32_t reserved;
+        struct rusage usage;
+    };
+
+    // The other way, a signal for the server to send the child, if it is still there.
+    struct fork_signal_request {
+        int32_t sig;
+    };
+
+    // Linux takes at most 253 descriptors in one message.
+    constexpr size_t fork_request_max_fds = 250;
+
+    // Far beyond any command line the kernel would take, and a bound on what a broken request
+    // can have the server allocate.
+    constexpr uint64_t fork_request_max_body = uint64_t(256) << 20;
+
+#ifdef MSG_NOSIGNAL
+    constexpr int fork_send_flags = MSG_NOSIGNAL;
+#else
+    constexpr int fork_send_flags = 0; // SO_NOSIGPIPE on the socket instead
+#endif
+
+    /// What the server changes about signals, as this process had it, so that each child can
+    /// be given it back before anything else runs there.
+    struct fork_server_signals {
+        static constexpr int changed[] = {SIGCHLD, SIGPIPE, SIGINT, SIGQUIT};
+        struct sigaction actions[std::size(changed)];
+        sigset_t mask;
+    };
+
+    class fork_request_writer {
+    public:
+        void put(int64_t value) {
+            data.append(reinterpret_cast<const char *>(&value), sizeof(value));
+        }
+
+        void put(const char *str) {
+            size_t size = std::strlen(str);
+            put(int64_t(size));
+            data.append(str, size + 1);
+        }
+
+        void put_list(char *const *list) {
+            int64_t count = 0;
+            while (list[count]) {
+                ++count;
+            }
+            put(count);
+            for (int64_t i = 0; i < count; ++i) {
+                put(list[i]);
+            }
+        }
+
+        std::string data;
+    };
+
+    // Reads what the writer wrote, and turns anything short or out of range into !ok() rather
+    // than a read past the end. Strings point into the request, which keeps their nulls.
+    class fork_request_reader {
+    public:
+        explicit fork_request_reader(std::string &data)
+            : _p(data.data()), _end(data.data() + data.size()) {
+        }
+
+        bool ok() const {
+            return _ok;
+        }
+
+        int64_t get() {
+            int64_t value = 0;
+            if (!_ok || _end - _p < ptrdiff_t(sizeof(value))) {
+                _ok = false;
+                return 0;
+            }
+            std::memcpy(&value, _p, sizeof(value));
+            _p += sizeof(value);
+            return value;
+        }
+
+        // A count of things at least eight bytes each, which bounds it by what is left.
+        size_t get_count() {
+            int64_t count = get();
+            if (!_ok || count < 0 || count > (_end - _p) / 8) {
+                _ok = false;
+                return 0;
+            }
+            return size_t(count);
+        }
+
+        char *get_str() {
+            int64_t size = get();
+            if (!_ok || size < 0 || _end - _p <= size || _p[size] != '\0') {
+                _ok = false;
+                return nullptr;
+            }
+            char *str = _p;
+            _p += size + 1;
+            return str;
+        }
+
+        void get_list(std::vector<char *> &list) {
+            size_t count = get_count();
+            for (size_t i = 0; i < count && _ok; ++i) {
+                list.push_back(get_str());
+            }
+            list.push_back(nullptr);
+        }
+
+    private:
+        char *_p;
+        char *_end;
+        bool _ok = true;
+    };
+
+    static bool write_full(int fd, const void *data, size_t size) {
+        auto p = static_cast<const char *>(data);
+        while (size > 0) {
+            ssize_t n = ::send(fd, p, size, fork_send_flags);
+            if (n < 0 && errno == ENOTSOCK) {
+                n = ::write(fd, p, size);
+            }
+            if (n < 0 && errno == EAGAIN) {
+                struct pollfd pfd = {fd, POLLOUT, 0};
+                ::poll(&pfd, 1, -1);
+                continue;
+            }
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                return false;
+            }
+            p += n;
+            size -= size_t(n);
+        }
+        return true;
+    }
+
+    static bool read_full(int fd, void *data, size_t size) {
+        auto p = static_cast<char *>(data);
+        while (size > 0) {
+            ssize_t n = ::read(fd, p, size);
+            if (n < 0 && errno == EAGAIN) {
+                // Non-blocking, and the rest of something sent in one piece is on its way.
+                struct pollfd pfd = {fd, POLLIN, 0};
+                ::poll(&pfd, 1, -1);
+                continue;
+            }
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                return false;
+            }
+            p += n;
+            size -= size_t(n);
+        }
+        return true;
+    }
+
+    static void close_all(const std::vector<int> &fds) {
+        for (int fd : fds) {
+            if (fd != -1) {
+                ::close(fd);
+            }
+        }
+    }
+
+    // Sends \a data with the descriptors riding on it.
+    static bool send_message(int sock, const void *data, size_t size, const int *fds,
+                             size_t fd_count) {
+        struct iovec iov = {const_cast<void *>(data), size};
+        std::vector<char> control(fd_count > 0 ? CMSG_SPACE(sizeof(int) * fd_count) : 0);
+        struct msghdr msg{};
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        if (fd_count > 0) {
+            msg.msg_control = control.data();
+            msg.msg_controllen = control.size();
+            struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+            cmsg->cmsg_level = SOL_SOCKET;
+            cmsg->cmsg_type = SCM_RIGHTS;
+            cmsg->cmsg_len = CMSG_LEN(sizeof(int) * fd_count);
+            std::memcpy(CMSG_DATA(cmsg), fds, sizeof(int) * fd_count);
+        }
+
+        ssize_t n;
+        do {
+            n = ::sendmsg(sock, &msg, fork_send_flags);
+        } while (n < 0 && errno == EINTR);
+        if (n <= 0) {
+            return false;
+        }
+        // The descriptors went with the first byte. Whatever of the data did not is sent
+        // plainly.
+        return write_full(sock, static_cast<const char *>(data) + n, size - size_t(n));
+    }
+
+    // Receives what send_message() sent with at most one descriptor, which is close-on-exec,
+    // and -1 in \a fd if none came.
+    static bool receive_message(int sock, void *data, size_t size, int &fd) {
+        fd = -1;
+        struct iovec iov = {data, size};
+        alignas(struct cmsghdr) char control[CMSG_SPACE(sizeof(int))];
+        struct msghdr msg{};
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+
+        int flags = 0;
+#ifdef MSG_CMSG_CLOEXEC
+        flags |= MSG_CMSG_CLOEXEC;
+#endif
+        ssize_t n;
+        do {
+            n = ::recvmsg(sock, &msg, flags);
+        } while (n < 0 && errno == EINTR);
+        if (n <= 0) {
+            return false;
+        }
+        for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+            if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS &&
+                cmsg->cmsg_len >= CMSG_LEN(sizeof(int))) {
+                std::memcpy(&fd, CMSG_DATA(cmsg), sizeof(int));
+#ifndef MSG_CMSG_CLOEXEC
+                ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+#endif
+            }
+        }
+        if (!read_full(sock, static_cast<char *>(data) + n, size - size_t(n))) {
+            if (fd != -1) {
+                ::close(fd);
+                fd = -1;
+            }
+            return false;
+        }
+        return true;
+    }
+
+    // Close-on-exec on both ends, and no SIGPIPE from writing to one whose peer has gone.
+    static bool make_socket_pair(int sv[2]) {
+#ifdef SOCK_CLOEXEC
+        if (::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sv) != 0) {
+            return false;
+        }
+#else
+        if (::socketpair(AF_UNIX, SOCK_STREAM, 0, sv) != 0) {
+            return false;
+        }
+        ::fcntl(sv[0], F_SETFD, FD_CLOEXEC);
+        ::fcntl(sv[1], F_SETFD, FD_CLOEXEC);
+#endif
+#ifdef SO_NOSIGPIPE
+        int on = 1;
+        ::setsockopt(sv[0], SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+        ::setsockopt(sv[1], SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+#endif
+        return true;
+    }
+
+    // Sends the header with the descriptors riding on it, then the body.
+    static bool send_fork_request(int sock, const std::string &body, const std::vector<int> &fds) {
+        fork_request_header header{};
+        header.body_size = body.size();
+        header.fd_count = uint32_t(fds.size());
+        return send_message(sock, &header, sizeof(header), fds.data(), fds.size()) &&
+               write_full(sock, body.data(), body.size());
+    }
+
+    // False at the end of the stream, or on anything that leaves it out of step. The
+    // descriptors received are close-on-exec, and closed again on failure.
+    static bool receive_fork_request(int sock, std::string &body, std::vector<int> &fds) {
+        fork_request_header header{};
+        struct iovec iov = {&header, sizeof(header)};
+        std::vector<char> control(CMSG_SPACE(sizeof(int) * fork_request_max_fds));
+        struct msghdr msg{};
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        msg.msg_control = control.data();
+        msg.msg_controllen = control.size();
+
+        int flags = 0;
+#ifdef MSG_CMSG_CLOEXEC
+        flags |= MSG_CMSG_CLOEXEC;
+#endif
+        ssize_t n;
+        do {
+            n = ::recvmsg(sock, &msg, flags);
+        } while (n < 0 && errno == EINTR);
+        if (n <= 0) {
+            return false;
+        }
+        for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+            if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS) {
+                continue;
+            }
+            size_t count = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+            for (size_t i = 0; i < count; ++i) {
+                int fd;
+                std::memcpy(&fd, CMSG_DATA(cmsg) + i * sizeof(int), sizeof(int));
+#ifndef MSG_CMSG_CLOEXEC
+                ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+#endif
+                fds.push_back(fd);
+            }
+        }
+
+        bool ok = !(msg.msg_flags & MSG_CTRUNC) &&
+                  read_full(sock, reinterpret_cast<char *>(&header) + n,
+                            sizeof(header) - size_t(n)) &&
+                  header.fd_count == fds.size() && header.body_size <= fork_request_max_body;
+        if (ok) {
+            body.resize(size_t(header.body_size));
+            ok = read_full(sock, body.data(), body.size());
+        }
+        if (!ok) {
+            close_all(fds);
+            fds.clear();
+        }
+        return ok;
+    }
+
+    // Before the descriptors are in place, the error pipe is wherever it was received, so this
+    // is written by hand rather than by _child_exec().
+    [[noreturn]] static void fail_forked_child(int errpipe, int error) {
+        char buf[32] = "OSError:";
+        char *p = buf + std::strlen(buf);
+        char digits[16];
+        int count = 0;
+        unsigned value = unsigned(error);
+        do {
+            digits[count++] = "0123456789abcdef"[value % 16];
+            value /= 16;
+        } while (value != 0);
+        while (count > 0) {
+            *p++ = digits[--count];
+        }
+        std::memcpy(p, ":noexec", 8);
+        std::ignore = ::write(errpipe, buf, std::strlen(buf));
+        _exit(255);
+    }
+
+    static int server_sigchld_write = -1;
+
+    static void server_sigchld_handler(int) {
+        int saved_errno = errno;
+        char byte = 0;
+        std::ignore = ::write(server_sigchld_write, &byte, 1); // a full pipe is already readable
+        errno = saved_errno;
+    }
+
+    // Reaps whatever has exited and tells each one's Popen, in the server.
+    static void reap_fork_server_children(std::map<pid_t, int> &children) {
+        while (true) {
+            fork_exit_report report{};
+            pid_t pid = ::wait4(-1, &report.status, WNOHANG, &report.usage);
+            if (pid < 0 && errno == EINTR) {
+                continue;
+            }
+            if (pid <= 0) {
+                return;
+            }
+            auto it = children.find(pid);
+            if (it == children.end()) {
+                continue;
+            }
+            // -1 once its Popen has gone away, with nobody left to tell.
+            if (it->second != -1) {
+                std::ignore = write_full(it->second, &report, sizeof(report));
+                ::close(it->second);
+            }
+            children.erase(it);
+        }
+    }
+
+    void Popen::Impl::_fork_server_main(int sock) {
+        fork_server_signals signals;
+        pthread_sigmask(SIG_SETMASK, nullptr, &signals.mask);
+        for (size_t i = 0; i < std::size(fork_server_signals::changed); ++i) {
+            sigaction(fork_server_signals::changed[i], nullptr, &signals.actions[i]);
+        }
+
+        // Nothing of this process's but the socket, and the standard streams on the null
+        // device, so that the server holds nothing open that somebody waits to see closed.
+        if (sock < 3) {
+            sock = ::fcntl(sock, F_DUPFD_CLOEXEC, 3);
+        }
+        close_open_fds(3, &sock, 1);
+        int devnull = ::open("/dev/null", O_RDWR);
+        if (devnull != -1) {
+            for (int fd = 0; fd < 3; ++fd) {
+                if (fd != devnull) {
+                    ::dup2(devnull, fd);
+                }
+            }
+            if (devnull > 2) {
+                ::close(devnull);
+            }
+        }
+
+        int self = int(getpid());
+        if (sock == -1 || !write_full(sock, &self, sizeof(self))) {
+            _exit(1);
+        }
+
+        int sigchld_fds[2];
+        if (::pipe(sigchld_fds) != 0) {
+            _exit(1);
+        }
+        for (int fd : sigchld_fds) {
+            ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+            ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+        }
+        server_sigchld_write = sigchld_fds[1];
+
+        struct sigaction sa{};
+        sigemptyset(&sa.sa_mask);
+        sa.sa_handler = server_sigchld_handler;
+        sa.sa_flags = SA_RESTART | SA_NOCLDSTOP;
+        sigaction(SIGCHLD, &sa, nullptr);
+
+        // A child's socket with no Popen left at the other end is for the write to fail on,
+        // and a terminal's interrupt is for the program, which says when the server goes by
+        // closing the socket.
+        sa.sa_handler = SIG_IGN;
+        sa.sa_flags = 0;
+        sigaction(SIGPIPE, &sa, nullptr);
+        sigaction(SIGINT, &sa, nullptr);
+        sigaction(SIGQUIT, &sa, nullptr);
+
+        sigset_t none;
+        sigemptyset(&none);
+        pthread_sigmask(SIG_SETMASK, &none, nullptr);
+
+        // Each child not yet reaped, with the socket to its Popen.
+        std::map<pid_t, int> children;
+        std::vector<struct pollfd> fds;
+        std::vector<pid_t> polled;
+        while (sock != -1 || !children.empty()) {
+            // poll() passes over a negative descriptor, the socket once it has closed.
+            fds.assign({
+                {sigchld_fds[0], POLLIN, 0},
+                {sock,           POLLIN, 0},
+            });
+            polled.clear();
+            for (const auto &[pid, channel] : children) {
+                if (channel != -1) {
+                    fds.push_back({channel, POLLIN, 0});
+                    polled.push_back(pid);
+                }
+            }
+            if (::poll(fds.data(), fds.size(), -1) < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                break;
+            }
+            if (fds[0].revents) {
+                char buf[64];
+                while (::read(sigchld_fds[0], buf, sizeof(buf)) > 0) {
+                }
+                reap_fork_server_children(children);
+            }
+            for (size_t i = 0; i < polled.size(); ++i) {
+                if (!fds[i + 2].revents) {
+                    continue;
+                }
+                // Reaped just now, along with its socket, and the pid no longer its own.
+                auto it = children.find(polled[i]);
+                if (it == children.end()) {
+                    continue;
+                }
+                fork_signal_request request{};
+                if ((fds[i + 2].revents & POLLIN) &&
+                    read_full(it->second, &request, sizeof(request))) {
+                    // Not reaped, so the pid is still this child's, if only as a zombie.
+                    ::kill(it->first, request.sig);
+                    continue;
+                }
+                ::close(it->second);
+                it->second = -1;
+            }
+            if (sock != -1 && fds[1].revents) {
+                std::string body;
+                std::vector<int> received;
+                if (!receive_fork_request(sock, body, received)) {
+                    // Closed, or out of step, and either way nothing more is coming. What was
+                    // started is still seen through.
+                    ::close(sock);
+                    sock = -1;
+                    continue;
+                }
+                _fork_server_spawn(body, received, children, &signals, sock, sigchld_fds);
+            }
+        }
+        _exit(0);
+    }
+
+    void Popen::Impl::_fork_server_spawn(std::string &body, std::vector<int> &fds,
+                                         std::map<int, int> &children,
+                                         const fork_server_signals *signals, int sock,
+                                         const int sigchld_fds[2]) {
+        int report_fd = fds.empty() ? -1 : fds[0];
+        const auto &refuse = [&](int error) {
+            if (report_fd != -1) {
+                fork_spawn_report report{-1, error};
+                std::ignore = write_full(report_fd, &report, sizeof(report));
+            }
+            close_all(fds);
+        };
+
+        fork_request_reader in(body);
+        Impl settings;
+        int64_t flags = in.get();
+        settings.close_fds = flags & request_close_fds;
+        settings.restore_signals = flags & request_restore_signals;
+        settings.start_new_session = flags & request_start_new_session;
+        settings.umask = int(in.get());
+        settings.process_group = int(in.get());
+        int gid = int(in.get());
+        int uid = int(in.get());
+
+        std::vector<int> gids(in.get_count());
+        for (int &g : gids) {
+            g = int(in.get());
+        }
+        size_t rlimit_count = in.get_count();
+        for (size_t i = 0; i < rlimit_count && in.ok(); ++i) {
+            rlimit_setting setting{};
+            setting.resource = int(in.get());
+            setting.soft = in.get();
+            bool has_hard = in.get() != 0;
+            int64_t hard = in.get();
+            if (has_hard) {
+                setting.hard = hard;
+            }
+            settings.rlimits.push_back(setting);
+        }
+
+        char *cwd = in.get_str();
+        std::vector<char *> exec_array, argv, envp;
+        in.get_list(exec_array);
+        in.get_list(argv);
+        in.get_list(envp);
+
+        struct placed_fd {
+            int fd;
+            int target;
+            bool cloexec;
+        };
+        size_t first_entry = (flags & request_has_cwd_fd) ? 2 : 1;
+        std::vector<placed_fd> table(in.get_count());
+        for (size_t i = 0; i < table.size(); ++i) {
+            table[i].target = int(in.get());
+            table[i].cloexec = in.get() != 0;
+            table[i].fd = first_entry + i < fds.size() ? fds[first_entry + i] : -1;
+        }
+        std::vector<int> fds_to_keep(in.get_count());
+        for (int &fd : fds_to_keep) {
+            fd = int(in.get());
+        }
+
+        ChildArgs ca{};
+        ca.p2cread = int(in.get());
+        ca.c2pwrite = int(in.get());
+        ca.errwrite = int(in.get());
+        ca.errpipe_write = int(in.get());
+        ca.p2cwrite = ca.c2pread = ca.errread = ca.errpipe_read = -1;
+
+        int errpipe = -1;
+        for (const auto &entry : table) {
+            if (entry.target == ca.errpipe_write) {
+                errpipe = entry.fd;
+            }
+        }
+        if (!in.ok() || fds.size() != first_entry + table.size() || errpipe == -1 ||
+            argv.size() < 2 || exec_array.size() < 2) {
+            refuse(EINVAL);
+            return;
+        }
+
+        ca.exec_array = exec_array.data();
+        ca.argv = argv.data();
+        ca.envp = envp.data();
+        ca.cwd = *cwd ? cwd : nullptr;
+        ca.fds_to_keep = fds_to_keep.data();
+        ca.fds_to_keep_len = fds_to_keep.size();
+        ca.gid = gid;
+        ca.uid = uid;
+        ca.extra_gids = gids.data();
+        ca.extra_gids_len = int(gids.size());
+        ca.vfork_sigmask = nullptr;
+        int cwd_fd = (flags & request_has_cwd_fd) ? fds[1] : -1;
+
+        pid_t child = fork();
+        if (child == 0) {
+            ::close(sock);
+            ::close(sigchld_fds[0]);
+            ::close(sigchld_fds[1]);
+            ::close(report_fd);
+            for (size_t i = 0; i < std::size(fork_server_signals::changed); ++i) {
+                sigaction(fork_server_signals::changed[i], &signals->actions[i], nullptr);
+            }
+            pthread_sigmask(SIG_SETMASK, &signals->mask, nullptr);
+
+            // Everything received goes above every number involved first, so that putting one
+            // in its place cannot close another still waiting to be placed.
+            int top = std::max(2, cwd_fd);
+            for (const auto &entry : table) {
+                top = std::max({top, entry.fd, entry.target});
+            }
+            for (auto &entry : table) {
+                int moved = ::fcntl(entry.fd, F_DUPFD_CLOEXEC, top + 1);
+                if (moved == -1) {
+                    fail_forked_child(errpipe, errno);
+                }
+                ::close(entry.fd);
+                if (entry.fd == errpipe) {
+                    errpipe = moved;
+                }
+                entry.fd = moved;
+            }
+            if (cwd_fd != -1) {
+                if (::fchdir(cwd_fd) == -1) {
+                    fail_forked_child(errpipe, errno);
+                }
+                ::close(cwd_fd);
+            }
+
+            // The server's own standard streams are not the child's. A stream this process
+            // had closed stays closed.
+            ::close(0);
+            ::close(1);
+            ::close(2);
+            for (const auto &entry : table) {
+                if (::dup2(entry.fd, entry.target) == -1) {
+                    fail_forked_child(errpipe, errno);
+                }
+                ::fcntl(entry.target, F_SETFD, entry.cloexec ? FD_CLOEXEC : 0);
+            }
+            for (const auto &entry : table) {
+                ::close(entry.fd);
+            }
+
+            settings._child_exec(ca);
+            _exit(255);
+        }
+
+        fork_spawn_report report{int32_t(child), child == -1 ? errno : 0};
+        for (size_t i = 1; i < fds.size(); ++i) {
+            ::close(fds[i]);
+        }
+        int pidfd = -1;
+#if defined(__linux__) && defined(SYS_pidfd_open)
+        // Before the loop can reap the child, so it is this child's and no other's.
+        if (child > 0) {
+            pidfd = int(syscall(SYS_pidfd_open, child, 0));
+        }
+#endif
+        std::ignore = send_message(report_fd, &report, sizeof(report), &pidfd, pidfd != -1);
+        if (pidfd != -1) {
+            ::close(pidfd);
+        }
+        if (child == -1) {
+            ::close(report_fd);
+        } else {
+            children[int(child)] = report_fd;
+        }
+    }
+
+    struct fork_server_state {
+        std::mutex mutex;
+        int socket = -1;
+        int pid = -1;
+
+        static fork_server_state &get() {
+            static fork_server_state state;
+            return state;
+        }
+    };
+
+    bool Popen::Impl::_server_fork_exec(const ChildArgs &ca, int &child) {
+        // The function lives in this process's memory, and a detached child has a launcher
+        // forking twice of its own already.
+        if (preexec_fn || detached) {
+            return false;
+        }
+
+        // The child's descriptors as this process has them, each to be put back at the same
+        // number. Not the ends of the pipes that stay here, which the child only closes.
+        std::vector<std::pair<int, bool>> table;
+        const auto &add = [&](int fd) {
+            if (fd < 0 || fd == ca.p2cwrite || fd == ca.c2pread || fd == ca.errread ||
+                fd == ca.errpipe_read) {
+                return;
+            }
+            for (const auto &entry : table) {
+                if (entry.first == fd) {
+                    return;
+                }
+            }
+            int flags = ::fcntl(fd, F_GETFD);
+            if (flags != -1) {
+                table.emplace_back(fd, (flags & FD_CLOEXEC) != 0);
+            }
+        };
+        for (int fd : {0, 1, 2, ca.p2cread, ca.c2pwrite, ca.errwrite}) {
+            add(fd);
+        }
+        for (size_t i = 0; i < ca.fds_to_keep_len; ++i) {
+            add(ca.fds_to_keep[i]);
+        }
+        if (table.size() + 2 > fork_request_max_fds) {
+            return false;
+        }
+
+        auto &state = fork_server_state::get();
+        std::unique_lock<std::mutex> lock(state.mutex);
+        if (state.socket == -1) {
+            return false;
+        }
+
+        int report_read, report_write;
+        {
+            int sv[2];
+            if (!make_socket_pair(sv)) {
+                child = -1;
+                return true;
+            }
+            report_read = sv[0];
+            report_write = sv[1];
+        }
+        int cwd_fd = ::open(".", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+
+        fork_request_writer out;
+        int64_t flags = 0;
+        if (close_fds) {
+            flags |= request_close_fds;
+        }
+        if (restore_signals) {
+            flags |= request_restore_signals;
+        }
+        if (start_new_session) {
+            flags |= request_start_new_session;
+        }
+        if (cwd_fd != -1) {
+            flags |= request_has_cwd_fd;
+        }
+        out.put(flags);
+        out.put(int64_t(umask));
+        out.put(int64_t(process_group));
+        out.put(int64_t(ca.gid));
+        out.put(int64_t(ca.uid));
+        out.put(int64_t(ca.extra_gids_len));
+        for (int i = 0; i < ca.extra_gids_len; ++i) {
+            out.put(int64_t(ca.extra_gids[i]));
+        }
+        out.put(int64_t(rlimits.size()));
+        for (const auto &setting : rlimits) {
+            out.put(int64_t(setting.resource));
+            out.put(int64_t(setting.soft));
+            out.put(int64_t(setting.hard.has_value()));
+            out.put(int64_t(setting.hard.value_or(0)));
+        }
+        out.put(ca.cwd ? ca.cwd : "");
+        out.put_list(ca.exec_array);
+        out.put_list(ca.argv);
+        // The environment as it is now, which need not be the one the server started with.
+        out.put_list(ca.envp ? ca.envp : environ);
+        out.put(int64_t(table.size()));
+        for (const auto &entry : table) {
+            out.put(int64_t(entry.first));
+            out.put(int64_t(entry.second));
+        }
+        out.put(int64_t(ca.fds_to_keep_len));
+        for (size_t i = 0; i < ca.fds_to_keep_len; ++i) {
+            out.put(int64_t(ca.fds_to_keep[i]));
+        }
+        out.put(int64_t(ca.p2cread));
+        out.put(int64_t(ca.c2pwrite));
+        out.put(int64_t(ca.errwrite));
+        out.put(int64_t(ca.errpipe_write));
+
+        std::vector<int> fds = {report_write};
+        if (cwd_fd != -1) {
+            fds.push_back(cwd_fd);
+        }
+        for (const auto &entry : table) {
+            fds.push_back(entry.first);
+        }
+
+        bool sent = send_fork_request(state.socket, out.data, fds);
+        ::close(report_write);
+        if (cwd_fd != -1) {
+            ::close(cwd_fd);
+        }
+        if (!sent) {
+            // The server is gone, so there is no server. This child, and every one after it,
+            // is forked here instead.
+            ::close(report_read);
+            ::close(state.socket);
+            state.socket = -1;
+            state.pid = -1;
+            return false;
+        }
+        lock.unlock();
+
+        fork_spawn_report report{};
+        int pidfd = -1;
+        if (!receive_message(report_read, &report, sizeof(report), pidfd)) {
+            // Went away with the request in hand. Whether it forked is not known, and nothing
+            // can be done with a child that may exist but will never be reported.
+            ::close(report_read);
+            errno = ECHILD;
+            child = -1;
+            return true;
+        }
+        if (report.pid == -1) {
+            ::close(report_read);
+            errno = report.error;
+            child = -1;
+            return true;
+        }
+        ::fcntl(report_read, F_SETFL, ::fcntl(report_read, F_GETFL) | O_NONBLOCK);
+        _server_socket = report_read;
+        _pidfd = pidfd;
+        child = report.pid;
+        return true;
+    }
+
+    bool Popen::Impl::_server_send_signal(int sig) {
+        fork_signal_request request{sig};
+        if (!write_full(_server_socket, &request, sizeof(request))) {
+            // The server has reaped the child and let go of the socket, or is gone itself,
+            // and either way there is nothing left to signal.
+            std::ignore = _read_server_exit(false);
+        }
+        return true;
+    }
+
+    bool Popen::Impl::_read_server_exit(bool block) {
+        while (true) {
+            if (block) {
+                struct pollfd pfd = {_server_socket, POLLIN, 0};
+                if (::poll(&pfd, 1, -1) < 0 && errno != EINTR) {
+                    error_code = std::error_code(errno, std::generic_category());
+                    return false;
+                }
+            }
+            fork_exit_report report{};
+            ssize_t n = ::read(_server_socket, &report, sizeof(report));
+            if (n > 0 && n < ssize_t(sizeof(report)) &&
+                read_full(_server_socket, reinterpret_cast<char *>(&report) + n,
+                          sizeof(report) - size_t(n))) {
+                // Sent in one piece, and the rest was only a moment behind.
+                n = ssize_t(sizeof(report));
+            }
+            if (n == ssize_t(sizeof(report))) {
+                _handle_exitstatus(report.status);
+                resource_usage = make_resource_usage(report.usage);
+                return true;
+            }
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n < 0 && errno == EAGAIN) {
+                if (block) {
+                    continue;
+                }
+                return false;
+            }
+            // The server went before the child did, and took the status with it. Python's
+            // answer for a status that is gone for good is 0, as for ECHILD.
+            returncode = 0;
+            return true;
+        }
+    }
+
+    bool ForkServer::start(std::string *err_msg) {
+        auto &state = fork_server_state::get();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        if (state.socket != -1) {
+            return true;
+        }
+
+        const auto &fail = [err_msg](const char *api, int error) {
+            if (err_msg) {
+                *err_msg = formatN("%1: %2", api,
+                                   std::error_code(error, std::generic_category()).message());
+            }
+            return false;
+        };
+
+        int sv[2];
+        if (!make_socket_pair(sv)) {
+            return fail("socketpair", errno);
+        }
+
+        // Twice, so that the server is nobody's child here and there is nothing to wait for
+        // when it ends, which may be long after this process lets go of it.
+        pid_t launcher = fork();
+        if (launcher == 0) {
+            ::close(sv[0]);
+            pid_t server = fork();
+            if (server == 0) {
+                Popen::Impl::_fork_server_main(sv[1]);
+            }
+            _exit(server == -1 ? 1 : 0);
+        }
+        int fork_errno = errno;
+        ::close(sv[1]);
+        if (launcher == -1) {
+            ::close(sv[0]);
+            return fail("fork", fork_errno);
+        }
+        int status = 0;
+        while (::waitpid(launcher, &status, 0) == -1 && errno == EINTR) {
+        }
+
+        // The server's first word is its pid, which also says it is up.
+        int pid = -1;
+        if (!read_full(sv[0], &pid, sizeof(pid))) {
+            ::close(sv[0]);
+            return fail("fork", ECHILD);
+        }
+        state.socket = sv[0];
+        state.pid = pid;
+        return true;
+    }
+
+    void ForkServer::stop() {
+        auto &state = fork_server_state::get();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        if (state.socket != -1) {
+            ::close(state.socket);
+            state.socket = -1;
+            state.pid = -1;
+        }
+    }
+
+    bool ForkServer::is_running() {
+        auto &state = fork_server_state::get();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        return state.socket != -1;
+    }
+
+    int ForkServer::pid() {
+        auto &state = fork_server_state::get();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        return state.pid;
+    }
+
+}
@@ -1,10 +1,14 @@
 // SPDX-License-Identifier: MIT
 
 #include "logging.h"
+#include "logging_p.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cstdarg>
 #include <cstdlib>
+#include <memory>
 #include <optional>
 #include <shared_mutex>
 #include <mutex>
@@ -42,7 +46,8 @@ namespace stdc {
         int level = 0;
         bool enable = false;
 
-        bool matchesCategory(const std::string_view &name) const {
+        static bool matches(MatchMode mode, const std::string_view &text,
+                            const std::string_view &name) {
             switch (mode) {
                 case Prefix:
                     return str::starts_with(name, text);
@@ -54,10 +59,6 @@ namespace stdc {
                     return name == text;
             }
         }
-
-        bool appliesToLevel(int lv) const {
-            return level == 0 || level == lv;
-        }
     };
 
     /// Returns the level a trailing `.<token>` names, or 0 if it names none.
@@ -88,6 +89,35 @@ namespace stdc {
         return std::nullopt;
     }
 
+    /// Folds the wildcards of a category pattern into \a rule's match mode and text. The filter
+    /// rules and LogSink::setCategoryFilter() share it, so the two read a pattern alike.
+    static bool parseCategoryPattern(std::string_view pattern, LoggingRule &rule) {
+        bool left = str::starts_with(pattern, '*');
+        bool right = str::ends_with(pattern, '*');
+        if (left)
+            pattern = str::drop_front(pattern);
+        if (right && !pattern.empty())
+            pattern = str::drop_back(pattern);
+
+        if (left && right)
+            rule.mode = LoggingRule::Contains;
+        else if (left)
+            rule.mode = LoggingRule::Suffix;
+        else if (right)
+            rule.mode = LoggingRule::Prefix;
+        else
+            rule.mode = LoggingRule::Exact;
+
+        // Only the ends may carry a wildcard, so a leftover one is unsupported.
+        if (str::contains(pattern, '*'))
+            return false;
+        if (rule.mode == LoggingRule::Exact && pattern.empty())
+            return false;
+
+        rule.text = std::string(pattern);
+        return true;
+    }
+
     /// Parses one `category[.level] = bool` rule. Returns nothing if the line is malformed.
     static std::optional<LoggingRule> parseRule(const std::string_view &line) {
         auto eq = line.find('=');
@@ -110,29 +140,8 @@ namespace stdc {
             }
         }
 
-        bool left = str::starts_with(pattern, '*');
-        bool right = str::ends_with(pattern, '*');
-        if (left)
-            pattern = str::drop_front(pattern);
-        if (right && !pattern.empty())
-            pattern = str::drop_back(pattern);
-
-        if (left && right)
-            rule.mode = LoggingRule::Contains;
-        else if (left)
-            rule.mode = LoggingRule::Suffix;
-        else if (right)
-            rule.mode = LoggingRule::Prefix;
-        else
-            rule.mode = LoggingRule::Exact;
-
-        // Only the ends may carry a wildcard, so a leftover one is unsupported.
-        if (str::contains(pattern, '*'))
+        if (!parseCategoryPattern(pattern, rule))
             return std::nullopt;
-        if (rule.mode == LoggingRule::Exact && pattern.empty())
-            return std::nullopt;
-
-        rule.text = std::string(pattern);
         return rule;
     }
 
@@ -152,20 +161,214 @@ namespace stdc {
         return result;
     }
 
+    /// The rules of one setFilterRules() call, compiled so that a category is matched against all
+    /// of them in one walk over its name rather than a comparison for each rule.
+    ///
+    /// Exact and prefix patterns sit in a trie over their text, suffix patterns in a trie over
+    /// their text reversed. A name walks each trie once, collecting the rules that end on the
+    /// nodes it passes, so the cost goes with the length of the name and the rules that match it.
+    /// Contains patterns are rare enough to be tried one by one.
+    class CompiledLogRules {
+    public:
+        static constexpr uint32_t AllLevels = 0xff;
+
+        explicit CompiledLogRules(std::vector<LoggingRule> rules) : _rules(std::move(rules)) {
+            _prefix.emplace_back();
+            _suffix.emplace_back();
+            for (uint32_t i = 0; i < _rules.size(); ++i) {
+                const auto &rule = _rules[i];
+                switch (rule.mode) {
+                    case LoggingRule::Exact:
+                        _prefix[insert(_prefix, rule.text.begin(), rule.text.end())]
+                            .exact.push_back(i);
+                        break;
+                    case LoggingRule::Prefix:
+                        _prefix[insert(_prefix, rule.text.begin(), rule.text.end())]
+                            .open.push_back(i);
+                        break;
+                    case LoggingRule::Suffix:
+                        _suffix[insert(_suffix, rule.text.rbegin(), rule.text.rend())]
+                            .open.push_back(i);
+                        break;
+                    default:
+                        _contains.push_back(i);
+                        break;
+                }
+            }
+        }
+
+        /// The levels \a name has enabled, bit \c n for level \c n.
+        uint32_t levelMask(const std::string_view &name) const {
+            std::vector<uint32_t> matched;
+            walk(_prefix, name.begin(), name.end(), matched, true);
+            walk(_suffix, name.rbegin(), name.rend(), matched, false);
+            for (auto i : _contains) {
+                if (str::contains(name, _rules[i].text)) {
+                    matched.push_back(i);
+                }
+            }
+
+            uint32_t mask = AllLevels;
+            if (matched.empty()) {
+                return mask;
+            }
+            // Each rule sits in one place only, so sorting is all it takes to apply them in the
+            // order they were written.
+            std::sort(matched.begin(), matched.end());
+            for (auto i : matched) {
+                const auto &rule = _rules[i];
+                uint32_t levels = rule.level ? uint32_t(1) << rule.level : AllLevels;
+                mask = rule.enable ? mask | levels : mask & ~levels;
+            }
+            return mask;
+        }
+
+    private:
+        struct Node {
+            std::vector<std::pair<char, uint32_t>> children;
+            std::vector<uint32_t> open;  // rules matching anything that continues from here
+            std::vector<uint32_t> exact; // rules matching only what ends here
+        };
+
+        // The root is never anybody's child, so 0 doubles as "no such child".
+        static uint32_t child(const std::vector<Node> &trie, uint32_t node, char c) {
+            for (const auto &[key, index] : trie[node].children) {
+                if (key == c) {
+                    return index;
+                }
+            }
+            return 0;
+        }
+
+        template <class It>
+        static uint32_t insert(std::vector<Node> &trie, It first, It last) {
+            uint32_t node = 0;
+            for (; first != last; ++first) {
+                uint32_t next = child(trie, node, *first);
+                if (!next) {
+                    next = uint32_t(trie.size());
+                    trie[node].children.emplace_back(*first, next);
+                    trie.emplace_back();
+                }
+                node = next;
+            }
+            return node;
+        }
+
+        template <class It>
+        static void walk(const std::vector<Node> &trie, It first, It last,
+                         std::vector<uint32_t> &matched, bool exact) {
+            uint32_t node = 0;
+            for (;;) {
+                const auto &n = trie[node];
+                matched.insert(matched.end(), n.open.begin(), n.open.end());
+                if (first == last) {
+                    if (exact) {
+                        matched.insert(matched.end(), n.exact.begin(), n.exact.end());
+                    }
+                    return;
+                }
+                if (!(node = child(trie, node, *first++))) {
+                    return;
+                }
+            }
+        }
+
+        std::vector<LoggingRule> _rules;
+        std::vector<Node> _prefix;
+        std::vector<Node> _suffix;
+        std::vector<uint32_t> _contains;
+    };
+
     class LogRegistry {
     public:
         static inline Logger::LogCallback callback = defaultLogCallback;
-        static inline LogCategory::LogCategoryFilter categoryFilter = defaultLogCategoryFilter;
+        static inline std::atomic<LogCategory::LogCategoryFilter> categoryFilter =
+            defaultLogCategoryFilter;
 
+        // Replaced whole by setFilterRules(), under rulesMutex, which is held for no longer than
+        // it takes to swap or copy the pointer.
         std::string filterRules;
-        std::vector<LoggingRule> rules;
-        std::shared_mutex mutex;
+        std::shared_ptr<const CompiledLogRules> rules =
+            std::make_shared<const CompiledLogRules>(std::vector<LoggingRule>());
+        std::mutex rulesMutex;
+
+        // One rules or filter change at a time, so that two of them cannot interleave their
+        // stores into the same category and leave it with the older one's levels.
+        std::mutex updateMutex;
+
+        // Bumped by every change once it is in place, so that a category evaluated meanwhile can
+        // tell it may have read the old rules.
+        std::atomic<uint64_t> generation{0};
 
+        // Guards the set only. A category is evaluated outside it, and a change holds it shared,
+        // which keeps the categories alive while it walks them.
+        std::shared_mutex mutex;
         std::unordered_set<LogCategory *> categories;
 
+        struct SinkEntry {
+            std::shared_ptr<LogSink> sink;
+            std::unique_ptr<AsyncLogWriter> queue; // null for a sink written to directly
+        };
+        using SinkList = std::vector<std::shared_ptr<SinkEntry>>;
+
+        // Replaced rather than changed, so that delivery takes a snapshot under the lock and
+        // walks it without. A sink is then free to log, or to add and remove sinks, from inside
+        // write(), and the lock is held for no longer than it takes to copy a pointer.
+        std::mutex sinkMutex;
+        std::shared_ptr<const SinkList> sinks;
+        std::atomic<bool> hasSinks{false};
+
+        std::shared_ptr<const SinkList> sinkSnapshot() {
+            std::lock_guard lock(sinkMutex);
+            return sinks;
+        }
+
+        void flushSinks() {
+            if (!hasSinks.load(std::memory_order_acquire)) {
+                return;
+            }
+            if (auto list = sinkSnapshot()) {
+                for (const auto &entry : *list) {
+                    if (entry->queue) {
+                        entry->queue->flush();
+                    }
+                    entry->sink->flush();
+                }
+            }
+        }
+
+        std::shared_ptr<const CompiledLogRules> rulesSnapshot() {
+            std::lock_guard lock(rulesMutex);
+            return rules;
+        }
+
+        /// Evaluates a newly registered \a category, again if a change lands meanwhile. A change
+        /// that lands after the last check finds the category in the set and stores after it.
+        void evaluate(LogCategory *category) {
+            for (;;) {
+                auto seen = generation.load();
+                categoryFilter.load()(category);
+                if (generation.load() == seen) {
+                    return;
+                }
+            }
+        }
+
+        /// Re-evaluates every category once a change is in place. Called with updateMutex held.
         void updateFilterRules() {
+            generation.fetch_add(1);
+            auto filter = categoryFilter.load();
+            auto compiled = rulesSnapshot();
+
+            std::shared_lock lock(mutex);
             for (const auto &category : categories) {
-                categoryFilter(category);
+                if (filter == defaultLogCategoryFilter) {
+                    const char *name = category->name();
+                    category->setLevelMask(compiled->levelMask(name ? name : ""));
+                } else {
+                    filter(category);
+                }
             }
         }
 
@@ -211,30 +414,113 @@ namespace stdc {
     }
 
     static void defaultLogCategoryFilter(LogCategory *category) {
-        // The registry calls this with its lock held, so LogRegistry::rules is read without
-        // taking it again.
-        auto &reg = *LogRegistry::instance();
-        std::string_view name = category->name() ? category->name() : "";
+        // The rules apply in order over an all-enabled baseline, and the result is stored in one
+        // go, so a logging thread sees the old levels or the new ones and nothing in between.
+        const char *name = category->name();
+        category->setLevelMask(
+            LogRegistry::instance()->rulesSnapshot()->levelMask(name ? name : ""));
+    }
 
-        // Start from the constructor's all-enabled baseline and apply the rules in order, so a
-        // later match overrides an earlier one.
-        for (int level = Logger::Trace; level <= Logger::Fatal; ++level) {
-            category->setLevelEnabled(level, true);
+    void deliverLogRecords(const array_view<LogRecord> &records) {
+        for (const auto &record : records) {
+            if (record.fields.empty()) {
+                LogRegistry::callback(record.level, record.context, record.message);
+                continue;
+            }
+            // The callback takes text only, so the fields go along as text.
+            std::string text(record.message);
+            LogField::appendTo(text, record.fields);
+            LogRegistry::callback(record.level, record.context, text);
+        }
+
+        auto &reg = *LogRegistry::instance();
+        if (!reg.hasSinks.load(std::memory_order_acquire)) {
+            return;
         }
-        for (const auto &rule : reg.rules) {
-            if (!rule.matchesCategory(name)) {
+        auto list = reg.sinkSnapshot();
+        if (!list) {
+            return;
+        }
+        for (const auto &entry : *list) {
+            auto &sink = *entry->sink;
+            if (entry->queue) {
+                for (const auto &record : records) {
+                    if (!sink.accepts(record.level, record.context.category)) {
+                        continue;
+                    }
+                    // Not queued only if the queue has stopped since the snapshot was taken, or
+                    // the record comes from the sink's own thread.
+                    if (!entry->queue->push(record.level, record.context, record.message,
+                                            nullptr, {}, record.fields)) {
+                        sink.write(record);
+                    }
+                }
                 continue;
             }
-            for (int level = Logger::Trace; level <= Logger::Fatal; ++level) {
-                if (rule.appliesToLevel(level)) {
-                    category->setLevelEnabled(level, rule.enable);
+
+            bool all = true;
+            for (const auto &record : records) {
+                all = all && sink.accepts(record.level, record.context.category);
+            }
+            if (all) {
+                sink.writeBatch(records);
+                continue;
+            }
+            for (const auto &record : records) {
+                if (sink.accepts(record.level, record.context.category)) {
+                    sink.write(record);
                 }
             }
         }
     }
 
-    void Logger::print(int level, const std::string_view &message) {
-        LogRegistry::callback(level, _context, message);
+    void deliverLogRecord(int level, const LogContext &context, const std::string_view &message,
+                          const array_view<LogField> &fields) {
+        LogRecord record;
+        record.level = level;
+        record.context = context;
+        record.message = message;
+        record.fields = fields;
+        deliverLogRecords(record);
+    }
+
+    void Logger::print(int level, const std::string_view &message,
+                       const array_view<LogField> &fields) {
+        _context.time = timestamp();
+        _context.thread = currentThreadId();
+        if (isFlightRecording()) {
+            flightRecord(level, _context, message);
+        }
+
+        auto &writer = AsyncLogWriter::instance();
+        if (level >= Fatal) {
+            // The process is about to go, and the writer thread with it, so whatever is queued
+            // goes out first and this one is not left to the writer at all. The same goes for
+            // the sinks with queues of their own, and for whatever a sink buffers.
+            writer.flush();
+            deliverLogRecord(level, _context, message, fields);
+            LogRegistry::instance()->flushSinks();
+            return;
+        }
+        if (writer.push(level, _context, message, nullptr, {}, fields)) {
+            return;
+        }
+        deliverLogRecord(level, _context, message, fields);
+    }
+
+    void Logger::printDeferred(int level, const std::string_view &format, LogFormatter formatter,
+                               const std::string_view &payload) {
+        _context.time = timestamp();
+        _context.thread = currentThreadId();
+        if (isFlightRecording()) {
+            // The recorder keeps text, so this one record is formatted here after all.
+            flightRecord(level, _context, formatter(format, payload));
+        }
+
+        if (!AsyncLogWriter::instance().push(level, _context, format, formatter, payload)) {
+            // Stopped since the caller looked, or called from inside the sink.
+            deliverLogRecord(level, _context, formatter(format, payload));
+        }
     }
 
     void Logger::printf(int level, const char *fmt, ...) {
@@ -242,11 +528,94 @@ namespace stdc {
         va_start(args, fmt);
         std::string message = stdc::vasprintf(fmt, args);
         va_end(args);
-        LogRegistry::callback(level, _context, message);
+        print(level, message);
+    }
+
+    // logfmt quoting: a string goes bare unless it is empty or has a space, a quote, an equals
+    // sign or a control character in it.
+    static void appendFieldString(std::string &out, const std::string_view &s) {
+        bool bare = !s.empty() && std::none_of(s.begin(), s.end(), [](char c) {
+            return c == ' ' || c == '"' || c == '=' || c == '\\' || (unsigned char) c < 0x20;
+        });
+        if (bare) {
+            out.append(s);
+            return;
+        }
+        out.push_back('"');
+        for (char c : s) {
+            switch (c) {
+                case '"':
+                case '\\':
+                    out.push_back('\\');
+                    out.push_back(c);
+                    break;
+                case '\n':
+                    out.append("\\n");
+                    break;
+                case '\t':
+                    out.append("\\t");
+                    break;
+                default:
+                    out.push_back(c);
+                    break;
+            }
+        }
+        out.push_back('"');
+    }
+
+    void LogField::appendTo(std::string &out, const array_view<LogField> &fields) {
+        for (const auto &field : fields) {
+            out.push_back(' ');
+            out.append(field.key);
+            out.push_back('=');
+            switch (field.type) {
+                case Bool:
+                    out.append(field.b ? "true" : "false");
+                    break;
+                case Int:
+                    str::append_to(out, field.i);
+                    break;
+                case UInt:
+                    str::append_to(out, field.u);
+                    break;
+                case Double:
+                    str::append_to(out, field.d);
+                    break;
+                default:
+                    appendFieldString(out, field.s);
+                    break;
+            }
+        }
+    }
+
+    const char *Logger::levelName(int level) {
+        switch (level) {
+            case Trace:
+                return "trace";
+            case Debug:
+                return "debug";
+            case Success:
+                return "success";
+            case Information:
+                return "info";
+            case Warning:
+                return "warning";
+            case Critical:
+                return "critical";
+            case Fatal:
+                return "fatal";
+            default:
+                return "unknown";
+        }
     }
 
     // https://github.com/qt/qtbase/blob/v6.8.0/src/corelib/global/qassert.cpp#L25
     void Logger::abort() {
+        // Callers other than fatal() may not have flushed, and nothing queued survives what
+        // follows.
+        AsyncLogWriter::instance().flush();
+        dumpFlightRecorderOnce();
+
 #ifdef _WIN32
         // std::abort() is not dependable here. The MSVC runtime routes it through _exit(3) when
         // the abort behavior is _WRITE_ABORT_MSG, which a debug build defaults to, and MinGW's
@@ -276,13 +645,167 @@ namespace stdc {
         LogRegistry::callback = callback ? callback : defaultLogCallback;
     }
 
-    LogCategory::LogCategory(const char *name) : _name(name) {
-        enabled = 0x0101010101010101ULL;
+    bool Logger::startAsync(size_t capacity, OverflowPolicy policy) {
+        return AsyncLogWriter::instance().start(capacity, policy);
+    }
+
+    void Logger::stopAsync() {
+        AsyncLogWriter::instance().stop();
+    }
+
+    bool Logger::isAsync() {
+        return AsyncLogWriter::instance().running();
+    }
+
+    void Logger::flush() {
+        AsyncLogWriter::instance().flush();
+        LogRegistry::instance()->flushSinks();
+    }
+
+    uint64_t Logger::droppedCount() {
+        return AsyncLogWriter::instance().dropped();
+    }
 
+    static bool addSinkEntry(std::shared_ptr<LogSink> sink, std::unique_ptr<AsyncLogWriter> queue) {
+        if (!sink) {
+            return false;
+        }
         auto &reg = *LogRegistry::instance();
-        std::unique_lock lock(reg.mutex);
-        reg.categories.insert(this);
-        reg.categoryFilter(this); // rules already in effect apply to the new category
+        std::lock_guard lock(reg.sinkMutex);
+        auto list = reg.sinks ? std::make_shared<LogRegistry::SinkList>(*reg.sinks)
+                              : std::make_shared<LogRegistry::SinkList>();
+        for (const auto &entry : *list) {
+            if (entry->sink == sink) {
+                return false;
+            }
+        }
+        auto entry = std::make_shared<LogRegistry::SinkEntry>();
+        entry->sink = std::move(sink);
+        entry->queue = std::move(queue);
+        list->push_back(std::move(entry));
+        reg.sinks = std::move(list);
+        reg.hasSinks.store(true, std::memory_order_release);
+        return true;
+    }
+
+    bool Logger::addSink(std::shared_ptr<LogSink> sink) {
+        return addSinkEntry(std::move(sink), nullptr);
+    }
+
+    bool Logger::addSink(std::shared_ptr<LogSink> sink, size_t capacity, OverflowPolicy policy) {
+        if (!sink) {
+            return false;
+        }
+        // The queue holds its own reference, so that the sink outlives every batch in flight
+        // even after removeSink() has dropped the entry.
+        auto queue = std::make_unique<AsyncLogWriter>(
+            [sink](const array_view<LogRecord> &records) { sink->writeBatch(records); });
+        queue->start(capacity, policy);
+        return addSinkEntry(std::move(sink), std::move(queue));
+    }
+
+    namespace {
+
+        class FunctionLogSink : public LogSink {
+        public:
+            explicit FunctionLogSink(std::function<void(const LogRecord &)> func)
+                : _func(std::move(func)) {
+            }
+
+            void write(const LogRecord &record) override {
+                _func(record);
+            }
+
+        private:
+            std::function<void(const LogRecord &)> _func;
+        };
+
+    }
+
+    std::shared_ptr<LogSink> Logger::addSink(std::function<void(const LogRecord &)> func,
+                                             int minimumLevel) {
+        if (!func) {
+            return nullptr;
+        }
+        auto sink = std::make_shared<FunctionLogSink>(std::move(func));
+        sink->setMinimumLevel(minimumLevel);
+        addSinkEntry(sink, nullptr);
+        return sink;
+    }
+
+    bool Logger::removeSink(const std::shared_ptr<LogSink> &sink) {
+        auto &reg = *LogRegistry::instance();
+        std::shared_ptr<LogRegistry::SinkEntry> removed;
+        {
+            std::lock_guard lock(reg.sinkMutex);
+            if (!reg.sinks) {
+                return false;
+            }
+            auto list = std::make_shared<LogRegistry::SinkList>(*reg.sinks);
+            auto it = std::find_if(list->begin(), list->end(),
+                                   [&](const auto &entry) { return entry->sink == sink; });
+            if (it == list->end()) {
+                return false;
+            }
+            removed = *it;
+            list->erase(it);
+            reg.hasSinks.store(!list->empty(), std::memory_order_release);
+            reg.sinks = std::move(list);
+        }
+
+        // Outside the lock, since draining calls into the sink, which may well log.
+        if (removed->queue) {
+            removed->queue->stop();
+        }
+        removed->sink->flush();
+        return true;
+    }
+
+    LogSink::LogSink() = default;
+
+    LogSink::~LogSink() = default;
+
+    void LogSink::writeBatch(const array_view<LogRecord> &records) {
+        for (const auto &record : records) {
+            write(record);
+        }
+    }
+
+    void LogSink::flush() {
+    }
+
+    void LogSink::setCategoryFilter(std::string pattern) {
+        LoggingRule rule;
+        if (pattern.empty() || !parseCategoryPattern(pattern, rule)) {
+            // Nothing to match against, which takes every category rather than none.
+            _categoryFilter.clear();
+            _matchText.clear();
+            _matchMode = 0;
+            return;
+        }
+        _categoryFilter = std::move(pattern);
+        _matchMode = rule.mode;
+        _matchText = std::move(rule.text);
+    }
+
+    bool LogSink::accepts(int level, const char *category) const {
+        if (level < _minimumLevel) {
+            return false;
+        }
+        if (_categoryFilter.empty()) {
+            return true;
+        }
+        return LoggingRule::matches(LoggingRule::MatchMode(_matchMode), _matchText,
+                                    category ? category : "");
+    }
+
+    LogCategory::LogCategory(const char *name) : _name(name) {
+        auto &reg = *LogRegistry::instance();
+        {
+            std::unique_lock lock(reg.mutex);
+            reg.categories.insert(this);
+        }
+        reg.evaluate(this); // rules already in effect apply to the new category
     }
 
     LogCategory::~LogCategory() {
@@ -292,33 +815,36 @@ namespace stdc {
     }
 
     LogCategory::LogCategoryFilter LogCategory::logFilter() {
-        auto &reg = *LogRegistry::instance();
-        std::shared_lock lock(reg.mutex);
-        return LogRegistry::categoryFilter;
+        return LogRegistry::categoryFilter.load();
     }
 
     void LogCategory::setLogFilter(LogCategoryFilter filter) {
         auto &reg = *LogRegistry::instance();
-        std::unique_lock lock(reg.mutex);
+        std::lock_guard update(reg.updateMutex);
 
         if (!filter)
             filter = defaultLogCategoryFilter;
 
-        LogRegistry::categoryFilter = filter;
+        LogRegistry::categoryFilter.store(filter);
         reg.updateFilterRules();
     }
 
     std::string LogCategory::filterRules() {
         auto &reg = *LogRegistry::instance();
-        std::shared_lock lock(reg.mutex);
+        std::lock_guard lock(reg.rulesMutex);
         return reg.filterRules;
     }
 
     void LogCategory::setFilterRules(std::string rules) {
+        auto compiled = std::make_shared<const CompiledLogRules>(parseRules(rules));
+
         auto &reg = *LogRegistry::instance();
-        std::unique_lock lock(reg.mutex);
-        reg.rules = parseRules(rules);
-        reg.filterRules = std::move(rules);
+        std::lock_guard update(reg.updateMutex);
+        {
+            std::lock_guard lock(reg.rulesMutex);
+            reg.rules = std::move(compiled);
+            reg.filterRules = std::move(rules);
+        }
         reg.updateFilterRules();
     }
 
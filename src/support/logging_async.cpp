@@ -0,0 +1,378 @@
+// SPDX-License-Identifier: MIT
+
+#include "logging.h"
+#include "logging_p.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace stdc {
+
+    LogRing::LogRing(size_t capacity) {
+        size_t n = 2;
+        while (n < capacity) {
+            n <<= 1;
+        }
+        _slots = new Slot[n];
+        _mask = n - 1;
+        for (size_t i = 0; i < n; ++i) {
+            _slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    LogRing::~LogRing() {
+        delete[] _slots;
+    }
+
+    LogRing::Slot *LogRing::tryClaim() {
+        size_t pos = _enqueuePos.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot *slot = &_slots[pos & _mask];
+            size_t seq = slot->sequence.load(std::memory_order_acquire);
+            auto diff = intptr_t(seq) - intptr_t(pos);
+            if (diff == 0) {
+                if (_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    slot->position = pos;
+                    return slot;
+                }
+            } else if (diff < 0) {
+                return nullptr; // still holds the record from one lap ago
+            } else {
+                pos = _enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    void LogRing::publish(Slot *slot) {
+        slot->sequence.store(slot->position + 1, std::memory_order_release);
+    }
+
+    LogRing::Slot *LogRing::tryTake() {
+        size_t pos = _dequeuePos.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot *slot = &_slots[pos & _mask];
+            size_t seq = slot->sequence.load(std::memory_order_acquire);
+            auto diff = intptr_t(seq) - intptr_t(pos + 1);
+            if (diff == 0) {
+                if (_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    slot->position = pos;
+                    return slot;
+                }
+            } else if (diff < 0) {
+                return nullptr; // empty, or the producer has not published yet
+            } else {
+                pos = _dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    void LogRing::release(Slot *slot) {
+        slot->sequence.store(slot->position + _mask + 1, std::memory_order_release);
+    }
+
+    // Nobody who is waiting should rely on a notification alone. The flags that say whether
+    // anybody is waiting are checked without the lock, which leaves a window, so every wait
+    // below is also bounded and re-checks its condition when it times out.
+    static constexpr auto MaxSleep = std::chrono::milliseconds(10);
+
+    // Each field is its type, its key, and its value, a string as its length and its bytes and
+    // anything else as the bytes of the scalar. Only ever read back by the same process, so
+    // nothing here worries about byte order.
+    template <class T>
+    static void appendRaw(std::string &out, const T &value) {
+        out.append(reinterpret_cast<const char *>(&value), sizeof(T));
+    }
+
+    template <class T>
+    static T readRaw(const char *&p) {
+        T value;
+        std::memcpy(&value, p, sizeof(T));
+        p += sizeof(T);
+        return value;
+    }
+
+    static void appendString(std::string &out, const std::string_view &s) {
+        appendRaw(out, s.size());
+        out.append(s.data(), s.size());
+    }
+
+    static std::string_view readString(const char *&p) {
+        auto size = readRaw<size_t>(p);
+        std::string_view s(p, size);
+        p += size;
+        return s;
+    }
+
+    void encodeLogFields(std::string &out, const array_view<LogField> &fields) {
+        for (const auto &field : fields) {
+            out.push_back(char(field.type));
+            appendString(out, field.key);
+            if (field.type == LogField::String) {
+                appendString(out, field.s);
+            } else {
+                appendRaw(out, field.u); // the widest member, whichever one is live
+            }
+        }
+    }
+
+    void decodeLogFields(const std::string &data, std::vector<LogField> &out) {
+        const char *p = data.data();
+        const char *end = p + data.size();
+        while (p < end) {
+            auto type = LogField::Type(*p++);
+            auto key = readString(p);
+            if (type == LogField::String) {
+                out.emplace_back(key, readString(p));
+                continue;
+            }
+            LogField field(key, readRaw<uint64_t>(p));
+            field.type = type;
+            out.push_back(field);
+        }
+    }
+
+    AsyncLogWriter::AsyncLogWriter(Deliver deliver) : _deliver(std::move(deliver)) {
+    }
+
+    AsyncLogWriter &AsyncLogWriter::instance() {
+        static AsyncLogWriter writer(deliverLogRecords);
+        return writer;
+    }
+
+    AsyncLogWriter::~AsyncLogWriter() {
+        // A thread still joinable at destruction takes the process down with it, and whatever
+        // is left in the ring would be lost besides.
+        stop();
+    }
+
+    bool AsyncLogWriter::start(size_t capacity, Logger::OverflowPolicy policy) {
+        std::lock_guard lock(_controlMutex);
+        if (_running.load(std::memory_order_relaxed)) {
+            return false;
+        }
+        _ring = std::make_unique<LogRing>(std::max<size_t>(capacity, 2));
+        _policy = policy;
+        _stopping.store(false, std::memory_order_relaxed);
+        _dropped.store(0, std::memory_order_relaxed);
+        _done.store(0, std::memory_order_relaxed);
+        _writer = std::thread([this]() { run(); });
+        _running.store(true, std::memory_order_seq_cst);
+        return true;
+    }
+
+    void AsyncLogWriter::stop() {
+        std::lock_guard lock(_controlMutex);
+        if (!_running.load(std::memory_order_relaxed)) {
+            return;
+        }
+
+        // New records go the synchronous way from here on. One already past the check in push()
+        // may still be writing its slot, or waiting for room, so the writer keeps draining until
+        // those have all come through.
+        _running.store(false, std::memory_order_seq_cst);
+        while (_inflight.load(std::memory_order_seq_cst) > 0) {
+            std::this_thread::yield();
+        }
+
+        _stopping.store(true, std::memory_order_seq_cst);
+        {
+            std::lock_guard wakeLock(_wakeMutex);
+            _wakeCv.notify_one();
+        }
+        _writer.join();
+        _writerId.store({}, std::memory_order_relaxed);
+        notifyProgress();
+    }
+
+    bool AsyncLogWriter::push(int level, const LogContext &context,
+                              const std::string_view &message, Logger::LogFormatter formatter,
+                              const std::string_view &payload,
+                              const array_view<LogField> &fields) {
+        if (!_running.load(std::memory_order_relaxed) || onWriterThread()) {
+            // A sink that logs would otherwise queue behind itself, and wait forever for room
+            // under Block, so its records are delivered on the spot.
+            return false;
+        }
+
+        // Counted in before the second look at _running, so that stop() either sees this
+        // producer or this producer sees stop().
+        _inflight.fetch_add(1, std::memory_order_seq_cst);
+        if (!_running.load(std::memory_order_seq_cst)) {
+            _inflight.fetch_sub(1, std::memory_order_release);
+            return false;
+        }
+
+        LogRing::Slot *slot;
+        while (!(slot = _ring->tryClaim())) {
+            switch (_policy) {
+                case Logger::DropNewest:
+                    _dropped.fetch_add(1, std::memory_order_relaxed);
+                    _inflight.fetch_sub(1, std::memory_order_release);
+                    return true;
+
+                case Logger::DropOldest:
+                    if (auto oldest = _ring->tryTake()) {
+                        _ring->release(oldest);
+                        _dropped.fetch_add(1, std::memory_order_relaxed);
+                        _done.fetch_add(1, std::memory_order_release);
+                    } else {
+                        // The oldest slot is claimed but not yet written, or the writer has just
+                        // taken it. Either way a slot is about to come free.
+                        std::this_thread::yield();
+                    }
+                    break;
+
+                default: {
+                    wakeWriter();
+                    std::unique_lock progressLock(_progressMutex);
+                    _progressWaiters.fetch_add(1, std::memory_order_seq_cst);
+                    _progressCv.wait_for(progressLock, MaxSleep);
+                    _progressWaiters.fetch_sub(1, std::memory_order_relaxed);
+                    break;
+                }
+            }
+        }
+
+        slot->level = level;
+        slot->context = context;
+        slot->hasCategory = context.category != nullptr;
+        slot->category.assign(slot->hasCategory ? context.category : "");
+        slot->message.assign(message.data(), message.size());
+        slot->formatter = formatter;
+        if (formatter) {
+            slot->payload.assign(payload.data(), payload.size());
+        }
+        slot->fields.clear();
+        if (!fields.empty()) {
+            encodeLogFields(slot->fields, fields);
+        }
+        _ring->publish(slot);
+
+        _inflight.fetch_sub(1, std::memory_order_release);
+        wakeWriter();
+        return true;
+    }
+
+    void AsyncLogWriter::flush() {
+        if (!_running.load(std::memory_order_acquire) || onWriterThread()) {
+            return;
+        }
+
+        size_t target = _ring->claimed();
+        while (_done.load(std::memory_order_acquire) < target) {
+            wakeWriter();
+            std::unique_lock progressLock(_progressMutex);
+            _progressWaiters.fetch_add(1, std::memory_order_seq_cst);
+            _progressCv.wait_for(progressLock, MaxSleep,
+                                 [&]() { return _done.load(std::memory_order_acquire) >= target; });
+            _progressWaiters.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+
+    void AsyncLogWriter::run() {
+        _writerId.store(std::this_thread::get_id(), std::memory_order_relaxed);
+
+        for (;;) {
+            if (drain() > 0) {
+                continue;
+            }
+
+            // Everything claimed has been taken and the producers are all gone, so there is
+            // nothing left to wait for.
+            if (_stopping.load(std::memory_order_acquire) &&
+                _done.load(std::memory_order_acquire) == _ring->claimed()) {
+                break;
+            }
+
+            // Says it is going to sleep before the last look at the ring, and the producer
+            // publishes before it looks at the flag, so at least one of the two sees the other.
+            std::unique_lock wakeLock(_wakeMutex);
+            _writerIdle.store(true, std::memory_order_seq_cst);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (_done.load(std::memory_order_acquire) == _ring->claimed() &&
+                !_stopping.load(std::memory_order_acquire)) {
+                _wakeCv.wait_for(wakeLock, MaxSleep);
+            }
+            _writerIdle.store(false, std::memory_order_relaxed);
+        }
+    }
+
+    size_t AsyncLogWriter::drain() {
+        // Waiters hear about progress once a batch rather than once a record, but not so rarely
+        // that a producer blocked on a full ring waits for the whole of it to empty.
+        const size_t batch = std::clamp<size_t>(_ring->capacity() / 2, 1, 64);
+        if (_taken.size() < batch) {
+            _taken.resize(batch);
+        }
+
+        // The strings are swapped out rather than delivered in place, so every slot goes back to
+        // the producers before the sink is called. A sink that stalls then holds up nothing but
+        // itself, and the ring keeps its full capacity. The buffers swapped in are the ones an
+        // earlier record left behind, so neither side allocates once they have grown.
+        size_t count = 0;
+        while (count < batch) {
+            LogRing::Slot *slot = _ring->tryTake();
+            if (!slot) {
+                break;
+            }
+            auto &taken = _taken[count];
+            taken.level = slot->level;
+            taken.context = slot->context;
+            taken.hasCategory = slot->hasCategory;
+            taken.formatter = slot->formatter;
+            taken.category.swap(slot->category);
+            taken.message.swap(slot->message);
+            if (taken.formatter) {
+                taken.payload.swap(slot->payload);
+            }
+            taken.fieldData.swap(slot->fields);
+            _ring->release(slot);
+            ++count;
+        }
+        if (count == 0) {
+            return 0;
+        }
+
+        _batch.clear();
+        for (size_t i = 0; i < count; ++i) {
+            auto &taken = _taken[i];
+            if (taken.formatter) {
+                taken.message = taken.formatter(taken.message, taken.payload);
+            }
+            LogRecord record;
+            record.level = taken.level;
+            record.context = taken.context;
+            record.context.category = taken.hasCategory ? taken.category.c_str() : nullptr;
+            record.message = taken.message;
+            taken.fields.clear();
+            if (!taken.fieldData.empty()) {
+                decodeLogFields(taken.fieldData, taken.fields);
+                record.fields = taken.fields;
+            }
+            _batch.push_back(record);
+        }
+        _deliver(_batch);
+
+        _done.fetch_add(count, std::memory_order_release);
+        notifyProgress();
+        return count;
+    }
+
+    void AsyncLogWriter::wakeWriter() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (_writerIdle.load(std::memory_order_seq_cst)) {
+            std::lock_guard wakeLock(_wakeMutex);
+            _wakeCv.notify_one();
+        }
+    }
+
+    void AsyncLogWriter::notifyProgress() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (_progressWaiters.load(std::memory_order_seq_cst) > 0) {
+            std::lock_guard progressLock(_progressMutex);
+            _progressCv.notify_all();
+        }
+    }
+
+}
@@ -0,0 +1,491 @@
+// SPDX-License-Identifier: MIT
+
+#include "logging.h"
+#include "logging_p.h"
+#include "vla.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <iterator>
+#include <new>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#  include <io.h>
+#else
+#  include <unistd.h>
+#endif
+
+namespace stdc {
+
+    std::atomic<bool> Logger::_flightRecording{false};
+
+    namespace {
+
+        // One record as the ring keeps it: this, then the category, then as much of the message
+        // as fits in the rest of the slot.
+        struct FlightSlot {
+            // Zero while the owner is writing the slot, and one past the record's index after, so
+            // a dump running on another thread can tell a record it caught half written, or one
+            // from a later lap, and leave it out.
+            std::atomic<uint64_t> sequence;
+            int64_t time;
+            uint64_t thread;
+            int32_t level;
+            uint16_t categorySize;
+            bool truncated;
+            uint32_t messageSize;
+
+            char *text() {
+                return reinterpret_cast<char *>(this + 1);
+            }
+        };
+
+        // One thread's records. A ring outlives its thread, since what a thread logged just
+        // before it went is often the interesting part, and goes to the next thread that starts
+        // while it is free.
+        struct FlightRing {
+            FlightRing *next = nullptr; // in g_rings, which nothing is ever taken out of
+            uint64_t generation = 0;
+            size_t slotCount = 0;
+            size_t slotSize = 0;
+            char *slots = nullptr;
+
+            std::atomic<bool> owned{true};
+            std::atomic<uint64_t> written{0};
+
+            // Where the dump has got to, which only the dump touches.
+            uint64_t cursor = 0;
+            uint64_t end = 0;
+
+            FlightSlot *slot(uint64_t index) {
+                return reinterpret_cast<FlightSlot *>(slots + (index % slotCount) * slotSize);
+            }
+        };
+
+        std::atomic<FlightRing *> g_rings{nullptr};
+
+        // Rings are made with the sizes of the generation they belong to, and a start with other
+        // sizes moves on to a new one.
+        std::atomic<uint64_t> g_generation{0};
+        size_t g_slotCount = 0;
+        size_t g_slotSize = 0;
+
+        // Plain storage rather than a std::string, for the signal handler to read.
+        char g_dumpPath[1024] = {};
+        std::atomic<bool> g_dumped{false};
+        std::atomic<bool> g_dumping{false};
+
+        // Hands the ring back when its thread ends.
+        struct RingHolder {
+            FlightRing *ring = nullptr;
+
+            ~RingHolder() {
+                if (ring) {
+                    ring->owned.store(false, std::memory_order_release);
+                }
+            }
+        };
+
+        thread_local RingHolder t_ring;
+
+        FlightRing *acquireRing(uint64_t generation) {
+            if (t_ring.ring) {
+                t_ring.ring->owned.store(false, std::memory_order_release);
+                t_ring.ring = nullptr;
+            }
+            for (auto ring = g_rings.load(std::memory_order_acquire); ring; ring = ring->next) {
+                bool free = false;
+                if (ring->generation == generation &&
+                    ring->owned.compare_exchange_strong(free, true, std::memory_order_acquire)) {
+                    t_ring.ring = ring;
+                    return ring;
+                }
+            }
+
+            auto ring = new FlightRing();
+            ring->generation = generation;
+            ring->slotCount = g_slotCount;
+            ring->slotSize = g_slotSize;
+            ring->slots = new char[g_slotCount * g_slotSize]();
+            for (size_t i = 0; i < g_slotCount; ++i) {
+                new (ring->slot(i)) FlightSlot();
+            }
+            ring->next = g_rings.load(std::memory_order_relaxed);
+            while (!g_rings.compare_exchange_weak(ring->next, ring, std::memory_order_release,
+                                                  std::memory_order_relaxed)) {
+            }
+            t_ring.ring = ring;
+            return ring;
+        }
+
+        void keep(int level, const LogContext &context, const std::string_view &message) {
+            auto generation = g_generation.load(std::memory_order_acquire);
+            FlightRing *ring = t_ring.ring;
+            if (!ring || ring->generation != generation) {
+                ring = acquireRing(generation);
+            }
+
+            uint64_t index = ring->written.load(std::memory_order_relaxed);
+            FlightSlot *slot = ring->slot(index);
+            slot->sequence.store(0, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+
+            size_t room = ring->slotSize - sizeof(FlightSlot);
+            size_t categorySize =
+                context.category ? std::min(std::strlen(context.category), room / 4) : 0;
+            size_t messageSize = std::min(message.size(), room - categorySize);
+            slot->time = context.time;
+            slot->thread = context.thread;
+            slot->level = level;
+            slot->categorySize = uint16_t(categorySize);
+            slot->truncated = messageSize < message.size();
+            slot->messageSize = uint32_t(messageSize);
+            std::memcpy(slot->text(), context.category, categorySize);
+            std::memcpy(slot->text() + categorySize, message.data(), messageSize);
+
+            slot->sequence.store(index + 1, std::memory_order_release);
+            ring->written.store(index + 1, std::memory_order_release);
+        }
+
+        // What follows runs in a signal handler, so it keeps to write(2) and arithmetic.
+
+        int openDump() {
+            if (!g_dumpPath[0]) {
+                return 2;
+            }
+#ifdef _WIN32
+            return ::_open(g_dumpPath, _O_WRONLY | _O_CREAT | _O_APPEND | _O_BINARY,
+                           _S_IREAD | _S_IWRITE);
+#else
+            return ::open(g_dumpPath, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+#endif
+        }
+
+        void closeDump(int fd) {
+            if (fd == 2) {
+                return;
+            }
+#ifdef _WIN32
+            ::_close(fd);
+#else
+            ::close(fd);
+#endif
+        }
+
+        void writeOut(int fd, const char *data, size_t size) {
+            while (size > 0) {
+#ifdef _WIN32
+                auto n = ::_write(fd, data, unsigned(size));
+#else
+                auto n = ::write(fd, data, size);
+#endif
+                if (n <= 0) {
+#ifndef _WIN32
+                    if (n < 0 && errno == EINTR) {
+                        continue;
+                    }
+#endif
+                    return;
+                }
+                data += n;
+                size -= size_t(n);
+            }
+        }
+
+        char *putNumber(char *p, uint64_t value, int width = 0) {
+            char digits[20];
+            int n = 0;
+            do {
+                digits[n++] = char('0' + value % 10);
+                value /= 10;
+            } while (value > 0);
+            for (; n < width; --width) {
+                *p++ = '0';
+            }
+            while (n > 0) {
+                *p++ = digits[--n];
+            }
+            return p;
+        }
+
+        // gmtime_r() is not on the list of async-signal-safe functions, so the date is worked out
+        // by hand, after Howard Hinnant's civil_from_days().
+        // https://howardhinnant.github.io/date_algorithms.html#civil_from_days
+        char *putTime(char *p, int64_t time) {
+            int64_t secs = time / 1000000000;
+            int64_t nanos = time % 1000000000;
+            if (nanos < 0) {
+                nanos += 1000000000;
+                --secs;
+            }
+            int64_t days = secs / 86400;
+            int64_t rem = secs % 86400;
+            if (rem < 0) {
+                rem += 86400;
+                --days;
+            }
+
+            int64_t z = days + 719468;
+            int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+            int64_t doe = z - era * 146097;
+            int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+            int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+            int64_t mp = (5 * doy + 2) / 153;
+            int64_t day = doy - (153 * mp + 2) / 5 + 1;
+            int64_t month = mp < 10 ? mp + 3 : mp - 9;
+            int64_t year = yoe + era * 400 + (month <= 2 ? 1 : 0);
+
+            p = putNumber(p, uint64_t(year), 4);
+            *p++ = '-';
+            p = putNumber(p, uint64_t(month), 2);
+            *p++ = '-';
+            p = putNumber(p, uint64_t(day), 2);
+            *p++ = ' ';
+            p = putNumber(p, uint64_t(rem / 3600), 2);
+            *p++ = ':';
+            p = putNumber(p, uint64_t(rem / 60 % 60), 2);
+            *p++ = ':';
+            p = putNumber(p, uint64_t(rem % 60), 2);
+            *p++ = '.';
+            return putNumber(p, uint64_t(nanos / 1000), 6);
+        }
+
+        // A record as the dump copied it out of its slot, with the text in the caller's buffer.
+        struct FlightRecord {
+            int64_t time;
+            uint64_t thread;
+            int32_t level;
+            size_t categorySize;
+            bool truncated;
+            size_t messageSize;
+        };
+
+        // Copies the record out, then looks at the sequence again: a writer that lapped the ring
+        // meanwhile may have torn the copy, half the old record and half its own, and then it is
+        // left out. \a text has room for a slot's text.
+        bool copyRecord(FlightSlot *slot, uint64_t sequence, size_t slotSize,
+                        FlightRecord &record, char *text) {
+            record.time = slot->time;
+            record.thread = slot->thread;
+            record.level = slot->level;
+            record.truncated = slot->truncated;
+
+            // Bounded by the slot, whatever a torn header says.
+            size_t room = slotSize - sizeof(FlightSlot);
+            record.categorySize = std::min<size_t>(slot->categorySize, room);
+            record.messageSize = std::min<size_t>(slot->messageSize, room - record.categorySize);
+            std::memcpy(text, slot->text(), record.categorySize + record.messageSize);
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            return slot->sequence.load(std::memory_order_acquire) == sequence;
+        }
+
+        void dumpRecord(int fd, const FlightRecord &record, const char *text) {
+            char head[96];
+            char *p = putTime(head, record.time);
+            *p++ = ' ';
+            *p++ = '[';
+            p = putNumber(p, record.thread);
+            *p++ = ']';
+            *p++ = ' ';
+            const char *level = Logger::levelName(record.level);
+            size_t levelSize = std::strlen(level);
+            std::memcpy(p, level, levelSize);
+            p += levelSize;
+            if (record.categorySize > 0) {
+                *p++ = ' ';
+            }
+            writeOut(fd, head, size_t(p - head));
+
+            writeOut(fd, text, record.categorySize);
+            writeOut(fd, ": ", 2);
+            writeOut(fd, text + record.categorySize, record.messageSize);
+            if (record.truncated) {
+                writeOut(fd, "...", 3);
+            }
+            writeOut(fd, "\n", 1);
+        }
+
+        // Oldest first across every ring: each ring is in order already, so the dump takes
+        // whichever ring's next record is the oldest, over and over, and needs no memory to sort.
+        void dumpRings(int fd) {
+            static const char header[] = "--- flight recorder: the last records, oldest first\n";
+            static const char footer[] = "--- flight recorder: end\n";
+            writeOut(fd, header, sizeof(header) - 1);
+
+            auto rings = g_rings.load(std::memory_order_acquire);
+            size_t textSize = 0;
+            for (auto ring = rings; ring; ring = ring->next) {
+                ring->end = ring->written.load(std::memory_order_acquire);
+                ring->cursor = ring->end > ring->slotCount ? ring->end - ring->slotCount : 0;
+                textSize = std::max(textSize, ring->slotSize - sizeof(FlightSlot));
+            }
+
+            // On the stack, since the heap is not to be touched here, and once for the whole
+            // dump. It is as large as the largest slot, which the options bound.
+            STDC_VLA_ALLOC(char, text, textSize + 1);
+            FlightRecord record;
+
+            for (;;) {
+                FlightRing *oldest = nullptr;
+                FlightSlot *oldestSlot = nullptr;
+                for (auto ring = rings; ring; ring = ring->next) {
+                    while (ring->cursor < ring->end) {
+                        auto slot = ring->slot(ring->cursor);
+                        if (slot->sequence.load(std::memory_order_acquire) == ring->cursor + 1) {
+                            if (!oldestSlot || slot->time < oldestSlot->time) {
+                                oldest = ring;
+                                oldestSlot = slot;
+                            }
+                            break;
+                        }
+                        ++ring->cursor; // written over since, or being written
+                    }
+                }
+                if (!oldest) {
+                    break;
+                }
+                if (copyRecord(oldestSlot, oldest->cursor + 1, oldest->slotSize, record, text)) {
+                    dumpRecord(fd, record, text);
+                }
+                ++oldest->cursor;
+            }
+            writeOut(fd, footer, sizeof(footer) - 1);
+        }
+
+        // The first of abort() and the crash handler to get here dumps, and the other does not,
+        // since abort() raising SIGABRT would otherwise dump the same records twice.
+        void dumpOnce() {
+            if (Logger::isFlightRecording() &&
+                !g_dumped.exchange(true, std::memory_order_acq_rel)) {
+                Logger::dumpFlightRecorder();
+            }
+        }
+
+        const int g_crashSignals[] = {SIGSEGV, SIGILL, SIGFPE, SIGABRT,
+#ifndef _WIN32
+                                      SIGBUS
+#endif
+        };
+
+        // Whatever handled each signal before, a crash reporter of the application's say, which
+        // still gets the signal once the dump is written.
+#ifdef _WIN32
+        using PreviousHandler = void (*)(int);
+#else
+        using PreviousHandler = struct sigaction;
+#endif
+        PreviousHandler g_previousHandlers[std::size(g_crashSignals)];
+        std::atomic<bool> g_crashHandlerInstalled{false};
+
+        void crashHandler(int sig) {
+            dumpOnce();
+            // Back to what was there before, and raised again, so that the signal goes on to it,
+            // or takes the process down the way it would have.
+            for (size_t i = 0; i < std::size(g_crashSignals); ++i) {
+                if (g_crashSignals[i] != sig) {
+                    continue;
+                }
+#ifdef _WIN32
+                std::signal(sig, g_previousHandlers[i]);
+#else
+                sigaction(sig, &g_previousHandlers[i], nullptr);
+#endif
+            }
+            std::raise(sig);
+        }
+
+        // Once, since a second time would take this handler for the one before it.
+        void installCrashHandler() {
+            if (g_crashHandlerInstalled.exchange(true)) {
+                return;
+            }
+            for (size_t i = 0; i < std::size(g_crashSignals); ++i) {
+                int sig = g_crashSignals[i];
+#ifdef _WIN32
+                g_previousHandlers[i] = std::signal(sig, crashHandler);
+                if (g_previousHandlers[i] == SIG_ERR) {
+                    g_previousHandlers[i] = SIG_DFL;
+                }
+#else
+                struct sigaction action{};
+                action.sa_handler = crashHandler;
+                action.sa_flags = SA_RESETHAND | SA_NODEFER;
+                sigemptyset(&action.sa_mask);
+                sigaction(sig, &action, &g_previousHandlers[i]);
+#endif
+            }
+        }
+
+    }
+
+    bool Logger::startFlightRecorder(const FlightRecorderOptions &options) {
+        size_t slotSize = std::max(options.slotSize, sizeof(FlightSlot) + 32);
+        slotSize = (slotSize + alignof(FlightSlot) - 1) / alignof(FlightSlot) * alignof(FlightSlot);
+        size_t slotCount = std::max<size_t>(options.slotsPerThread, 1);
+        if (options.dumpPath.size() >= sizeof(g_dumpPath)) {
+            return false;
+        }
+
+        _flightRecording.store(false, std::memory_order_relaxed);
+        if (slotSize != g_slotSize || slotCount != g_slotCount) {
+            g_slotSize = slotSize;
+            g_slotCount = slotCount;
+            g_generation.fetch_add(1, std::memory_order_release);
+        }
+        std::memcpy(g_dumpPath, options.dumpPath.c_str(), options.dumpPath.size() + 1);
+        g_dumped.store(false, std::memory_order_relaxed);
+        if (options.crashHandler) {
+            installCrashHandler();
+        }
+        _flightRecording.store(true, std::memory_order_release);
+        return true;
+    }
+
+    bool Logger::startFlightRecorder() {
+        return startFlightRecorder(FlightRecorderOptions());
+    }
+
+    void Logger::stopFlightRecorder() {
+        _flightRecording.store(false, std::memory_order_release);
+    }
+
+    void Logger::dumpFlightRecorder() {
+        // The cursors in the rings are the dump's, so one dump at a time. Waiting for the
+        // other is no option in a signal handler, which may have interrupted it on this very
+        // thread, so the second one does nothing.
+        if (g_dumping.exchange(true, std::memory_order_acquire)) {
+            return;
+        }
+        int fd = openDump();
+        if (fd >= 0) {
+            dumpRings(fd);
+            closeDump(fd);
+        }
+        g_dumping.store(false, std::memory_order_release);
+    }
+
+    void Logger::rememberText(int level, const std::string_view &message) {
+        if (!isFlightRecording()) {
+            return;
+        }
+        _context.time = timestamp();
+        _context.thread = currentThreadId();
+        keep(level, _context, message);
+    }
+
+    void flightRecord(int level, const LogContext &context, const std::string_view &message) {
+        keep(level, context, message);
+    }
+
+    void dumpFlightRecorderOnce() {
+        dumpOnce();
+    }
+
+}
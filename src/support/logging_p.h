@@ -0,0 +1,221 @@
+// SPDX-License-Identifier: MIT
+
+#ifndef STDCORELIB_LOGGING_P_H
+#define STDCORELIB_LOGGING_P_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <stdcorelib/support/logging.h>
+
+namespace stdc {
+
+    /// Hands records to the callback and to every sink that takes them. The async writer ends
+    /// here for every batch it takes off the ring.
+    STDC_DECL_HIDDEN void deliverLogRecords(const array_view<LogRecord> &records);
+
+    /// deliverLogRecords() for the one record, which is where the calling thread ends when
+    /// nothing is queueing.
+    STDC_DECL_HIDDEN void deliverLogRecord(int level, const LogContext &context,
+                                           const std::string_view &message,
+                                           const array_view<LogField> &fields = {});
+
+    /// Keeps a record in the calling thread's flight recorder ring. The caller has checked
+    /// Logger::isFlightRecording() and stamped the context.
+    STDC_DECL_HIDDEN void flightRecord(int level, const LogContext &context,
+                                       const std::string_view &message);
+
+    /// Logger::dumpFlightRecorder(), unless the crash handler or an earlier call got there first.
+    STDC_DECL_HIDDEN void dumpFlightRecorderOnce();
+
+    /// Packs \a fields into \a out, strings and all, for a record that has to outlive the call
+    /// that made it.
+    STDC_DECL_HIDDEN void encodeLogFields(std::string &out, const array_view<LogField> &fields);
+
+    /// Unpacks what encodeLogFields() wrote into \a out, with the views pointing into \a data.
+    STDC_DECL_HIDDEN void decodeLogFields(const std::string &data, std::vector<LogField> &out);
+
+    /// A bounded queue of log records, after Dmitry Vyukov's bounded MPMC queue.
+    ///
+    /// Each slot carries a sequence number that says whose turn it is: equal to the position, it
+    /// is free for the producer claiming that position, one past it, it holds a record for the
+    /// consumer at that position. Claiming a position is one compare and swap, and there is no
+    /// lock anywhere.
+    ///
+    /// More than one thread may take from it. The writer is the only consumer in the ordinary
+    /// sense, but a producer evicting the oldest record to make room takes one as well.
+    ///
+    /// \note The strings in a slot are assigned into, and the writer swaps them for its own
+    ///       rather than taking them, so once the ring has gone round a record costs no allocation
+    ///       unless it is longer than the buffer it lands in.
+    ///
+    /// https://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue
+    class LogRing {
+    public:
+        struct Slot {
+            std::atomic<size_t> sequence{0};
+            size_t position = 0; // the position it was claimed or taken at, for the release
+
+            int level = 0;
+            LogContext context;
+            // Copied rather than pointed at. A category can be destroyed before the writer gets
+            // round to the record, and the name goes with it.
+            std::string category;
+            bool hasCategory = false;
+            std::string message; // the format string, when there is a formatter
+
+            // Set when formatting was left to the writer, which runs it over the message and
+            // the arguments captured in the payload.
+            Logger::LogFormatter formatter = nullptr;
+            std::string payload;
+
+            // The fields, packed by encodeLogFields(), and empty when there are none.
+            std::string fields;
+        };
+
+        /// \param capacity rounded up to a power of two, and to at least two
+        explicit LogRing(size_t capacity);
+        ~LogRing();
+
+        size_t capacity() const {
+            return _mask + 1;
+        }
+
+        /// Claims the next free slot for writing, or returns null when the ring is full.
+        Slot *tryClaim();
+
+        /// Hands a claimed slot over to the consumer side.
+        void publish(Slot *slot);
+
+        /// Takes the oldest record, or returns null when there is none ready.
+        Slot *tryTake();
+
+        /// Gives a taken slot back to the producers.
+        void release(Slot *slot);
+
+        /// How many positions have been claimed so far. A record is only counted as done once
+        /// the slot it went into has been released, so flushing waits for the two to meet.
+        size_t claimed() const {
+            return _enqueuePos.load(std::memory_order_acquire);
+        }
+
+    private:
+        Slot *_slots;
+        size_t _mask;
+
+        // Apart, so that producers and the consumer do not share a cache line.
+        alignas(64) std::atomic<size_t> _enqueuePos{0};
+        alignas(64) std::atomic<size_t> _dequeuePos{0};
+
+        STDC_DISABLE_COPY_MOVE(LogRing)
+    };
+
+    /// A ring, and a thread draining it in batches into \a deliver.
+    ///
+    /// The one instance() returns is the backend Logger::startAsync() switches on, and delivers
+    /// to the callback and the sinks. A sink added with a queue of its own gets another, which
+    /// delivers to that sink alone.
+    class AsyncLogWriter {
+    public:
+        using Deliver = std::function<void(const array_view<LogRecord> &)>;
+
+        explicit AsyncLogWriter(Deliver deliver);
+        ~AsyncLogWriter();
+
+        static AsyncLogWriter &instance();
+
+        bool start(size_t capacity, Logger::OverflowPolicy policy);
+        void stop();
+
+        bool running() const {
+            return _running.load(std::memory_order_relaxed);
+        }
+
+        /// Queues one record.
+        ///
+        /// \retval true it was queued, or dropped by the overflow policy, and either way the
+        ///         caller has nothing more to do
+        /// \retval false nothing is queueing, so the caller delivers it itself
+        bool push(int level, const LogContext &context, const std::string_view &message,
+                  Logger::LogFormatter formatter = nullptr, const std::string_view &payload = {},
+                  const array_view<LogField> &fields = {});
+
+        /// Waits until everything queued before the call has been delivered.
+        ///
+        /// \note Returns at once on the writer thread, which would otherwise wait for itself.
+        void flush();
+
+        uint64_t dropped() const {
+            return _dropped.load(std::memory_order_relaxed);
+        }
+
+        bool onWriterThread() const {
+            return std::this_thread::get_id() == _writerId.load(std::memory_order_relaxed);
+        }
+
+    private:
+        void run();
+        size_t drain();
+        void wakeWriter();
+        void notifyProgress();
+
+        // A record taken off the ring, with the strings swapped out of its slot so that the slot
+        // can go back before the batch is delivered. Reused from one batch to the next, so the
+        // buffers keep whatever they have grown to.
+        struct Taken {
+            int level;
+            LogContext context;
+            bool hasCategory;
+            std::string category;
+            std::string message;
+            Logger::LogFormatter formatter;
+            std::string payload;
+            std::string fieldData;
+            std::vector<LogField> fields; // pointing into fieldData
+        };
+
+        Deliver _deliver;
+        std::vector<Taken> _taken;
+        std::vector<LogRecord> _batch;
+
+        std::unique_ptr<LogRing> _ring;
+        Logger::OverflowPolicy _policy = Logger::Block;
+
+        std::atomic<bool> _running{false};
+        std::atomic<bool> _stopping{false};
+        std::atomic<int> _inflight{0};
+        std::atomic<uint64_t> _dropped{0};
+
+        // Records delivered or evicted, against LogRing::claimed().
+        std::atomic<size_t> _done{0};
+
+        std::thread _writer;
+        std::atomic<std::thread::id> _writerId{};
+
+        // Start and stop, which nothing else takes.
+        std::mutex _controlMutex;
+
+        // The writer sleeps on this when the ring is empty, and says so in _writerIdle so that a
+        // producer only pays for the lock when there is somebody to wake.
+        std::mutex _wakeMutex;
+        std::condition_variable _wakeCv;
+        std::atomic<bool> _writerIdle{false};
+
+        // Producers blocked on a full ring, and flush() callers, sleep on this.
+        std::mutex _progressMutex;
+        std::condition_variable _progressCv;
+        std::atomic<int> _progressWaiters{0};
+
+        STDC_DISABLE_COPY_MOVE(AsyncLogWriter)
+    };
+
+}
+
+#endif // STDCORELIB_LOGGING_P_H
@@ -0,0 +1,280 @@
+// SPDX-License-Identifier: MIT
+
+#include "logging.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <functional>
+#include <thread>
+
+#ifdef _WIN32
+#  include "stdc_windows.h"
+#else
+#  include <pthread.h>
+#  include <time.h>
+#  include <unistd.h>
+#  ifdef __linux__
+#    include <sys/syscall.h>
+#  endif
+#endif
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#  define STDC_LOG_HAS_TSC
+#  ifdef _MSC_VER
+#    include <intrin.h>
+#  else
+#    include <cpuid.h>
+#    include <x86intrin.h>
+#  endif
+#endif
+
+using namespace std::chrono;
+
+namespace stdc {
+
+    namespace {
+
+        std::atomic<int> g_clock{Logger::PreciseClock};
+
+        int64_t steadyNow() {
+            return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+        }
+
+        // What to add to a monotonic reading to get the time since the epoch, taken from the
+        // system clock once, so that a clock stepped later moves no timestamp backwards.
+        int64_t epochOffset() {
+            static const int64_t offset =
+                duration_cast<nanoseconds>(system_clock::now().time_since_epoch()).count() -
+                steadyNow();
+            return offset;
+        }
+
+        int64_t preciseNow() {
+            return epochOffset() + steadyNow();
+        }
+
+        // The coarse clocks count from where steady_clock does, CLOCK_MONOTONIC and the boot
+        // respectively, so the one offset does for them too.
+#if defined(__linux__)
+        constexpr bool hasCoarseClock = true;
+
+        int64_t coarseNow() {
+            timespec ts;
+            ::clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+            return epochOffset() + int64_t(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+        }
+#elif defined(_WIN32)
+        constexpr bool hasCoarseClock = true;
+
+        int64_t coarseNow() {
+            // Milliseconds since the boot, as of the last timer tick.
+            return epochOffset() + int64_t(::GetTickCount64()) * 1000000;
+        }
+#else
+        constexpr bool hasCoarseClock = false;
+
+        int64_t coarseNow() {
+            return preciseNow();
+        }
+#endif
+
+#ifdef STDC_LOG_HAS_TSC
+        // Written before g_clock says to read it, and not again while it does.
+        struct {
+            uint64_t baseTicks;
+            int64_t baseTime;
+            double nsPerTick;
+        } g_calibration;
+
+        uint64_t readTicks() {
+            return __rdtsc();
+        }
+
+        // Without an invariant counter the rate follows the core's frequency, and the
+        // calibration would mean nothing by the time it was used.
+        bool hasInvariantTsc() {
+#  ifdef _MSC_VER
+            int regs[4];
+            __cpuid(regs, 0x80000000);
+            if (unsigned(regs[0]) < 0x80000007u) {
+                return false;
+            }
+            __cpuid(regs, 0x80000007);
+            return (regs[3] & (1 << 8)) != 0;
+#  else
+            unsigned a, b, c, d;
+            if (__get_cpuid_max(0x80000000, nullptr) < 0x80000007u) {
+                return false;
+            }
+            __cpuid(0x80000007, a, b, c, d);
+            return (d & (1u << 8)) != 0;
+#  endif
+        }
+
+        bool calibrateCycleCounter() {
+            if (!hasInvariantTsc()) {
+                return false;
+            }
+            auto t0 = steady_clock::now();
+            auto k0 = readTicks();
+            std::this_thread::sleep_for(milliseconds(20));
+            auto t1 = steady_clock::now();
+            auto k1 = readTicks();
+
+            auto ns = duration_cast<nanoseconds>(t1 - t0).count();
+            if (k1 <= k0 || ns <= 0) {
+                return false;
+            }
+            g_calibration.nsPerTick = double(ns) / double(k1 - k0);
+            g_calibration.baseTicks = readTicks();
+            g_calibration.baseTime = preciseNow();
+            return true;
+        }
+
+        int64_t cycleNow() {
+            auto ticks = readTicks() - g_calibration.baseTicks;
+            return g_calibration.baseTime + int64_t(double(ticks) * g_calibration.nsPerTick);
+        }
+#else
+        bool calibrateCycleCounter() {
+            return false;
+        }
+
+        int64_t cycleNow() {
+            return preciseNow();
+        }
+#endif
+
+        uint64_t systemThreadId() {
+#if defined(_WIN32)
+            return ::GetCurrentThreadId();
+#elif defined(__linux__)
+            return uint64_t(::syscall(SYS_gettid));
+#elif defined(__APPLE__)
+            uint64_t tid = 0;
+            ::pthread_threadid_np(nullptr, &tid);
+            return tid;
+#else
+            return std::hash<std::thread::id>()(std::this_thread::get_id());
+#endif
+        }
+
+        bool toCalendar(std::time_t t, bool utc, std::tm &tm) {
+#ifdef _WIN32
+            return (utc ? ::gmtime_s(&tm, &t) : ::localtime_s(&tm, &t)) == 0;
+#else
+            return (utc ? ::gmtime_r(&t, &tm) : ::localtime_r(&t, &tm)) != nullptr;
+#endif
+        }
+
+    }
+
+    bool Logger::setTimestampClock(TimestampClock clock) {
+        switch (clock) {
+            case PreciseClock:
+                break;
+            case CoarseClock:
+                if (!hasCoarseClock) {
+                    return false;
+                }
+                break;
+            case CycleCounter:
+                if (!calibrateCycleCounter()) {
+                    return false;
+                }
+                break;
+            default:
+                return false;
+        }
+        g_clock.store(clock, std::memory_order_release);
+        return true;
+    }
+
+    Logger::TimestampClock Logger::timestampClock() {
+        return TimestampClock(g_clock.load(std::memory_order_acquire));
+    }
+
+    int64_t Logger::timestamp() {
+        switch (g_clock.load(std::memory_order_acquire)) {
+            case CoarseClock:
+                return coarseNow();
+            case CycleCounter:
+                return cycleNow();
+            default:
+                return preciseNow();
+        }
+    }
+
+    uint64_t Logger::currentThreadId() {
+        // A system call the first time, on Linux, and a thread-local read after that.
+        static thread_local uint64_t id = systemThreadId();
+        return id;
+    }
+
+    LogTimeFormatter::LogTimeFormatter(bool utc, Precision precision)
+        : _utc(utc), _precision(precision), _minute(INT64_MIN), _prefix(0), _text() {
+    }
+
+    std::string_view LogTimeFormatter::format(int64_t time) {
+        // Floored, so that a time before the epoch still has a fraction that is not negative.
+        int64_t secs = time / 1000000000;
+        int64_t fraction = time % 1000000000;
+        if (fraction < 0) {
+            fraction += 1000000000;
+            --secs;
+        }
+        int64_t minute = secs / 60;
+        int64_t second = secs % 60;
+        if (second < 0) {
+            second += 60;
+            --minute;
+        }
+
+        // Time zones move by whole minutes at most, and at the turn of one, so the date and the
+        // hour and minute written for this minute hold for every record in it.
+        if (minute != _minute) {
+            std::tm tm{};
+            _minute = INT64_MIN;
+            _prefix = toCalendar(std::time_t(minute * 60), _utc, tm)
+                          ? std::strftime(_text, sizeof(_text) - 16, "%Y-%m-%d %H:%M:", &tm)
+                          : 0;
+            if (_prefix == 0) {
+                return {};
+            }
+            _minute = minute;
+        }
+
+        char *p = _text + _prefix;
+        *p++ = char('0' + second / 10);
+        *p++ = char('0' + second % 10);
+
+        int digits = 0;
+        switch (_precision) {
+            case Milliseconds:
+                digits = 3;
+                fraction /= 1000000;
+                break;
+            case Microseconds:
+                digits = 6;
+                fraction /= 1000;
+                break;
+            case Nanoseconds:
+                digits = 9;
+                break;
+            default:
+                break;
+        }
+        if (digits > 0) {
+            *p++ = '.';
+            for (int i = digits - 1; i >= 0; --i) {
+                p[i] = char('0' + fraction % 10);
+                fraction /= 10;
+            }
+            p += digits;
+        }
+        return std::string_view(_text, size_t(p - _text));
+    }
+
+}
@@ -0,0 +1,530 @@
+// SPDX-License-Identifier: MIT
+
+#include "logsinks.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <ctime>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#  include <io.h>
+#else
+#  include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace stdc {
+
+    // The file is written through a descriptor rather than a FILE *, whose own buffer would sit
+    // between ours and the system and split one flush into several writes.
+    namespace {
+
+#ifdef _WIN32
+        int openAppend(const fs::path &path) {
+            return ::_wopen(path.c_str(),
+                            _O_WRONLY | _O_CREAT | _O_APPEND | _O_BINARY | _O_NOINHERIT,
+                            _S_IREAD | _S_IWRITE);
+        }
+
+        long long writeSome(int fd, const char *data, size_t size) {
+            // _write() takes an unsigned int, so a larger buffer goes in pieces.
+            return ::_write(fd, data, unsigned(std::min<size_t>(size, 1u << 30)));
+        }
+
+        void closeFd(int fd) {
+            ::_close(fd);
+        }
+
+        int dupFd(int fd) {
+            return ::_dup(fd);
+        }
+
+        void syncFd(int fd) {
+            ::_commit(fd);
+        }
+
+        uint64_t fileSize(int fd) {
+            struct _stat64 st;
+            return ::_fstat64(fd, &st) == 0 ? uint64_t(st.st_size) : 0;
+        }
+
+        bool utcTime(std::time_t t, std::tm &tm) {
+            return ::gmtime_s(&tm, &t) == 0;
+        }
+#else
+        int openAppend(const fs::path &path) {
+            return ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        }
+
+        long long writeSome(int fd, const char *data, size_t size) {
+            return ::write(fd, data, size);
+        }
+
+        void closeFd(int fd) {
+            ::close(fd);
+        }
+
+        int dupFd(int fd) {
+            return ::fcntl(fd, F_DUPFD_CLOEXEC, 0);
+        }
+
+        void syncFd(int fd) {
+            ::fsync(fd);
+        }
+
+        uint64_t fileSize(int fd) {
+            struct stat st;
+            return ::fstat(fd, &st) == 0 ? uint64_t(st.st_size) : 0;
+        }
+
+        bool utcTime(std::time_t t, std::tm &tm) {
+            return ::gmtime_r(&t, &tm) != nullptr;
+        }
+#endif
+
+        // "20261018-153000", which sorts as it reads.
+        std::string timestamp(std::chrono::system_clock::time_point tp) {
+            std::tm tm{};
+            if (!utcTime(std::chrono::system_clock::to_time_t(tp), tm)) {
+                return "00000000-000000";
+            }
+            char buf[32];
+            std::strftime(buf, sizeof(buf), "%Y%m%d-%H%M%S", &tm);
+            return buf;
+        }
+
+        // Whether \a name is a segment of the live file \a stem.ext: the stem, a dot, and a
+        // timestamp, then anything at all, which leaves room for what the archive callback does
+        // to it.
+        bool isSegmentName(const std::string &name, const std::string &stem) {
+            if (name.size() < stem.size() + 16 || name.compare(0, stem.size(), stem) != 0 ||
+                name[stem.size()] != '.') {
+                return false;
+            }
+            auto stamp = std::string_view(name).substr(stem.size() + 1, 15);
+            for (size_t i = 0; i < stamp.size(); ++i) {
+                bool ok = i == 8 ? stamp[i] == '-' : (stamp[i] >= '0' && stamp[i] <= '9');
+                if (!ok) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // Oldest first: by the timestamp, then by the number a second rotation within the same
+        // second added after it, which a plain comparison of the names would put first.
+        bool segmentLess(const std::string &a, const std::string &b, size_t stem) {
+            auto key = [stem](const std::string &name) {
+                int n = 0;
+                size_t i = stem + 16;
+                if (i < name.size() && name[i] == '-') {
+                    while (++i < name.size() && name[i] >= '0' && name[i] <= '9') {
+                        n = n * 10 + (name[i] - '0');
+                    }
+                }
+                return std::make_pair(std::string_view(name).substr(stem + 1, 15), n);
+            };
+            return key(a) < key(b);
+        }
+
+    }
+
+    class FileLogSink::Impl {
+    public:
+        explicit Impl(Options options) : options(std::move(options)) {
+        }
+
+        Options options;
+        LogTimeFormatter timeFormatter; // formatRecord() runs under the lock
+
+        // Everything below is under this, which the background thread shares.
+        mutable std::mutex mutex;
+        std::condition_variable cv;
+
+        int fd = -1;
+        uint64_t size = 0; // of the live file, as far as this sink has written it
+        std::error_code error;
+
+        std::string buffer;
+        std::chrono::steady_clock::time_point firstBuffered;
+        std::chrono::system_clock::time_point nextRotation;
+        std::string lastStamp; // of the last segment named, and the number it was given
+        int lastSeq = 0;
+
+        // Work for the background thread.
+        std::vector<fs::path> rotated;
+        bool syncPending = false;
+        bool stopping = false;
+        std::thread worker;
+
+        bool openLocked() {
+            fd = openAppend(options.path);
+            if (fd < 0) {
+                error = std::error_code(errno, std::generic_category());
+                return false;
+            }
+            size = fileSize(fd);
+            scheduleRotation(std::chrono::system_clock::now());
+            return true;
+        }
+
+        void scheduleRotation(std::chrono::system_clock::time_point now) {
+            auto period = options.rotateInterval.count();
+            if (period <= 0) {
+                return;
+            }
+            auto secs = std::chrono::duration_cast<std::chrono::seconds>(now.time_since_epoch());
+            nextRotation = std::chrono::system_clock::time_point(
+                std::chrono::seconds((secs.count() / period + 1) * period));
+        }
+
+        bool writeAll(const char *data, size_t n) {
+            while (n > 0) {
+                auto written = writeSome(fd, data, n);
+                if (written < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    error = std::error_code(errno, std::generic_category());
+                    return false;
+                }
+                data += written;
+                n -= size_t(written);
+                size += uint64_t(written);
+            }
+            return true;
+        }
+
+        fs::path segmentPath(std::chrono::system_clock::time_point now) {
+            const auto &live = options.path;
+            auto stamp = timestamp(now);
+            auto base = live.stem().string() + "." + stamp;
+            auto ext = live.extension().string();
+
+            // Two rotations within a second, an explicit rotate() on top of a size rotation say,
+            // would otherwise want the same name. The number only ever goes up within the second,
+            // even past a name the pruning has since freed, so the order of the names stays the
+            // order of the rotations.
+            int seq = stamp == lastStamp ? lastSeq + 1 : 0;
+            std::error_code ec;
+            fs::path candidate;
+            for (;; ++seq) {
+                candidate = live.parent_path() /
+                            (seq == 0 ? base + ext : base + "-" + std::to_string(seq) + ext);
+                if (!fs::exists(candidate, ec)) {
+                    break;
+                }
+            }
+            lastStamp = std::move(stamp);
+            lastSeq = seq;
+            return candidate;
+        }
+
+        bool rotateLocked(std::chrono::system_clock::time_point now) {
+            if (fd >= 0) {
+                closeFd(fd);
+                fd = -1;
+            }
+
+            // Renamed while closed, which Windows insists on, and then reopened under the old
+            // name whatever became of the rename, so that logging carries on either way.
+            auto segment = segmentPath(now);
+            std::error_code ec;
+            fs::rename(options.path, segment, ec);
+            bool ok = !ec;
+            if (ok) {
+                rotated.push_back(std::move(segment));
+                cv.notify_all();
+            } else {
+                error = ec;
+            }
+            if (!openLocked()) {
+                return false;
+            }
+            return ok;
+        }
+
+        void flushLocked() {
+            if (buffer.empty()) {
+                return;
+            }
+            if (fd < 0 && !openLocked()) {
+                buffer.clear(); // nowhere for it to go, and holding on would only grow it
+                return;
+            }
+
+            auto now = std::chrono::system_clock::now();
+            if (options.rotateInterval.count() > 0 && now >= nextRotation) {
+                if (size > 0) {
+                    rotateLocked(now);
+                } else {
+                    scheduleRotation(now);
+                }
+            } else if (options.maxFileSize > 0 && size > 0 &&
+                       size + buffer.size() > options.maxFileSize) {
+                rotateLocked(now);
+            }
+
+            if (fd >= 0) {
+                writeAll(buffer.data(), buffer.size());
+            }
+            buffer.clear();
+
+            if (options.syncOnFlush) {
+                syncPending = true;
+                cv.notify_all();
+            }
+        }
+
+        // Appends what formatRecord() wrote, and flushes if that filled the buffer. The caller
+        // holds the lock.
+        void recordAppended(bool wasEmpty) {
+            if (buffer.size() >= options.bufferSize) {
+                flushLocked();
+            } else if (wasEmpty) {
+                firstBuffered = std::chrono::steady_clock::now();
+                cv.notify_all(); // the background thread has a deadline to keep now
+            }
+        }
+
+        void archiveAndPrune(const std::vector<fs::path> &segments) {
+            if (options.archive) {
+                for (const auto &segment : segments) {
+                    options.archive(segment);
+                }
+            }
+            if (options.maxFiles <= 0) {
+                return;
+            }
+
+            auto dir = options.path.parent_path();
+            auto stem = options.path.stem().string();
+            std::vector<std::string> found;
+            std::error_code ec;
+            if (dir.empty()) {
+                dir = ".";
+            }
+            for (fs::directory_iterator it(dir, ec), end; !ec && it != end; it.increment(ec)) {
+                auto name = it->path().filename().string();
+                if (isSegmentName(name, stem)) {
+                    found.push_back(std::move(name));
+                }
+            }
+            if (found.size() <= size_t(options.maxFiles)) {
+                return;
+            }
+            std::sort(found.begin(), found.end(),
+                      [&stem](const std::string &a, const std::string &b) {
+                          return segmentLess(a, b, stem.size());
+                      });
+            for (size_t i = 0; i < found.size() - size_t(options.maxFiles); ++i) {
+                fs::remove(dir / found[i], ec);
+            }
+        }
+
+        void run() {
+            std::unique_lock lock(mutex);
+            while (!stopping) {
+                if (!rotated.empty() || syncPending) {
+                    auto segments = std::move(rotated);
+                    rotated.clear();
+                    int syncFdCopy = -1;
+                    if (syncPending && fd >= 0) {
+                        // A copy, so that a rotation closing the original meanwhile does not
+                        // pull it out from under the sync.
+                        syncFdCopy = dupFd(fd);
+                    }
+                    syncPending = false;
+
+                    lock.unlock();
+                    if (syncFdCopy >= 0) {
+                        syncFd(syncFdCopy);
+                        closeFd(syncFdCopy);
+                    }
+                    archiveAndPrune(segments);
+                    lock.lock();
+                    continue;
+                }
+
+                if (!buffer.empty() && options.flushInterval.count() > 0) {
+                    auto due = firstBuffered + options.flushInterval;
+                    if (std::chrono::steady_clock::now() >= due) {
+                        flushLocked();
+                        continue;
+                    }
+                    cv.wait_until(lock, due);
+                } else {
+                    cv.wait(lock);
+                }
+            }
+        }
+    };
+
+    FileLogSink::FileLogSink(Options options) : _impl(std::make_unique<Impl>(std::move(options))) {
+        auto &impl = *_impl;
+        impl.buffer.reserve(impl.options.bufferSize);
+        {
+            std::lock_guard lock(impl.mutex);
+            impl.openLocked();
+        }
+        impl.worker = std::thread([&impl]() { impl.run(); });
+    }
+
+    FileLogSink::~FileLogSink() {
+        auto &impl = *_impl;
+        std::vector<fs::path> segments;
+        {
+            std::lock_guard lock(impl.mutex);
+            impl.stopping = true;
+            impl.cv.notify_all();
+        }
+        impl.worker.join();
+
+        // No thread left to hand the last of it to, so it is done here.
+        impl.flushLocked();
+        segments = std::move(impl.rotated);
+        if (impl.fd >= 0) {
+            if (impl.syncPending) {
+                syncFd(impl.fd);
+            }
+            closeFd(impl.fd);
+        }
+        impl.archiveAndPrune(segments);
+    }
+
+    bool FileLogSink::isOpen() const {
+        std::lock_guard lock(_impl->mutex);
+        return _impl->fd >= 0;
+    }
+
+    std::error_code FileLogSink::error() const {
+        std::lock_guard lock(_impl->mutex);
+        return _impl->error;
+    }
+
+    const FileLogSink::Options &FileLogSink::options() const {
+        return _impl->options;
+    }
+
+    void FileLogSink::write(const LogRecord &record) {
+        auto &impl = *_impl;
+        std::lock_guard lock(impl.mutex);
+        bool wasEmpty = impl.buffer.empty();
+        formatRecord(impl.buffer, record);
+        impl.recordAppended(wasEmpty);
+    }
+
+    void FileLogSink::writeBatch(const array_view<LogRecord> &records) {
+        auto &impl = *_impl;
+        std::lock_guard lock(impl.mutex);
+        for (const auto &record : records) {
+            bool wasEmpty = impl.buffer.empty();
+            formatRecord(impl.buffer, record);
+            impl.recordAppended(wasEmpty);
+        }
+    }
+
+    void FileLogSink::flush() {
+        auto &impl = *_impl;
+        std::lock_guard lock(impl.mutex);
+        impl.flushLocked();
+    }
+
+    bool FileLogSink::rotate() {
+        auto &impl = *_impl;
+        std::lock_guard lock(impl.mutex);
+        impl.flushLocked();
+        return impl.rotateLocked(std::chrono::system_clock::now());
+    }
+
+    void FileLogSink::formatRecord(std::string &out, const LogRecord &record) {
+        if (record.context.time != 0) {
+            out.append(_impl->timeFormatter.format(record.context.time));
+            out.push_back(' ');
+        }
+        out.append(Logger::levelName(record.level));
+        if (record.context.category) {
+            out.push_back(' ');
+            out.append(record.context.category);
+        }
+        out.append(": ");
+        out.append(record.message);
+        LogField::appendTo(out, record.fields);
+        out.push_back('\n');
+    }
+
+    StructuredLogSink::StructuredLogSink(Options options, Encoding encoding)
+        : FileLogSink(std::move(options)), _encoding(encoding) {
+    }
+
+    StructuredLogSink::~StructuredLogSink() = default;
+
+    JsonValue StructuredLogSink::toJsonValue(const LogRecord &record) {
+        JsonObject object;
+        object.emplace("level", Logger::levelName(record.level));
+        object.emplace("message", std::string(record.message));
+        const auto &context = record.context;
+        if (context.category) {
+            object.emplace("category", context.category);
+        }
+        if (context.file) {
+            object.emplace("file", context.file);
+            object.emplace("line", context.line);
+        }
+        if (context.function) {
+            object.emplace("function", context.function);
+        }
+        if (context.time != 0) {
+            object.emplace("time", context.time);
+            object.emplace("thread", context.thread);
+        }
+        if (!record.fields.empty()) {
+            JsonObject fields;
+            for (const auto &field : record.fields) {
+                JsonValue value;
+                switch (field.type) {
+                    case LogField::Bool:
+                        value = field.b;
+                        break;
+                    case LogField::Int:
+                        value = field.i;
+                        break;
+                    case LogField::UInt:
+                        value = field.u;
+                        break;
+                    case LogField::Double:
+                        value = field.d;
+                        break;
+                    default:
+                        value = std::string(field.s);
+                        break;
+                }
+                fields.insert_or_assign(std::string(field.key), std::move(value));
+            }
+            object.emplace("fields", std::move(fields));
+        }
+        return object;
+    }
+
+    void StructuredLogSink::formatRecord(std::string &out, const LogRecord &record) {
+        auto value = toJsonValue(record);
+        if (_encoding == Cbor) {
+            auto cbor = value.toCbor();
+            out.append(reinterpret_cast<const char *>(cbor.data()), cbor.size());
+            return;
+        }
+        out.append(value.toJson());
+        out.push_back('\n');
+    }
+
+}
@@ -0,0 +1,206 @@
+// SPDX-License-Identifier: MIT
+
+#include "pipeline.h"
+#include "pipeline_p.h"
+
+#include <fcntl.h>
+
+#ifdef _WIN32
+#  include <io.h>
+#else
+#  include <unistd.h>
+#endif
+
+#include <cerrno>
+#include <chrono>
+#include <tuple>
+
+#include "scope_guard.h"
+#include "pimpl.h"
+
+namespace stdc {
+
+    // Not inherited by anything on its own. Each end goes to the one child meant to have it,
+    // through the stream it is given as, and to no other child started meanwhile.
+    static bool make_stage_pipe(int &read_fd, int &write_fd) {
+        int fds[2];
+#if defined(_WIN32)
+        if (::_pipe(fds, 0, _O_BINARY | _O_NOINHERIT) != 0) {
+            return false;
+        }
+#elif defined(__linux__)
+        if (::pipe2(fds, O_CLOEXEC) != 0) {
+            return false;
+        }
+#else
+        if (::pipe(fds) != 0) {
+            return false;
+        }
+        ::fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+        ::fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+#endif
+        read_fd = fds[0];
+        write_fd = fds[1];
+        return true;
+    }
+
+    static void close_stage_pipe_end(int fd) {
+#ifdef _WIN32
+        ::_close(fd);
+#else
+        ::close(fd);
+#endif
+    }
+
+    Pipeline::Pipeline() : _impl(new Impl()) {
+    }
+
+    Pipeline::~Pipeline() = default;
+
+    Pipeline::Pipeline(Pipeline &&RHS) noexcept = default;
+
+    Pipeline &Pipeline::operator=(Pipeline &&RHS) noexcept = default;
+
+    Pipeline &Pipeline::add(Popen stage) {
+        stdc_impl_t;
+        impl.stages.push_back(std::make_unique<Popen>(std::move(stage)));
+        return *this;
+    }
+
+    Pipeline &Pipeline::pipesize(int pipesize) {
+        stdc_impl_t;
+        impl.pipesize = pipesize;
+        return *this;
+    }
+
+    bool Pipeline::start(std::string *err_msg) {
+        stdc_impl_t;
+        impl.error_code.clear();
+        const auto &fail = [&](std::error_code error, const std::string &msg) {
+            impl.error_code = error;
+            if (err_msg) {
+                *err_msg = msg;
+            }
+            return false;
+        };
+
+        auto &stages = impl.stages;
+        if (stages.empty()) {
+            return fail(std::make_error_code(std::errc::invalid_argument), "no stages to start");
+        }
+
+        // Both ends of every pipe, which this process lets go of once the children have them,
+        // whether they all started or not. A write end left open here would keep the next stage
+        // from ever seeing the end of its input.
+        std::vector<int> ends;
+        auto ends_guard = make_scope_guard([&ends]() {
+            for (int fd : ends) {
+                close_stage_pipe_end(fd);
+            }
+        });
+        for (size_t i = 0; i + 1 < stages.size(); ++i) {
+            int read_fd, write_fd;
+            if (!make_stage_pipe(read_fd, write_fd)) {
+                auto error = std::error_code(errno, std::generic_category());
+                return fail(error, "pipe: " + error.message());
+            }
+            ends.push_back(read_fd);
+            ends.push_back(write_fd);
+#ifdef F_SETPIPE_SZ
+            if (impl.pipesize > 0) {
+                ::fcntl(write_fd, F_SETPIPE_SZ, impl.pipesize);
+            }
+#endif
+            stages[i]->stdout_(write_fd);
+            stages[i + 1]->stdin_(read_fd);
+        }
+
+        for (size_t i = 0; i < stages.size(); ++i) {
+            std::string msg;
+            if (stages[i]->start(&msg)) {
+                continue;
+            }
+            // The ones before it would be writing into a pipe nobody reads, or reading one
+            // nobody writes, so they go too.
+            for (size_t j = 0; j < i; ++j) {
+                std::ignore = stages[j]->kill();
+                std::ignore = stages[j]->wait();
+            }
+            return fail(stages[i]->error_code(), "stage " + std::to_string(i) + ": " + msg);
+        }
+        return true;
+    }
+
+    std::error_code Pipeline::error_code() const {
+        stdc_impl_t;
+        return impl.error_code;
+    }
+
+    Pipeline::Output Pipeline::communicate(const std::string &input, int timeout) {
+        stdc_impl_t;
+        impl.error_code.clear();
+        return impl.communicate_impl(input, timeout);
+    }
+
+    bool Pipeline::wait(int timeout) {
+        stdc_impl_t;
+        impl.error_code.clear();
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout);
+        for (const auto &stage : impl.stages) {
+            int remaining = -1;
+            if (timeout >= 0) {
+                auto left = std::chrono::ceil<std::chrono::milliseconds>(
+                    deadline - std::chrono::steady_clock::now());
+                remaining = left.count() > 0 ? int(left.count()) : 0;
+            }
+            if (!stage->wait(remaining)) {
+                auto error = stage->error_code();
+                impl.error_code = error ? error : std::make_error_code(std::errc::timed_out);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool Pipeline::kill() {
+        stdc_impl_t;
+        impl.error_code.clear();
+        bool ok = true;
+        for (const auto &stage : impl.stages) {
+            if (stage->pid() > 0 && !stage->returncode() && !stage->kill()) {
+                impl.error_code = stage->error_code();
+                ok = false;
+            }
+        }
+        return ok;
+    }
+
+    size_t Pipeline::size() const {
+        stdc_impl_t;
+        return impl.stages.size();
+    }
+
+    Popen &Pipeline::stage(size_t index) const {
+        stdc_impl_t;
+        return *impl.stages[index];
+    }
+
+    std::vector<std::optional<int>> Pipeline::returncodes() const {
+        stdc_impl_t;
+        std::vector<std::optional<int>> codes;
+        codes.reserve(impl.stages.size());
+        for (const auto &stage : impl.stages) {
+            codes.push_back(stage->returncode());
+        }
+        return codes;
+    }
+
+    std::optional<int> Pipeline::returncode() const {
+        stdc_impl_t;
+        if (impl.stages.empty()) {
+            return std::nullopt;
+        }
+        return impl.stages.back()->returncode();
+    }
+
+}
@@ -0,0 +1,23 @@
+// SPDX-License-Identifier: MIT
+
+#ifndef STDCORELIB_PIPELINE_P_H
+#define STDCORELIB_PIPELINE_P_H
+
+#include <stdcorelib/support/pipeline.h>
+
+namespace stdc {
+
+    class Pipeline::Impl {
+    public:
+        // Held by pointer so that a reference from stage() stays good while more are added.
+        std::vector<std::unique_ptr<Popen>> stages;
+        int pipesize = -1;
+
+        std::error_code error_code;
+
+        Output communicate_impl(const std::string &input, int timeout);
+    };
+
+}
+
+#endif // STDCORELIB_PIPELINE_P_H
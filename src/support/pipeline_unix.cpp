@@ -0,0 +1,51 @@
+// SPDX-License-Identifier: MIT
+
+#include "pipeline.h"
+#include "pipeline_p.h"
+
+#include <cerrno>
+
+#include "processreactor.h"
+
+namespace stdc {
+
+    // Every stage on one ProcessReactor, which takes each Popen for as long as it runs. on_exit
+    // hands it back to its place here, since the reactor lets go of it once that returns.
+    Pipeline::Output Pipeline::Impl::communicate_impl(const std::string &input, int timeout) {
+        Output output;
+        output.err.resize(stages.size());
+        if (stages.empty()) {
+            return output;
+        }
+
+        ProcessReactor reactor;
+        for (size_t i = 0; i < stages.size(); ++i) {
+            auto &stage = *stages[i];
+            ProcessReactor::Handlers handlers;
+            if (i + 1 == stages.size()) {
+                handlers.on_stdout_chunk = [&output](std::string_view chunk) {
+                    output.out.append(chunk);
+                };
+            }
+            handlers.on_stderr_chunk = [&output, i](std::string_view chunk) {
+                output.err[i].append(chunk);
+            };
+            handlers.on_exit = [this, &stage](Popen &popen, std::error_code error) {
+                if (error && !error_code) {
+                    error_code = error;
+                }
+                stage = std::move(popen);
+            };
+            if (!reactor.add(std::move(stage), std::move(handlers), i == 0 ? input : std::string(),
+                             timeout)) {
+                // Never started, so there is nothing to read from it or wait for.
+                if (!error_code) {
+                    error_code = std::error_code(errno, std::generic_category());
+                }
+            }
+        }
+        reactor.run();
+        return output;
+    }
+
+}
@@ -0,0 +1,48 @@
+// SPDX-License-Identifier: MIT
+
+#include "pipeline.h"
+#include "pipeline_p.h"
+
+#include <thread>
+#include <tuple>
+
+namespace stdc {
+
+    // An anonymous pipe cannot be waited on here, so each stage gets a thread of its own for
+    // Popen::communicate(), which is threads already. The last stage runs on this one.
+    Pipeline::Output Pipeline::Impl::communicate_impl(const std::string &input, int timeout) {
+        Output output;
+        output.err.resize(stages.size());
+        if (stages.empty()) {
+            return output;
+        }
+
+        std::vector<std::error_code> errors(stages.size());
+        std::vector<std::string> outs(stages.size());
+        const auto &run_stage = [&](size_t i) {
+            std::tie(outs[i], output.err[i]) =
+                stages[i]->communicate(i == 0 ? input : std::string(), timeout);
+            errors[i] = stages[i]->error_code();
+        };
+
+        std::vector<std::thread> threads;
+        threads.reserve(stages.size() - 1);
+        for (size_t i = 0; i + 1 < stages.size(); ++i) {
+            threads.emplace_back(run_stage, i);
+        }
+        run_stage(stages.size() - 1);
+        for (auto &thread : threads) {
+            thread.join();
+        }
+
+        output.out = std::move(outs.back());
+        for (const auto &error : errors) {
+            if (error) {
+                error_code = error;
+                break;
+            }
+        }
+        return output;
+    }
+
+}
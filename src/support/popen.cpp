@@ -14,108 +14,271 @@
 #  include <unistd.h>
 #endif
 
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
 #include <thread>
+#include <tuple>
 
 #include "pimpl.h"
 #include "str.h"
 
 namespace stdc {
 
-    /// A streambuf over a FILE *. MSVC offers this as basic_filebuf(FILE *) and libstdc++ as
-    /// __gnu_cxx::stdio_filebuf. Neither is portable, so we write it once here.
+    static FILE *Popen_fdopen(int fd, const char *modes) {
+#ifdef _WIN32
+        return _fdopen(fd, modes);
+#else
+        return fdopen(fd, modes);
+#endif
+    }
+
+    static int Popen_close_fd(int fd) {
+#ifdef _WIN32
+        return _close(fd);
+#else
+        return close(fd);
+#endif
+    }
+
+    // One system call, retried when a signal cut it short, as read(2) and write(2) both can
+    // be before anything moved.
+    static ptrdiff_t Popen_read_fd(int fd, char *data, size_t size) {
+        for (;;) {
+#ifdef _WIN32
+            ptrdiff_t n = ::_read(fd, data, unsigned(std::min<size_t>(size, INT_MAX)));
+#else
+            ptrdiff_t n = ::read(fd, data, size);
+#endif
+            if (n >= 0 || errno != EINTR) {
+                return n;
+            }
+        }
+    }
+
+    static bool Popen_write_fd(int fd, const char *data, size_t size) {
+        while (size > 0) {
+#ifdef _WIN32
+            ptrdiff_t n = ::_write(fd, data, unsigned(std::min<size_t>(size, INT_MAX)));
+#else
+            ptrdiff_t n = ::write(fd, data, size);
+#endif
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                return false;
+            }
+            data += n;
+            size -= size_t(n);
+        }
+        return true;
+    }
+
+    /// A streambuf straight over the pipe's descriptor.
+    ///
+    /// A stream belongs to one Popen and is only ever used from one thread at a time, so the
+    /// locking stdio does on every call buys nothing here, and neither does its second buffer
+    /// behind this one. Each pipe goes one way, so the one buffer is the get area of a stream
+    /// that is read and the put area of one that is written. Transfers at least as large as the
+    /// buffer skip it and go to the descriptor directly.
     ///
-    /// Building on stdio rather than the OS handle keeps the text mode translation that
-    /// _fdopen already set up, and leaves buffering to the C library.
+    /// The text mode translation on Windows is the descriptor's own, set by _open_osfhandle,
+    /// and _read and _write do it as fread and fwrite did.
     class Popen::Stream::Buf : public std::streambuf {
     public:
         ~Buf() override {
             close();
         }
 
-        void open(FILE *file) {
+        void open(int fd, bool writable, bool text, size_t size) {
             close();
-            _file = file;
-            setg(_buf, _buf, _buf);
+            _fd = fd;
+            _writable = writable;
+            _text = text;
+            // Even an unbuffered stream reads into something. One character of it is what
+            // underflow() needs to hand back.
+            _size = size > 0 ? size : 1;
+            _buffered = size > 0;
+            _buf.reset(new char[_size]);
+            setg(_buf.get(), _buf.get(), _buf.get());
+            if (_writable && _buffered) {
+                setp(_buf.get(), _buf.get() + _size);
+            } else {
+                setp(nullptr, nullptr);
+            }
         }
 
         bool is_open() const {
-            return _file != nullptr;
+            return _fd != -1;
+        }
+
+        int fd() const {
+            return _fd;
         }
 
-        FILE *file() const {
+        // Made the first time it is asked for. From then on it owns the descriptor, and closing
+        // goes through it.
+        FILE *file() {
+            if (_fd == -1) {
+                return nullptr;
+            }
+            if (!_file) {
+                std::ignore = flush();
+                _file = Popen_fdopen(_fd, _writable ? (_text ? "w" : "wb") : (_text ? "r" : "rb"));
+            }
             return _file;
         }
 
         void close() {
-            if (!_file) {
+            if (_fd == -1) {
                 return;
             }
-            std::fflush(_file);
-            std::fclose(_file);
-            _file = nullptr;
-            setg(_buf, _buf, _buf);
+            std::ignore = flush();
+            if (_file) {
+                std::fclose(_file);
+                _file = nullptr;
+            } else {
+                Popen_close_fd(_fd);
+            }
+            _fd = -1;
+            _buf.reset();
+            setg(nullptr, nullptr, nullptr);
+            setp(nullptr, nullptr);
         }
 
     protected:
         int_type underflow() override {
-            if (!_file) {
-                return traits_type::eof();
-            }
             if (gptr() < egptr()) {
                 return traits_type::to_int_type(*gptr());
             }
-            size_t n = std::fread(_buf, 1, sizeof(_buf), _file);
-            if (n == 0) {
+            if (_fd == -1 || _writable) {
                 return traits_type::eof();
             }
-            setg(_buf, _buf, _buf + n);
+            ptrdiff_t n = Popen_read_fd(_fd, _buf.get(), _size);
+            if (n <= 0) {
+                return traits_type::eof();
+            }
+            setg(_buf.get(), _buf.get(), _buf.get() + n);
             return traits_type::to_int_type(*gptr());
         }
 
+        std::streamsize xsgetn(char *s, std::streamsize n) override {
+            std::streamsize done = 0;
+            while (done < n) {
+                std::streamsize held = egptr() - gptr();
+                if (held > 0) {
+                    std::streamsize take = std::min(held, n - done);
+                    std::memcpy(s + done, gptr(), size_t(take));
+                    gbump(int(take));
+                    done += take;
+                    continue;
+                }
+                if (_fd == -1 || _writable) {
+                    break;
+                }
+                // As much as is left to read, straight into the caller's memory, when it would
+                // not fit the buffer anyway.
+                if (size_t(n - done) >= _size) {
+                    ptrdiff_t got = Popen_read_fd(_fd, s + done, size_t(n - done));
+                    if (got <= 0) {
+                        break;
+                    }
+                    done += got;
+                    continue;
+                }
+                if (traits_type::eq_int_type(underflow(), traits_type::eof())) {
+                    break;
+                }
+            }
+            return done;
+        }
+
         std::streamsize xsputn(const char *s, std::streamsize n) override {
-            if (!_file) {
+            if (_fd == -1 || !_writable) {
                 return 0;
             }
-            return std::streamsize(std::fwrite(s, 1, size_t(n), _file));
+            std::streamsize room = epptr() - pptr();
+            if (n <= room) {
+                std::memcpy(pptr(), s, size_t(n));
+                pbump(int(n));
+                return n;
+            }
+            // Whatever is held goes first, to keep the order, then this in one write rather than
+            // a buffer at a time. Something smaller than the buffer waits in it for more.
+            if (!flush()) {
+                return 0;
+            }
+            if (size_t(n) >= _size || !_buffered) {
+                return Popen_write_fd(_fd, s, size_t(n)) ? n : 0;
+            }
+            std::memcpy(pptr(), s, size_t(n));
+            pbump(int(n));
+            return n;
         }
 
         int_type overflow(int_type c) override {
-            if (!_file) {
+            if (_fd == -1 || !_writable || !flush()) {
                 return traits_type::eof();
             }
-            if (c != traits_type::eof()) {
-                auto ch = traits_type::to_char_type(c);
-                if (std::fwrite(&ch, 1, 1, _file) != 1) {
-                    return traits_type::eof();
-                }
+            if (traits_type::eq_int_type(c, traits_type::eof())) {
+                return traits_type::not_eof(c);
             }
+            auto ch = traits_type::to_char_type(c);
+            if (!_buffered) {
+                return Popen_write_fd(_fd, &ch, 1) ? c : traits_type::eof();
+            }
+            *pptr() = ch;
+            pbump(1);
             return c;
         }
 
         int sync() override {
-            return (_file && std::fflush(_file) == 0) ? 0 : -1;
+            if (_fd == -1) {
+                return -1;
+            }
+            if (!flush()) {
+                return -1;
+            }
+            return (_file && std::fflush(_file) != 0) ? -1 : 0;
         }
 
     private:
+        int _fd = -1;
         FILE *_file = nullptr;
-        char _buf[4096]{};
+        bool _writable = false;
+        bool _text = false;
+        bool _buffered = true;
+        size_t _size = 0;
+        std::unique_ptr<char[]> _buf;
+
+        // Writes out what the put area holds and empties it.
+        bool flush() {
+            if (!_writable || pbase() == pptr()) {
+                return true;
+            }
+            bool ok = Popen_write_fd(_fd, pbase(), size_t(pptr() - pbase()));
+            setp(_buf.get(), _buf.get() + _size);
+            return ok;
+        }
     };
 
     // No buffer until there is a pipe to put in it. Every Popen holds three of these and most
-    // runs open one or none, so building the buffer here spends four kilobytes apiece on streams
-    // nobody asked for. A null streambuf leaves the stream in badbit, which is what a stream
-    // that was never opened should report anyway.
+    // runs open one or none, so building the buffer here spends memory on streams nobody asked
+    // for. A null streambuf leaves the stream in badbit, which is what a stream that was never
+    // opened should report anyway.
     Popen::Stream::Stream() : std::iostream(nullptr) {
     }
 
     Popen::Stream::~Stream() = default;
 
-    void Popen::Stream::open(FILE *file) {
+    void Popen::Stream::open(int fd, bool writable, bool text, size_t bufsize) {
         if (!_buf) {
             _buf.reset(new Buf());
             rdbuf(_buf.get());
         }
-        _buf->open(file);
+        _buf->open(fd, writable, text, bufsize);
         clear();
     }
 
@@ -133,6 +296,10 @@ namespace stdc {
         return _buf ? _buf->file() : nullptr;
     }
 
+    int Popen::Stream::fd() const {
+        return _buf ? _buf->fd() : -1;
+    }
+
     Popen::Impl::Impl() = default;
 
     Popen::Impl::~Impl() {
@@ -143,20 +310,14 @@ namespace stdc {
         _cleanup();
     }
 
-    static FILE *Popen_fdopen(int fd, const char *modes) {
-#ifdef _WIN32
-        return _fdopen(fd, modes);
-#else
-        return fdopen(fd, modes);
-#endif
-    }
-
-    static int Popen_close_fd(int fd) {
-#ifdef _WIN32
-        return _close(fd);
-#else
-        return close(fd);
-#endif
+    // The two strings are sinks like any other, which is one loop to keep right rather than two.
+    std::tuple<std::string, std::string> Popen::Impl::communicate_impl(const std::string &input,
+                                                                       int timeout) {
+        std::string out, err;
+        Sink out_sink([&out](std::string_view chunk) { out.append(chunk); });
+        Sink err_sink([&err](std::string_view chunk) { err.append(chunk); });
+        std::ignore = communicate_sinks(input, out_sink, err_sink, timeout);
+        return {std::move(out), std::move(err)};
     }
 
     bool Popen::Impl::done() {
@@ -169,6 +330,7 @@ namespace stdc {
         }
         pid = -1;
         returncode.reset();
+        resource_usage.reset();
         _closed_child_pipe_fds = false;
 
         // Nothing downstream can make an argv out of nothing, and both platforms only found out
@@ -309,37 +471,15 @@ namespace stdc {
             return false;
         }
 #endif
-        // Turn all descriptors into FILE objects transactionally. A failed fdopen leaves its
-        // descriptor owned by the caller, so every partial result needs explicit cleanup.
-        FILE *stdin_file = p2cwrite == -1 ? nullptr : Popen_fdopen(p2cwrite, text ? "w" : "wb");
-        FILE *stdout_file = c2pread == -1 ? nullptr : Popen_fdopen(c2pread, text ? "r" : "rb");
-        FILE *stderr_file = errread == -1 ? nullptr : Popen_fdopen(errread, text ? "r" : "rb");
-        if ((p2cwrite != -1 && !stdin_file) || (c2pread != -1 && !stdout_file) ||
-            (errread != -1 && !stderr_file)) {
-            error_code = errno ? std::error_code(errno, std::generic_category())
-                               : std::make_error_code(std::errc::io_error);
-            error_api = "fdopen";
-            if (stdin_file)
-                std::fclose(stdin_file);
-            else if (p2cwrite != -1)
-                Popen_close_fd(p2cwrite);
-            if (stdout_file)
-                std::fclose(stdout_file);
-            else if (c2pread != -1)
-                Popen_close_fd(c2pread);
-            if (stderr_file)
-                std::fclose(stderr_file);
-            else if (errread != -1)
-                Popen_close_fd(errread);
-            _close_pipe_fds_1(p2cread, p2cwrite, c2pread, c2pwrite, errread, errwrite);
-            return false;
-        }
-        if (stdin_file)
-            stdin_stream.open(stdin_file);
-        if (stdout_file)
-            stdout_stream.open(stdout_file);
-        if (stderr_file)
-            stderr_stream.open(stderr_file);
+        // The streams take the descriptors as they are. Nothing can fail here, so nothing is
+        // left half open for the failure paths below to undo.
+        size_t stream_bufsize = bufsize < 0 ? default_bufsize : size_t(bufsize);
+        if (p2cwrite != -1)
+            stdin_stream.open(p2cwrite, true, text, stream_bufsize);
+        if (c2pread != -1)
+            stdout_stream.open(c2pread, false, text, stream_bufsize);
+        if (errread != -1)
+            stderr_stream.open(errread, false, text, stream_bufsize);
 
 #ifdef _WIN32
         bool result = _execute_child(p2cread, p2cwrite, c2pread, c2pwrite, errread, errwrite);
@@ -465,6 +605,12 @@ namespace stdc {
         return *this;
     }
 
+    Popen &Popen::bufsize(int bufsize) {
+        stdc_impl_t;
+        impl.bufsize = bufsize;
+        return *this;
+    }
+
 #ifdef _WIN32
     Popen &Popen::startupinfo(std::optional<StartupInfo> startupinfo) {
         stdc_impl_t;
@@ -541,6 +687,18 @@ namespace stdc {
         impl.process_group = process_group;
         return *this;
     }
+
+    Popen &Popen::rlimit(int resource, long long soft, std::optional<long long> hard) {
+        stdc_impl_t;
+        auto &rlimits = impl.rlimits;
+        rlimits.erase(std::remove_if(rlimits.begin(), rlimits.end(),
+                                     [resource](const Impl::rlimit_setting &setting) {
+                                         return setting.resource == resource;
+                                     }),
+                      rlimits.end());
+        rlimits.push_back({resource, soft, hard});
+        return *this;
+    }
 #endif
 
     bool Popen::start(std::string *err_msg) {
@@ -557,6 +715,7 @@ namespace stdc {
         // Windows never had either, so this is also what makes the two agree.
         impl.pid = -1;
         impl.returncode.reset();
+        impl.resource_usage.reset();
 
         // system api error
         if (err_msg) {
@@ -603,6 +762,11 @@ namespace stdc {
         return impl.communicate_impl(input, timeout);
     }
 
+    bool Popen::communicate(const std::string &input, Sink out, Sink err, int timeout) {
+        stdc_impl_t;
+        return impl.communicate_sinks(input, out, err, timeout);
+    }
+
     bool Popen::send_signal(int sig) {
         stdc_impl_t;
         return impl.send_signal_impl(sig);
@@ -648,6 +812,13 @@ namespace stdc {
         return impl.pid;
     }
 
+#ifndef _WIN32
+    int Popen::exit_fd() const {
+        stdc_impl_t;
+        return impl._server_socket != -1 ? impl._server_socket : impl._pidfd;
+    }
+#endif
+
     bool Popen::detached() const {
         stdc_impl_t;
         return impl.detached;
@@ -658,4 +829,9 @@ namespace stdc {
         return impl.returncode;
     }
 
+    std::optional<Popen::ResourceUsage> Popen::resource_usage() const {
+        stdc_impl_t;
+        return impl.resource_usage;
+    }
+
 }
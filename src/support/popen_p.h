@@ -8,10 +8,21 @@
 #include <set>
 #include <shared_mutex>
 
+#ifndef _WIN32
+#  include <csignal>
+#  include <map>
+#  include <string>
+#  include <sys/resource.h>
+#endif
+
 #include <stdcorelib/support/popen.h>
 
 namespace stdc {
 
+#ifndef _WIN32
+    struct fork_server_signals;
+#endif
+
     class Popen::Impl {
     public:
 #ifdef _WIN32
@@ -52,6 +63,11 @@ namespace stdc {
         bool close_fds = true;
         bool detached = false;
         int pipesize = -1;
+        int bufsize = -1;
+
+        // As much as a Linux pipe holds unless told otherwise, so that one read of a full pipe
+        // empties it.
+        static constexpr size_t default_bufsize = 65536;
 
 #ifdef _WIN32
         std::optional<StartupInfo> startupinfo;
@@ -75,6 +91,13 @@ namespace stdc {
 
         int umask = -1;
         int process_group = -1;
+
+        struct rlimit_setting {
+            int resource;
+            long long soft;
+            std::optional<long long> hard;
+        };
+        std::vector<rlimit_setting> rlimits;
 #endif
 
     public:
@@ -86,6 +109,7 @@ namespace stdc {
 
         int pid = -1;
         std::optional<int> returncode;
+        std::optional<ResourceUsage> resource_usage;
 
         bool _communication_started = false;
 
@@ -100,6 +124,17 @@ namespace stdc {
         int tid = -1;
 #else
         std::shared_mutex _waitpid_lock;
+
+        // Readable once the child exits, Linux only. Open until the Popen goes, since another
+        // thread may be polling it when the child is reaped. A child of the fork server has
+        // one too, from the server, for signalling it without the pid.
+        int _pidfd = -1;
+
+        // For a child the fork server started, which is its child and not ours: where the
+        // server writes the exit status once it has reaped it, and where signals for it go
+        // where there is no pidfd. Takes the place of waitpid(), and of the pidfd for waiting,
+        // and is kept open for as long for the same reason.
+        int _server_socket = -1;
 #endif
 
         // error data during start
@@ -140,8 +175,31 @@ namespace stdc {
                             int errwrite, int gid, const std::vector<int> &gids, int uid);
 
         /// Everything the child needs, packed so that the code after fork() only reads plain
-        /// memory. Defined in popen_unix.cpp.
-        struct ChildArgs;
+        /// memory.
+        struct ChildArgs {
+            // null terminated arrays, all owned by the caller
+            char *const *exec_array;
+            char *const *argv;
+            char *const *envp; // null to keep our own environment
+
+            const char *cwd; // null to stay put
+
+            // ascending, and the child must not close these
+            const int *fds_to_keep;
+            size_t fds_to_keep_len;
+
+            int p2cread, p2cwrite;
+            int c2pread, c2pwrite;
+            int errread, errwrite;
+            int errpipe_read, errpipe_write;
+
+            int gid, uid; // -1 to leave alone
+            const int *extra_gids;
+            int extra_gids_len; // 0 to leave alone
+
+            // The mask to put back in the child, when it shares our memory. Null for a real fork.
+            const sigset_t *vfork_sigmask;
+        };
 
         /// Forks and runs _child_exec() in the child. Detached mode returns the second child's
         /// pid after waiting for its launcher. Returns -1 for an initial fork failure and 0 for
@@ -151,6 +209,32 @@ namespace stdc {
         /// Runs in the forked child and never returns. Only async signal safe calls belong here.
         void _child_exec(const ChildArgs &ca);
 
+        /// Has the fork server start the child, in place of _fork_exec(), with \a child set as
+        /// _fork_exec() returns it. Defined in forkserver_unix.cpp.
+        ///
+        /// \retval false the server is not running, or cannot start this child as asked, and
+        ///         nothing was done
+        bool _server_fork_exec(const ChildArgs &ca, int &child);
+
+        /// Reads what the fork server reported on _server_socket, waiting for it if \a block.
+        /// Returns whether the child has exited.
+        bool _read_server_exit(bool block);
+
+        /// Has the fork server send \a sig to the child, which it does only while the child is
+        /// not yet reaped and the pid still its own.
+        bool _server_send_signal(int sig);
+
+        /// The fork server itself, run in the process ForkServer::start() forks for it, serving
+        /// requests on \a sock until it closes. Never returns.
+        [[noreturn]] static void _fork_server_main(int sock);
+
+        /// Forks the child one request asks for, in the server, and takes the descriptors that
+        /// came with it.
+        static void _fork_server_spawn(std::string &body, std::vector<int> &fds,
+                                       std::map<int, int> &children,
+                                       const fork_server_signals *signals, int sock,
+                                       const int sigchld_fds[2]);
+
         void _handle_exitstatus(int status);
 
 #endif
@@ -163,8 +247,87 @@ namespace stdc {
         bool send_signal_impl(int sig);
         std::tuple<std::string, std::string> communicate_impl(const std::string &input = {},
                                                               int timeout = -1);
+
+        /// What both communicate() overloads come down to, with each output stream going to a
+        /// sink as it is read. The sinks may be changed on the way: one that fails is dropped.
+        bool communicate_sinks(const std::string &input, Sink &out_sink, Sink &err_sink,
+                               int timeout);
+    };
+
+#ifndef _WIN32
+    /// Ignores SIGPIPE for its lifetime.
+    ///
+    /// A poll loop that asks whether the child is still reading before writing anything, as
+    /// communicate() and ProcessPool do, answers almost every broken pipe by not writing at all.
+    /// What is left is the gap between poll saying the descriptor is writable and the write
+    /// happening: the child can exit in there, and then write raises SIGPIPE and ends the
+    /// process. Nothing about poll closes that gap, so it is closed here.
+    ///
+    /// Measured over 900 rounds of a child that exits at once against a megabyte of input,
+    /// without this: never hit. Narrow is not the same as impossible, and what it costs to be
+    /// sure is two system calls per loop.
+    ///
+    /// \note The disposition belongs to the process, not to this thread, so a program that
+    ///       wanted SIGPIPE to end it does not get that while the loop runs. Children are
+    ///       unaffected, since this is only ever entered after the fork.
+    class sigpipe_guard {
+    public:
+        sigpipe_guard() {
+            struct sigaction ignore{};
+            ignore.sa_handler = SIG_IGN;
+            sigemptyset(&ignore.sa_mask);
+            _installed = sigaction(SIGPIPE, &ignore, &_old) == 0;
+        }
+
+        ~sigpipe_guard() {
+            if (_installed) {
+                sigaction(SIGPIPE, &_old, nullptr);
+            }
+        }
+
+    private:
+        struct sigaction _old{};
+        bool _installed = false;
+
+        STDC_DISABLE_COPY_MOVE(sigpipe_guard)
     };
 
+    /// Closes every descriptor at or above \a start_fd except the ones to \a keep, which are
+    /// sorted. Async signal safe.
+    void close_open_fds(int start_fd, const int *keep, size_t keep_len);
+
+    /// What wait4() reports, in the units ResourceUsage has.
+    Popen::ResourceUsage make_resource_usage(const struct rusage &ru);
+
+    struct sigchld_slot;
+
+    /// Wakes a wait for a child to exit, where there is no pidfd to poll.
+    ///
+    /// The first one made installs a SIGCHLD handler, which passes the signal on to whatever
+    /// was there before. Each waiter takes a slot, and the handler writes a byte to the pipe of
+    /// every slot taken, so all of them wake and each looks at its own children. The pipes are
+    /// made once and never closed: the handler may have read a descriptor just before its waiter
+    /// left, and a closed one could be reused for something that must not be written to.
+    class sigchld_waiter {
+    public:
+        sigchld_waiter();
+        ~sigchld_waiter();
+
+        /// The descriptor to poll, or -1 if there is nothing to wait on and the caller has to
+        /// fall back to sleeping.
+        int fd() const;
+
+        /// Empties the pipe once it has woken somebody. Take this before looking at the child,
+        /// so an exit after the look still wakes the next poll.
+        void drain();
+
+    private:
+        sigchld_slot *_slot = nullptr;
+
+        STDC_DISABLE_COPY_MOVE(sigchld_waiter)
+    };
+#endif
+
 }
 
 #endif // STDCORELIB_POPEN_P_H
@@ -8,9 +8,15 @@
 #include <limits.h>
 #include <grp.h>
 #include <poll.h>
+#include <pthread.h>
+#include <sys/resource.h>
 #include <sys/wait.h>
 #include <sys/stat.h>
 
+#ifdef __linux__
+#  include <sys/syscall.h>
+#endif
+
 #include <csignal>
 #include <cassert>
 #include <cerrno>
@@ -18,10 +24,12 @@
 #include <cstdlib>
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <chrono>
 #include <tuple>
 #include <limits>
 #include <mutex>
+#include <optional>
 #include <thread>
 #include <vector>
 
@@ -30,41 +38,207 @@
 
 namespace stdc {
 
-    /// Ignores SIGPIPE for its lifetime.
-    ///
-    /// The poll loop below asks whether the child is still reading before writing anything, so
-    /// almost every broken pipe is answered by not writing at all. What is left is the gap
-    /// between poll saying the descriptor is writable and the write happening: the child can
-    /// exit in there, and then write raises SIGPIPE and ends the process. Nothing about poll
-    /// closes that gap, so it is closed here.
-    ///
-    /// Measured over 900 rounds of a child that exits at once against a megabyte of input,
-    /// without this: never hit. Narrow is not the same as impossible, and what it costs to be
-    /// sure is two system calls per communicate() call.
-    ///
-    /// \note The disposition belongs to the process, not to this thread, so a program that
-    ///       wanted SIGPIPE to end it does not get that while communicate() runs. Children are
-    ///       unaffected, since this is only ever entered after the fork.
-    class sigpipe_guard {
-    public:
-        sigpipe_guard() {
-            struct sigaction ignore{};
-            ignore.sa_handler = SIG_IGN;
-            sigemptyset(&ignore.sa_mask);
-            _installed = sigaction(SIGPIPE, &ignore, &_old) == 0;
+    // The most one read can bring back, which is what the pipe holds. pipesize() raises it on
+    // Linux, and a read that size empties the pipe in one call where 4 KiB took sixteen.
+    static size_t pipe_capacity(int fd) {
+#ifdef F_GETPIPE_SZ
+        int size = ::fcntl(fd, F_GETPIPE_SZ);
+        if (size > 0) {
+            return size_t(size);
+        }
+#else
+        (void) fd;
+#endif
+        return 65536;
+    }
+
+    // One output stream on its way to its sink, from one readable event to the next.
+    struct sink_pump {
+        Popen::Sink *sink = nullptr;
+        int fd = -1;
+        size_t used = 0; // of the caller's buffer, for a Buffer sink
+#ifdef __linux__
+        bool splice = true; // until the descriptor turns it down
+#endif
+        std::error_code error{};
+
+        // communicate()'s, for waiting on the caller's descriptor, which may be as slow as it
+        // likes but not for longer than the call was given.
+        std::optional<std::chrono::steady_clock::time_point> deadline{};
+        bool timed_out = false;
+
+        int remaining() const {
+            if (!deadline) {
+                return -1;
+            }
+            auto left = std::chrono::ceil<std::chrono::milliseconds>(
+                *deadline - std::chrono::steady_clock::now());
+            return left.count() > 0 ? int(left.count()) : 0;
         }
 
-        ~sigpipe_guard() {
-            if (_installed) {
-                sigaction(SIGPIPE, &_old, nullptr);
+        // False once the deadline has passed, with timed_out set.
+        bool wait_writable() {
+            struct pollfd pfd{sink->fd, POLLOUT, 0};
+            int ready;
+            do {
+                ready = ::poll(&pfd, 1, remaining());
+            } while (ready < 0 && errno == EINTR);
+            if (ready == 0) {
+                timed_out = true;
+                return false;
+            }
+            return true;
+        }
+
+        // A sink that fails is dropped. The stream is still read to the end, since a child
+        // whose pipe nobody drains never finishes.
+        void fail(int err) {
+            if (!error) {
+                error = std::error_code(err, std::generic_category());
+            }
+            sink->kind = Popen::Sink::Discard;
+        }
+
+        void flush_buffer() {
+            if (used > 0 && sink->on_data) {
+                sink->on_data(std::string_view(sink->data, used));
+            }
+            used = 0;
+        }
+
+        bool write_all(const char *data, size_t size) {
+            while (size > 0) {
+                ssize_t n = ::write(sink->fd, data, size);
+                if (n > 0) {
+                    data += n;
+                    size -= size_t(n);
+                    continue;
+                }
+                if (n < 0 && errno == EINTR) {
+                    continue;
+                }
+                if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                    // The caller's descriptor, non-blocking of its own accord.
+                    if (!wait_writable()) {
+                        return false;
+                    }
+                    continue;
+                }
+                return false;
             }
+            return true;
         }
 
-    private:
-        struct sigaction _old{};
-        bool _installed = false;
+        void deliver(const char *data, size_t size) {
+            switch (sink->kind) {
+                case Popen::Sink::Callback:
+                    if (sink->on_data) {
+                        sink->on_data(std::string_view(data, size));
+                    }
+                    break;
+                case Popen::Sink::Buffer:
+                    used += size;
+                    if (used == sink->size) {
+                        flush_buffer();
+                    }
+                    break;
+                case Popen::Sink::FD:
+                    // Running out of time is the call's failure, not the sink's.
+                    if (!write_all(data, size) && !timed_out) {
+                        fail(errno);
+                    }
+                    break;
+                default:
+                    break;
+            }
+        }
 
-        STDC_DISABLE_COPY_MOVE(sigpipe_guard)
+#ifdef __linux__
+        // Pipe to descriptor inside the kernel. 1 for more, 0 at the end of the stream, -1 once
+        // the pipe is empty, and -2 where splice cannot be used and reading has to take over.
+        int splice_some(size_t size) {
+            for (;;) {
+                ssize_t n = ::splice(fd, nullptr, sink->fd, nullptr, size,
+                                     SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+                if (n > 0) {
+                    return 1;
+                }
+                if (n == 0) {
+                    return 0;
+                }
+                if (errno == EINTR) {
+                    continue;
+                }
+                if (errno == EAGAIN) {
+                    // Either end may have said it. A pipe still readable means the other end is
+                    // full, so that is what to wait for.
+                    struct pollfd in{fd, POLLIN, 0};
+                    if (::poll(&in, 1, 0) > 0 && (in.revents & POLLIN)) {
+                        if (!wait_writable()) {
+                            return -1;
+                        }
+                        continue;
+                    }
+                    return -1;
+                }
+                // A file opened for appending, or one whose filesystem has no splice.
+                if (errno == EINVAL || errno == ENOSYS) {
+                    splice = false;
+                    return -2;
+                }
+                fail(errno);
+                return -2;
+            }
+        }
+#endif
+
+        // Until it would block, since one readable event can carry more than one pipeful. False
+        // at the end of the stream, or when reading it failed.
+        bool drain(std::unique_ptr<char[]> &scratch, size_t scratch_size) {
+            for (;;) {
+#ifdef __linux__
+                if (sink->kind == Popen::Sink::FD && splice) {
+                    int more = splice_some(scratch_size);
+                    if (more >= 0) {
+                        if (more == 0) {
+                            return false;
+                        }
+                        continue;
+                    }
+                    if (more == -1) {
+                        return true;
+                    }
+                }
+#endif
+                char *dest;
+                size_t room;
+                if (sink->kind == Popen::Sink::Buffer) {
+                    dest = sink->data + used;
+                    room = sink->size - used;
+                } else {
+                    if (!scratch) {
+                        scratch.reset(new char[scratch_size]);
+                    }
+                    dest = scratch.get();
+                    room = scratch_size;
+                }
+                ssize_t n = ::read(fd, dest, room);
+                if (n > 0) {
+                    deliver(dest, size_t(n));
+                    if (timed_out) {
+                        return true;
+                    }
+                    continue;
+                }
+                if (n == 0) {
+                    return false;
+                }
+                if (errno == EINTR) {
+                    continue;
+                }
+                return errno == EAGAIN || errno == EWOULDBLOCK;
+            }
+        }
     };
 
     // https://github.com/python/cpython/blob/v3.13.13/Lib/subprocess.py#L2094
@@ -81,19 +255,19 @@ namespace stdc {
     // \note Reads go straight to the descriptor. Anything a caller already pulled out through
     //       stdin_(), stdout_() or stderr_() into the stream's own buffer is theirs and is not
     //       seen here, which was true of the thread version as well.
-    std::tuple<std::string, std::string> Popen::Impl::communicate_impl(const std::string &input,
-                                                                       int timeout) {
+    bool Popen::Impl::communicate_sinks(const std::string &input, Sink &out_sink, Sink &err_sink,
+                                        int timeout) {
         error_code.clear();
 
         // Same answer as the other five, rather than the no_such_process the check below would
         // give. A detached child exists, it is just not ours to talk to.
         if (_detached_started) {
             error_code = std::make_error_code(std::errc::operation_not_supported);
-            return {};
+            return false;
         }
         if (!_child_created) {
             error_code = std::make_error_code(std::errc::no_such_process);
-            return {};
+            return false;
         }
 
         // Whatever the caller wrote through the stream goes out ahead of the input given here,
@@ -102,13 +276,14 @@ namespace stdc {
             stdin_stream.flush();
         }
 
-        int in_fd = stdin_stream.is_open() ? ::fileno(stdin_stream.file()) : -1;
-        int out_fd = stdout_stream.is_open() ? ::fileno(stdout_stream.file()) : -1;
-        int err_fd = stderr_stream.is_open() ? ::fileno(stderr_stream.file()) : -1;
+        int in_fd = stdin_stream.fd();
+        sink_pump out{&out_sink, stdout_stream.fd()};
+        sink_pump err{&err_sink, stderr_stream.fd()};
 
         // Non-blocking, so that neither a full pipe nor an empty one can hold the loop still
         // while another stream has something to say.
-        for (int fd : {in_fd, out_fd, err_fd}) {
+        size_t scratch_size = 0;
+        for (int fd : {in_fd, out.fd, err.fd}) {
             if (fd < 0) {
                 continue;
             }
@@ -116,13 +291,27 @@ namespace stdc {
             if (flags >= 0) {
                 std::ignore = ::fcntl(fd, F_SETFL, flags | O_NONBLOCK);
             }
+            if (fd != in_fd) {
+                scratch_size = std::max(scratch_size, pipe_capacity(fd));
+            }
+        }
+        // Only made if a stream needs it, which one going to a buffer or through splice does
+        // not.
+        std::unique_ptr<char[]> scratch;
+        for (auto *sink : {&out_sink, &err_sink}) {
+            // A buffer with no room in it is no buffer.
+            if (sink->kind == Sink::Buffer && (!sink->data || sink->size == 0)) {
+                sink->kind = Sink::Callback;
+            }
         }
 
-        std::string out, err;
         size_t written = 0;
         bool timed_out = false;
 
         const auto started = std::chrono::steady_clock::now();
+        if (timeout >= 0) {
+            out.deadline = err.deadline = started + std::chrono::milliseconds(timeout);
+        }
         const auto &remaining = [&]() -> int {
             if (timeout < 0) {
                 return -1;
@@ -140,32 +329,13 @@ namespace stdc {
             in_fd = -1;
         }
 
-        const auto &drain = [](int fd, std::string &dest) {
-            // Until it would block. One readable event can carry more than one bufferful.
-            char buf[4096];
-            for (;;) {
-                ssize_t n = ::read(fd, buf, sizeof(buf));
-                if (n > 0) {
-                    dest.append(buf, size_t(n));
-                    continue;
-                }
-                if (n == 0) {
-                    return false; // end of it
-                }
-                if (errno == EINTR) {
-                    continue;
-                }
-                return errno == EAGAIN || errno == EWOULDBLOCK;
-            }
-        };
-
         _communication_started = true;
 
         // Held across the whole loop rather than taken and put back around each write, which
         // would be two system calls per turn of it.
         sigpipe_guard guard;
 
-        while (in_fd >= 0 || out_fd >= 0 || err_fd >= 0) {
+        while (in_fd >= 0 || out.fd >= 0 || err.fd >= 0) {
             struct pollfd fds[3] {};
             int count = 0;
             int in_slot = -1, out_slot = -1, err_slot = -1;
@@ -173,12 +343,12 @@ namespace stdc {
                 fds[count] = {in_fd, POLLOUT, 0};
                 in_slot = count++;
             }
-            if (out_fd >= 0) {
-                fds[count] = {out_fd, POLLIN, 0};
+            if (out.fd >= 0) {
+                fds[count] = {out.fd, POLLIN, 0};
                 out_slot = count++;
             }
-            if (err_fd >= 0) {
-                fds[count] = {err_fd, POLLIN, 0};
+            if (err.fd >= 0) {
+                fds[count] = {err.fd, POLLIN, 0};
                 err_slot = count++;
             }
 
@@ -218,13 +388,19 @@ namespace stdc {
                     }
                 }
             }
-            if (out_slot >= 0 && fds[out_slot].revents && !drain(out_fd, out)) {
-                out_fd = -1;
+            if (out_slot >= 0 && fds[out_slot].revents && !out.drain(scratch, scratch_size)) {
+                out.fd = -1;
+            }
+            if (err_slot >= 0 && fds[err_slot].revents && !err.drain(scratch, scratch_size)) {
+                err.fd = -1;
             }
-            if (err_slot >= 0 && fds[err_slot].revents && !drain(err_fd, err)) {
-                err_fd = -1;
+            if (out.timed_out || err.timed_out) {
+                timed_out = true;
+                break;
             }
         }
+        out.flush_buffer();
+        err.flush_buffer();
 
         // A timeout kills the child rather than leaving it behind.
         if (timed_out || !_wait(remaining())) {
@@ -236,7 +412,10 @@ namespace stdc {
         }
 
         close_std_files();
-        return {out, err};
+        if (!error_code) {
+            error_code = out.error ? out.error : err.error;
+        }
+        return !error_code;
     }
 
     static inline std::error_code make_last_error_code() {
@@ -273,7 +452,16 @@ namespace stdc {
     }
 
     void Popen::Impl::_reap() {
-        // Nothing to release here: waitpid() has already reaped the child.
+        // waitpid() has already reaped the child, which leaves only the pidfd, or the fork
+        // server has, which leaves the pidfd and the socket it reported on.
+        if (_pidfd != -1) {
+            close(_pidfd);
+            _pidfd = -1;
+        }
+        if (_server_socket != -1) {
+            close(_server_socket);
+            _server_socket = -1;
+        }
     }
 
     void Popen::Impl::_cleanup() {
@@ -538,32 +726,153 @@ namespace stdc {
         }
     }
 
-    struct Popen::Impl::ChildArgs {
-        // null terminated arrays, all owned by the caller
-        char *const *exec_array;
-        char *const *argv;
-        char *const *envp; // null to keep our own environment
+#ifdef __linux__
+    // https://github.com/python/cpython/blob/v3.13.13/Modules/_posixsubprocess.c#L1008
+    //
+    // fork() copies the page tables of the whole process, which for a parent with gigabytes
+    // resident is milliseconds per child, and more again once copy on write starts faulting
+    // pages in. vfork() copies nothing: the child runs in our memory, with us suspended, until
+    // it execs or exits. What it does there is the same async signal safe code fork() would run.
+    //
+    // Three things stop that from being safe, and those take the fork() path:
+    //   - preexec_fn, which is arbitrary code and could write anywhere in our memory;
+    //   - user(), group() and extra_groups(), because glibc changes credentials by signalling
+    //     every thread of the process, and the threads it finds in shared memory are ours;
+    //   - a signal handler running in the child, which is shut out by blocking every signal
+    //     around the call and resetting the handlers in the child before unblocking them.
+#  define STDC_POPEN_VFORK
+#endif
 
-        const char *cwd; // null to stay put
+#ifdef STDC_POPEN_VFORK
+    /// Sets every caught signal back to its default, except the ones that stay blocked until
+    /// exec, which resets them anyway. A handler left in place would run on our memory.
+    static void reset_signal_handlers(const sigset_t *blocked) {
+        for (int sig = 1; sig < NSIG; ++sig) {
+            if (sig == SIGKILL || sig == SIGSTOP || sigismember(blocked, sig) == 1) {
+                continue;
+            }
+            struct sigaction sa;
+            if (sigaction(sig, nullptr, &sa) == -1) {
+                continue; // one of the C library's own
+            }
+            if (sa.sa_handler != SIG_IGN && sa.sa_handler != SIG_DFL) {
+                signal(sig, SIG_DFL);
+            }
+        }
+    }
+#endif
 
-        // ascending, and the child must not close these
-        const int *fds_to_keep;
-        size_t fds_to_keep_len;
+#ifdef __linux__
+#  ifndef CLOSE_RANGE_CLOEXEC
+#    define CLOSE_RANGE_CLOEXEC (1U << 2)
+#  endif
+
+    /// Calls \a close_from_to for every run of descriptors at or above \a start_fd that none
+    /// of the \a keep fall in, the last of them open ended. Stops at the first that fails.
+    template <class F>
+    static bool for_each_gap(int start_fd, const int *keep, size_t keep_len, F close_from_to) {
+        unsigned int from = unsigned(start_fd);
+        for (size_t i = 0; i < keep_len; ++i) {
+            if (keep[i] < start_fd) {
+                continue;
+            }
+            unsigned int kept = unsigned(keep[i]);
+            if (kept > from && !close_from_to(from, kept - 1)) {
+                return false;
+            }
+            from = kept + 1;
+        }
+        return close_from_to(from, ~0U);
+    }
 
-        int p2cread, p2cwrite;
-        int c2pread, c2pwrite;
-        int errread, errwrite;
-        int errpipe_read, errpipe_write;
+    /// close_range(2), in as few calls as there are gaps between the descriptors to keep.
+    ///
+    /// Marking them close on exec rather than closing them leaves the closing to the exec that
+    /// comes next, which does it anyway, and keeps this to one pass over the table. Kernels
+    /// before 5.11 do not know the flag and are asked to close them instead.
+    static bool close_range_fds(int start_fd, const int *keep, size_t keep_len) {
+#  ifdef SYS_close_range
+        unsigned int flags = CLOSE_RANGE_CLOEXEC;
+        const auto &close_range = [&flags](unsigned int first, unsigned int last) {
+            return syscall(SYS_close_range, first, last, flags) == 0;
+        };
+        if (for_each_gap(start_fd, keep, keep_len, close_range)) {
+            return true;
+        }
+        if (errno != EINVAL) {
+            return false; // ENOSYS, or a seccomp filter that says so
+        }
+        flags = 0;
+        return for_each_gap(start_fd, keep, keep_len, close_range);
+#  else
+        (void) start_fd, (void) keep, (void) keep_len;
+        return false;
+#  endif
+    }
 
-        int gid, uid; // -1 to leave alone
-        const int *extra_gids;
-        int extra_gids_len; // 0 to leave alone
+    // https://github.com/python/cpython/blob/v3.13.13/Modules/_posixsubprocess.c#L487
+    //
+    // What getdents64 fills the buffer with. glibc declares no such thing, and readdir() is not
+    // async signal safe, since it allocates.
+    struct linux_dirent64 {
+        uint64_t d_ino;
+        int64_t d_off;
+        unsigned short d_reclen;
+        unsigned char d_type;
+        char d_name[256];
     };
 
+    /// Closes what /proc/self/fd lists, which is what is open and nothing else, rather than
+    /// every number up to the limit. Closing while the listing goes on is safe on procfs.
+    static bool close_listed_fds(int start_fd, const int *keep, size_t keep_len) {
+        int dir = open("/proc/self/fd", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (dir == -1) {
+            return false;
+        }
+        alignas(linux_dirent64) char buf[4096];
+        for (;;) {
+            long n = syscall(SYS_getdents64, dir, buf, sizeof(buf));
+            if (n <= 0) {
+                break;
+            }
+            for (long offset = 0; offset < n;) {
+                auto entry = reinterpret_cast<const linux_dirent64 *>(buf + offset);
+                offset += entry->d_reclen;
+
+                int fd = 0;
+                const char *c = entry->d_name;
+                if (*c < '0' || *c > '9') {
+                    continue; // . and ..
+                }
+                for (; *c >= '0' && *c <= '9'; ++c) {
+                    fd = fd * 10 + (*c - '0');
+                }
+                if (fd < start_fd || fd == dir || std::binary_search(keep, keep + keep_len, fd)) {
+                    continue;
+                }
+                close(fd);
+            }
+        }
+        close(dir);
+        return true;
+    }
+#endif
+
     // https://github.com/python/cpython/blob/v3.13.13/Modules/_posixsubprocess.c#L575
     //
     // Closes every descriptor at or above start_fd except the ones to keep, which must be sorted.
-    static void close_open_fds(int start_fd, const int *keep, size_t keep_len) {
+    //
+    // A loop up to the descriptor limit is a million close() calls on a host that raises it that
+    // far, which is tens of milliseconds a child. Linux can say what is open instead, and newer
+    // kernels take the whole range in one call, so the loop is only what is left when neither
+    // is there.
+    void close_open_fds(int start_fd, const int *keep, size_t keep_len) {
+#ifdef __linux__
+        if (close_range_fds(start_fd, keep, keep_len) ||
+            close_listed_fds(start_fd, keep, keep_len)) {
+            return;
+        }
+#endif
         long open_max = sysconf(_SC_OPEN_MAX);
         if (open_max < 0 || open_max > 1 << 20) {
             open_max = 1 << 20;
@@ -617,6 +926,15 @@ namespace stdc {
 
         // Returns only on failure, with errno set.
         const auto &run = [&]() {
+#ifdef STDC_POPEN_VFORK
+            if (ca.vfork_sigmask) {
+                reset_signal_handlers(ca.vfork_sigmask);
+                if (int err = pthread_sigmask(SIG_SETMASK, ca.vfork_sigmask, nullptr)) {
+                    errno = err;
+                    return;
+                }
+            }
+#endif
             for (size_t i = 0; i < ca.fds_to_keep_len; ++i) {
                 // errpipe_write is in this list but must stay close-on-exec. Its closing is what
                 // tells the parent that exec succeeded.
@@ -695,6 +1013,22 @@ namespace stdc {
             if (process_group >= 0 && setpgid(0, process_group) == -1) {
                 return;
             }
+            // Before dropping privileges, which may be what allows a ceiling to be raised.
+            for (const auto &setting : rlimits) {
+                struct rlimit limit;
+                if (getrlimit(setting.resource, &limit) == -1) {
+                    err_msg = "noexec:setrlimit";
+                    return;
+                }
+                limit.rlim_cur = setting.soft < 0 ? RLIM_INFINITY : rlim_t(setting.soft);
+                if (setting.hard) {
+                    limit.rlim_max = *setting.hard < 0 ? RLIM_INFINITY : rlim_t(*setting.hard);
+                }
+                if (setrlimit(setting.resource, &limit) == -1) {
+                    err_msg = "noexec:setrlimit";
+                    return;
+                }
+            }
             if (ca.extra_gids_len > 0 &&
                 setgroups(size_t(ca.extra_gids_len),
                           reinterpret_cast<const gid_t *>(ca.extra_gids)) == -1) {
@@ -752,7 +1086,18 @@ namespace stdc {
                 return -1;
             }
 
-            pid_t launcher = fork();
+            // The launcher and the child both share our memory when vfork() is safe. The
+            // launcher is then suspended until the child execs, and we until the launcher exits,
+            // which is the order the pid pipe is read in anyway.
+            pid_t launcher;
+#ifdef STDC_POPEN_VFORK
+            if (ca.vfork_sigmask) {
+                launcher = vfork();
+            } else
+#endif
+            {
+                launcher = fork();
+            }
             if (launcher == 0) {
                 close(pidpipe_read);
                 if (setsid() == -1) {
@@ -762,7 +1107,15 @@ namespace stdc {
                     _exit(255);
                 }
 
-                pid_t child = fork();
+                pid_t child;
+#ifdef STDC_POPEN_VFORK
+                if (ca.vfork_sigmask) {
+                    child = vfork();
+                } else
+#endif
+                {
+                    child = fork();
+                }
                 if (child == 0) {
                     close(pidpipe_write);
                     _child_exec(ca);
@@ -823,7 +1176,17 @@ namespace stdc {
             return left == 0 && WIFEXITED(status) && WEXITSTATUS(status) == 0 ? int(child) : 0;
         }
 
-        pid_t child = fork();
+        // Called here rather than in a helper: a vfork() child must not return from the function
+        // that made it, or it pulls the frame out from under us.
+        pid_t child;
+#ifdef STDC_POPEN_VFORK
+        if (ca.vfork_sigmask) {
+            child = vfork();
+        } else
+#endif
+        {
+            child = fork();
+        }
         if (child == 0) {
             _child_exec(ca);
             _exit(255);
@@ -1027,12 +1390,40 @@ namespace stdc {
         ca.uid = uid;
         ca.extra_gids = gids.data();
         ca.extra_gids_len = int(gids.size());
+        ca.vfork_sigmask = nullptr;
+
+        // A fork server, when one is running, forks from its own small address space instead.
+        // Nothing about the child is any different for it.
+        int tmp_pid = -1;
+        bool via_server = _server_fork_exec(ca, tmp_pid);
+
+#ifdef STDC_POPEN_VFORK
+        // Nothing a handler does can reach the child while every signal is blocked, and the
+        // child puts the mask back once its handlers are gone.
+        sigset_t old_sigmask;
+        if (!via_server && !preexec_fn && gid == -1 && uid == -1 && gids.empty()) {
+            sigset_t all;
+            sigfillset(&all);
+            if (pthread_sigmask(SIG_BLOCK, &all, &old_sigmask) == 0) {
+                ca.vfork_sigmask = &old_sigmask;
+            }
+        }
+#endif
 
         std::string errpipe_data;
 
         // https://github.com/python/cpython/blob/v3.13.13/Lib/subprocess.py#L1921
         {
-            int tmp_pid = _fork_exec(ca);
+            if (!via_server) {
+                tmp_pid = _fork_exec(ca);
+            }
+#ifdef STDC_POPEN_VFORK
+            if (ca.vfork_sigmask) {
+                int saved_errno = errno;
+                pthread_sigmask(SIG_SETMASK, ca.vfork_sigmask, nullptr);
+                errno = saved_errno;
+            }
+#endif
             if (tmp_pid == -1) {
                 auto err = make_last_error_code();
                 close(errpipe_read);
@@ -1076,10 +1467,22 @@ namespace stdc {
             return false;
         }
         if (errpipe_data.empty()) {
+#if defined(__linux__) && defined(SYS_pidfd_open)
+            // Only what is ours to wait for. Failing, on kernels before 5.3, leaves the waits
+            // to the SIGCHLD handler.
+            if (_child_created && _server_socket == -1) {
+                _pidfd = int(syscall(SYS_pidfd_open, pid, 0));
+            }
+#endif
             return true;
         }
 
-        if (_child_created) {
+        if (_child_created && _server_socket != -1) {
+            // The server reaps it, and says so.
+            std::ignore = _read_server_exit(true);
+            close(_server_socket);
+            _server_socket = -1;
+        } else if (_child_created) {
             // A normal child is still ours, so collect its failed pre-exec status.
             int status;
             pid_t ret_pid;
@@ -1115,13 +1518,46 @@ namespace stdc {
         }
 
         error_code = std::error_code(err_val, std::system_category());
-        // "noexec:chdir" names the working directory, anything else names the program.
-        error_msg =
-            formatN("%1: %2", detail == "noexec:chdir" ? cwd_str : child_executable.string(),
-                    error_code.message());
+        // "noexec:chdir" names the working directory, "noexec:setrlimit" the call that refused
+        // a limit, and anything else names the program.
+        std::string subject = child_executable.string();
+        if (detail == "noexec:chdir") {
+            subject = cwd_str;
+        } else if (detail == "noexec:setrlimit") {
+            subject = "setrlimit";
+        }
+        error_msg = formatN("%1: %2", subject, error_code.message());
         return false;
     }
 
+    // waitpid() that keeps what the kernel accounted for the child along with its status. The
+    // two are handed back by the same call or not at all.
+    Popen::ResourceUsage make_resource_usage(const struct rusage &ru) {
+        Popen::ResourceUsage result;
+        result.user_time = std::chrono::seconds(ru.ru_utime.tv_sec) +
+                           std::chrono::microseconds(ru.ru_utime.tv_usec);
+        result.system_time = std::chrono::seconds(ru.ru_stime.tv_sec) +
+                             std::chrono::microseconds(ru.ru_stime.tv_usec);
+#ifdef __APPLE__
+        result.max_rss = ru.ru_maxrss; // bytes here, kilobytes everywhere else
+#else
+        result.max_rss = (long long) ru.ru_maxrss * 1024;
+#endif
+        result.voluntary_switches = ru.ru_nvcsw;
+        result.involuntary_switches = ru.ru_nivcsw;
+        return result;
+    }
+
+    static pid_t wait_and_account(pid_t pid, int &status, int options,
+                                  std::optional<Popen::ResourceUsage> &usage) {
+        struct rusage ru;
+        pid_t ret = ::wait4(pid, &status, options, &ru);
+        if (ret == pid) {
+            usage = make_resource_usage(ru);
+        }
+        return ret;
+    }
+
     void Popen::Impl::_handle_exitstatus(int status) {
         if (WIFSTOPPED(status)) {
             returncode = -WSTOPSIG(status);
@@ -1132,6 +1568,112 @@ namespace stdc {
         }
     }
 
+    struct sigchld_slot {
+        std::atomic<bool> busy{false};
+        std::atomic<int> write_fd{-1}; // set once, never closed
+        int read_fd = -1;              // the owner's alone
+    };
+
+    // As many as wait at the same time. The rest sleep and poll.
+    static sigchld_slot sigchld_slots[64];
+    static struct sigaction sigchld_previous;
+
+    static bool make_nonblocking_pipe(int &read_fd, int &write_fd) {
+        if (!make_pipe(read_fd, write_fd)) {
+            return false;
+        }
+        for (int fd : {read_fd, write_fd}) {
+            fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+        }
+        return true;
+    }
+
+    static void sigchld_handler(int sig, siginfo_t *info, void *context) {
+        int saved_errno = errno;
+        for (auto &slot : sigchld_slots) {
+            int fd = slot.busy.load() ? slot.write_fd.load() : -1;
+            if (fd != -1) {
+                char byte = 0;
+                std::ignore = write(fd, &byte, 1); // a full pipe is already readable
+            }
+        }
+        errno = saved_errno;
+
+        if (sigchld_previous.sa_flags & SA_SIGINFO) {
+            if (sigchld_previous.sa_sigaction) {
+                sigchld_previous.sa_sigaction(sig, info, context);
+            }
+        } else if (sigchld_previous.sa_handler != SIG_DFL &&
+                   sigchld_previous.sa_handler != SIG_IGN) {
+            sigchld_previous.sa_handler(sig);
+        }
+    }
+
+    /// Once per process. Ignoring SIGCHLD, or SA_NOCLDWAIT, has the system reap children without
+    /// waiting, and a handler in their place would quietly undo that.
+    static bool install_sigchld_handler() {
+        static const bool installed = [] {
+            struct sigaction current{};
+            if (sigaction(SIGCHLD, nullptr, &current) != 0) {
+                return false;
+            }
+            bool ignored = !(current.sa_flags & SA_SIGINFO) && current.sa_handler == SIG_IGN;
+            if (ignored || (current.sa_flags & SA_NOCLDWAIT)) {
+                return false;
+            }
+            sigchld_previous = current;
+
+            struct sigaction sa{};
+            sa.sa_sigaction = sigchld_handler;
+            sa.sa_mask = current.sa_mask;
+            sa.sa_flags = SA_SIGINFO | SA_RESTART | (current.sa_flags & SA_NOCLDSTOP);
+            return sigaction(SIGCHLD, &sa, nullptr) == 0;
+        }();
+        return installed;
+    }
+
+    sigchld_waiter::sigchld_waiter() {
+        if (!install_sigchld_handler()) {
+            return;
+        }
+        for (auto &slot : sigchld_slots) {
+            bool expected = false;
+            if (!slot.busy.compare_exchange_strong(expected, true)) {
+                continue;
+            }
+            if (slot.read_fd == -1) {
+                int read_fd, write_fd;
+                if (!make_nonblocking_pipe(read_fd, write_fd)) {
+                    slot.busy.store(false);
+                    return;
+                }
+                slot.read_fd = read_fd;
+                slot.write_fd.store(write_fd);
+            }
+            _slot = &slot;
+            // What the last waiter in this slot left behind. A signal from before now is covered
+            // by looking at the child after this.
+            drain();
+            return;
+        }
+    }
+
+    sigchld_waiter::~sigchld_waiter() {
+        if (_slot) {
+            _slot->busy.store(false);
+        }
+    }
+
+    int sigchld_waiter::fd() const {
+        return _slot ? _slot->read_fd : -1;
+    }
+
+    void sigchld_waiter::drain() {
+        char buf[64];
+        while (read(_slot->read_fd, buf, sizeof(buf)) > 0) {
+        }
+    }
+
     bool Popen::Impl::_internal_poll() {
         error_code.clear();
 
@@ -1156,9 +1698,12 @@ namespace stdc {
         if (returncode) {
             return true;
         }
+        if (_server_socket != -1) {
+            return _read_server_exit(false);
+        }
 
         int status;
-        pid_t ret = waitpid(pid, &status, WNOHANG);
+        pid_t ret = wait_and_account(pid, status, WNOHANG, resource_usage);
         if (ret == pid) {
             _handle_exitstatus(status);
             return true;
@@ -1203,8 +1748,12 @@ namespace stdc {
                 if (returncode) {
                     break;
                 }
+                if (_server_socket != -1) {
+                    std::ignore = _read_server_exit(true);
+                    break;
+                }
                 int status;
-                pid_t ret = waitpid(pid, &status, 0);
+                pid_t ret = wait_and_account(pid, status, 0, resource_usage);
                 if (ret == pid) {
                     _handle_exitstatus(status);
                     break;
@@ -1225,8 +1774,60 @@ namespace stdc {
             return true;
         }
 
-        // waitpid has no deadline, so poll with a delay that grows to 50 ms, as Python does.
         auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout);
+        const auto &remaining_ms = [&deadline]() {
+            auto left = std::chrono::ceil<std::chrono::milliseconds>(
+                deadline - std::chrono::steady_clock::now());
+            return left.count() > 0 ? int(left.count()) : 0;
+        };
+
+        // Something that turns readable when the child exits, so that the wait is one poll()
+        // that wakes when it should, rather than a sleep that finds out afterwards.
+        std::optional<sigchld_waiter> waiter;
+        int exit_fd = _server_socket != -1 ? _server_socket : _pidfd;
+        if (exit_fd == -1) {
+            waiter.emplace();
+            exit_fd = waiter->fd();
+        }
+        if (exit_fd != -1) {
+            while (true) {
+                if (_internal_poll()) {
+                    return true;
+                }
+                if (error_code.value() != 0) {
+                    return false;
+                }
+                int wait_ms = remaining_ms();
+                if (wait_ms == 0) {
+                    return false;
+                }
+                // Some other code may take SIGCHLD over after we did, and then nothing wakes
+                // us. Once a second is what that costs, rather than the whole timeout.
+                if (waiter) {
+                    wait_ms = std::min(wait_ms, 1000);
+                }
+
+                struct pollfd pfd = {exit_fd, POLLIN, 0};
+                int ready = ::poll(&pfd, 1, wait_ms);
+                if (ready < 0 && errno != EINTR) {
+                    error_code = make_last_error_code();
+                    error_api = "poll";
+                    return false;
+                }
+                if (ready > 0) {
+                    if (waiter) {
+                        waiter->drain();
+                    } else {
+                        // Exited, so whoever holds the lock is reaping it and will be done at
+                        // once. Waiting for them beats spinning on a pidfd that stays readable.
+                        std::unique_lock<std::shared_mutex> lock(_waitpid_lock);
+                    }
+                }
+            }
+        }
+
+        // Nothing to poll, and waitpid has no deadline, so poll with a delay that grows to
+        // 50 ms, as Python does.
         auto delay = std::chrono::microseconds(500);
         while (true) {
             if (_internal_poll()) {
@@ -1276,6 +1877,24 @@ namespace stdc {
             return false;
         }
 
+#if defined(__linux__) && defined(SYS_pidfd_send_signal)
+        // A pidfd stays with its process, so the signal cannot reach another that took the pid
+        // over. For a child of the fork server, which reaps it without waiting for us, this is
+        // what keeps a late kill() from doing so.
+        if (_pidfd != -1) {
+            if (syscall(SYS_pidfd_send_signal, _pidfd, sig, nullptr, 0) == 0 || errno == ESRCH) {
+                return true;
+            }
+            if (errno != ENOSYS) {
+                error_code = make_last_error_code();
+                return false;
+            }
+        }
+#endif
+        if (_server_socket != -1) {
+            return _server_send_signal(sig);
+        }
+
         if (::kill(pid, sig) == 0) {
             return true;
         }
@@ -6,7 +6,11 @@
 #include <fcntl.h>
 #include <io.h>
 
+#include "stdc_windows.h" // <Psapi.h> needs <windows.h> first
+#include <Psapi.h>
+
 #include <array>
+#include <mutex>
 #include <thread>
 #include <algorithm>
 #include <cassert>
@@ -38,6 +42,81 @@ namespace stdc {
 #endif
     }
 
+    // One output stream on its way to its sink, on a thread of its own. The mutex is shared by
+    // both streams, so that the caller's callback never runs twice at once.
+    static void pump_to_sink(int fd, Popen::Sink &sink, std::mutex &mutex, std::error_code &error) {
+        // What one ReadFile on the pipe is asked for. Nothing on this platform says how large
+        // the pipe is, and the read returns as soon as anything is there, so this is only the
+        // most one read can bring.
+        constexpr size_t scratch_size = 65536;
+        std::unique_ptr<char[]> scratch;
+        size_t used = 0;
+
+        const auto &flush_buffer = [&]() {
+            if (used > 0 && sink.on_data) {
+                std::lock_guard<std::mutex> lock(mutex);
+                sink.on_data(std::string_view(sink.data, used));
+            }
+            used = 0;
+        };
+
+        for (;;) {
+            char *dest;
+            size_t room;
+            if (sink.kind == Popen::Sink::Buffer) {
+                dest = sink.data + used;
+                room = sink.size - used;
+            } else {
+                if (!scratch) {
+                    scratch.reset(new char[scratch_size]);
+                }
+                dest = scratch.get();
+                room = scratch_size;
+            }
+            // One read of the descriptor returns with whatever the child has written so far.
+            int n = ::_read(fd, dest, unsigned(room));
+            if (n <= 0) {
+                break;
+            }
+            switch (sink.kind) {
+                case Popen::Sink::Callback:
+                    if (sink.on_data) {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        sink.on_data(std::string_view(dest, size_t(n)));
+                    }
+                    break;
+                case Popen::Sink::Buffer:
+                    used += size_t(n);
+                    if (used == sink.size) {
+                        flush_buffer();
+                    }
+                    break;
+                case Popen::Sink::FD: {
+                    const char *p = dest;
+                    size_t left = size_t(n);
+                    while (left > 0) {
+                        int w = ::_write(sink.fd, p, unsigned(left));
+                        if (w <= 0) {
+                            break;
+                        }
+                        p += w;
+                        left -= size_t(w);
+                    }
+                    if (left > 0) {
+                        // Dropped for the rest of the stream, which is still read so that the
+                        // child can finish.
+                        error = std::error_code(errno, std::generic_category());
+                        sink.kind = Popen::Sink::Discard;
+                    }
+                    break;
+                }
+                default:
+                    break;
+            }
+        }
+        flush_buffer();
+    }
+
     // https://github.com/python/cpython/blob/v3.13.13/Lib/subprocess.py#L1623
     //
     // A pipe blocks its writer once full, so stdout and stderr cannot be drained one after the
@@ -45,44 +124,47 @@ namespace stdc {
     // at once, and on Windows an anonymous pipe cannot be waited on, so the only way to have
     // three things move at once is three threads. Python reaches the same conclusion here, and
     // polls instead on unix, which is what popen_unix.cpp does.
-    std::tuple<std::string, std::string> Popen::Impl::communicate_impl(const std::string &input,
-                                                                       int timeout) {
+    bool Popen::Impl::communicate_sinks(const std::string &input, Sink &out_sink, Sink &err_sink,
+                                        int timeout) {
         error_code.clear();
 
         // Same answer as the other five, rather than the no_such_process the check below would
         // give. A detached child exists, it is just not ours to talk to.
         if (_detached_started) {
             error_code = std::make_error_code(std::errc::operation_not_supported);
-            return {};
+            return false;
         }
 
         if (!_child_created) {
             error_code = std::make_error_code(std::errc::no_such_process);
-            return {};
+            return false;
+        }
+
+        for (auto *sink : {&out_sink, &err_sink}) {
+            // A buffer with no room in it is no buffer.
+            if (sink->kind == Sink::Buffer && (!sink->data || sink->size == 0)) {
+                sink->kind = Sink::Callback;
+            }
         }
 
-        std::string out, err;
+        std::mutex sink_mutex;
+        std::error_code out_sink_error, err_sink_error;
         std::thread out_thread, err_thread, in_thread;
         std::exception_ptr out_error, err_error, in_error;
 
-        const auto &read_all = [](FILE *file, std::string &dest, std::exception_ptr &error) {
-            run_capturing(error, [&] {
-                char buf[4096];
-                size_t n;
-                while ((n = std::fread(buf, 1, sizeof(buf), file)) > 0) {
-                    dest.append(buf, n);
-                }
-            });
+        const auto &read_all = [&sink_mutex](int fd, Sink &sink, std::error_code &sink_error,
+                                             std::exception_ptr &error) {
+            run_capturing(error, [&] { pump_to_sink(fd, sink, sink_mutex, sink_error); });
         };
 
         const auto &start_workers = [&] {
             if (stdout_stream.is_open()) {
-                out_thread =
-                    std::thread(read_all, stdout_stream.file(), std::ref(out), std::ref(out_error));
+                out_thread = std::thread(read_all, stdout_stream.fd(), std::ref(out_sink),
+                                         std::ref(out_sink_error), std::ref(out_error));
             }
             if (stderr_stream.is_open()) {
-                err_thread =
-                    std::thread(read_all, stderr_stream.file(), std::ref(err), std::ref(err_error));
+                err_thread = std::thread(read_all, stderr_stream.fd(), std::ref(err_sink),
+                                         std::ref(err_sink_error), std::ref(err_error));
             }
 
             // Input has its own worker too. Otherwise a child that never reads can fill the pipe
@@ -149,15 +231,43 @@ namespace stdc {
             std::rethrow_exception(out_error);
         if (err_error)
             std::rethrow_exception(err_error);
-        return {out, err};
+
+        if (!error_code) {
+            error_code = out_sink_error ? out_sink_error : err_sink_error;
+        }
+        return !error_code;
     }
 
     using namespace winapi;
 
     constexpr UINT KillProcessExitCode = 0xf291;
 
+    // FILETIME counts in 100 ns ticks.
+    static std::chrono::microseconds filetime_to_us(const FILETIME &time) {
+        ULARGE_INTEGER ticks;
+        ticks.LowPart = time.dwLowDateTime;
+        ticks.HighPart = time.dwHighDateTime;
+        return std::chrono::microseconds(ticks.QuadPart / 10);
+    }
+
     void Popen::Impl::_reap() {
         if (_handle != InvalidHandle) {
+            // The last chance to ask, since the handle is the only way to. Only for a child
+            // that has exited: one let go of while running has not finished using anything.
+            if (returncode) {
+                ResourceUsage usage;
+                FILETIME creation, exit, kernel, user;
+                if (GetProcessTimes(_handle, &creation, &exit, &kernel, &user)) {
+                    usage.user_time = filetime_to_us(user);
+                    usage.system_time = filetime_to_us(kernel);
+                }
+                PROCESS_MEMORY_COUNTERS pmc;
+                if (GetProcessMemoryInfo(_handle, &pmc, sizeof(pmc))) {
+                    usage.max_rss = (long long) pmc.PeakWorkingSetSize;
+                }
+                resource_usage = usage;
+            }
+
             CloseHandle(_handle);
             _handle = InvalidHandle;
         }
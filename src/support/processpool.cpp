@@ -0,0 +1,59 @@
+// SPDX-License-Identifier: MIT
+
+#include "processpool.h"
+#include "processpool_p.h"
+
+#include <thread>
+
+#include "pimpl.h"
+
+namespace stdc {
+
+    ProcessPool::ProcessPool(int max_running) : _impl(new Impl()) {
+        stdc_impl_t;
+        if (max_running <= 0) {
+            max_running = int(std::thread::hardware_concurrency());
+        }
+        impl.max_running = max_running > 0 ? max_running : 1;
+    }
+
+    ProcessPool::~ProcessPool() = default;
+
+    int ProcessPool::max_running() const {
+        stdc_impl_t;
+        return impl.max_running;
+    }
+
+    size_t ProcessPool::submit(Popen popen, std::string input, int timeout) {
+        stdc_impl_t;
+        impl.queue.push_back({std::move(popen), std::move(input), timeout});
+        return impl.queue.size() - 1;
+    }
+
+    std::vector<ProcessPool::Result> ProcessPool::run(Order order) {
+        stdc_impl_t;
+        std::vector<Result> results;
+        if (order == Submitted) {
+            results.resize(impl.queue.size());
+            run([&results](Result &&result) {
+                results[result.index] = std::move(result);
+            });
+        } else {
+            results.reserve(impl.queue.size());
+            run([&results](Result &&result) {
+                results.push_back(std::move(result));
+            });
+        }
+        return results;
+    }
+
+    std::vector<ProcessPool::Result> run_many(std::vector<Popen> jobs, int max_running,
+                                              int timeout) {
+        ProcessPool pool(max_running);
+        for (auto &job : jobs) {
+            pool.submit(std::move(job), {}, timeout);
+        }
+        return pool.run();
+    }
+
+}
@@ -0,0 +1,24 @@
+// SPDX-License-Identifier: MIT
+
+#ifndef STDCORELIB_PROCESSPOOL_P_H
+#define STDCORELIB_PROCESSPOOL_P_H
+
+#include <stdcorelib/support/processpool.h>
+
+namespace stdc {
+
+    class ProcessPool::Impl {
+    public:
+        struct Job {
+            Popen popen;
+            std::string input;
+            int timeout;
+        };
+
+        int max_running = 1;
+        std::vector<Job> queue;
+    };
+
+}
+
+#endif // STDCORELIB_PROCESSPOOL_P_H
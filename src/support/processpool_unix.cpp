@@ -0,0 +1,72 @@
+// SPDX-License-Identifier: MIT
+
+#include "processpool.h"
+#include "processpool_p.h"
+
+#include <cerrno>
+#include <tuple>
+
+#include "processreactor.h"
+#include "pimpl.h"
+
+namespace stdc {
+
+    // A ProcessReactor with a queue in front of it, which starts the next job as each one ends.
+    void ProcessPool::run(const std::function<void(Result &&)> &on_result) {
+        stdc_impl_t;
+        auto queue = std::move(impl.queue);
+        impl.queue.clear();
+
+        // Filled in while a job runs and moved out when it ends, so what is kept at any time is
+        // the output of the jobs running and no more.
+        std::vector<Result> results(queue.size());
+
+        ProcessReactor reactor;
+        size_t next = 0;
+        while (true) {
+            while (reactor.size() < size_t(impl.max_running) && next < queue.size()) {
+                size_t index = next++;
+                auto &job = queue[index];
+                auto &result = results[index];
+                result.index = index;
+
+                std::string error_msg;
+                if (!job.popen.start(&error_msg)) {
+                    result.error = job.popen.error_code();
+                    result.error_msg = std::move(error_msg);
+                    on_result(std::move(result));
+                    continue;
+                }
+                result.pid = job.popen.pid();
+
+                ProcessReactor::Handlers handlers;
+                handlers.on_stdout_chunk = [&result](std::string_view chunk) {
+                    result.out.append(chunk);
+                };
+                handlers.on_stderr_chunk = [&result](std::string_view chunk) {
+                    result.err.append(chunk);
+                };
+                handlers.on_exit = [&result, &on_result](Popen &popen, std::error_code error) {
+                    result.returncode = popen.returncode();
+                    result.usage = popen.resource_usage();
+                    result.error = error;
+                    on_result(std::move(result));
+                };
+                if (!reactor.add(std::move(job.popen), std::move(handlers), std::move(job.input),
+                                 job.timeout)) {
+                    result.error = std::error_code(errno, std::generic_category());
+                    std::ignore = job.popen.kill();
+                    std::ignore = job.popen.wait();
+                    result.returncode = job.popen.returncode();
+                    result.usage = job.popen.resource_usage();
+                    on_result(std::move(result));
+                }
+            }
+            if (reactor.empty()) {
+                break;
+            }
+            reactor.process_events();
+        }
+    }
+
+}
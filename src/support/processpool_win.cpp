@@ -0,0 +1,92 @@
+// SPDX-License-Identifier: MIT
+
+#include "processpool.h"
+#include "processpool_p.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <tuple>
+
+#include "pimpl.h"
+
+namespace stdc {
+
+    // An anonymous pipe cannot be waited on here, which is why communicate() on this platform
+    // is threads already. A thread for each running child does the job through it, and hands
+    // the result over to the caller's thread, so the callback runs where it does elsewhere.
+    void ProcessPool::run(const std::function<void(Result &&)> &on_result) {
+        stdc_impl_t;
+        auto queue = std::move(impl.queue);
+        impl.queue.clear();
+        if (queue.empty()) {
+            return;
+        }
+
+        std::mutex mutex;
+        std::condition_variable done_cv;
+        std::deque<Result> done;
+        size_t next = 0;
+
+        const auto &work = [&]() {
+            while (true) {
+                size_t index;
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (next == queue.size()) {
+                        return;
+                    }
+                    index = next++;
+                }
+                auto &job = queue[index];
+
+                Result result;
+                result.index = index;
+                std::string error_msg;
+                if (job.popen.start(&error_msg)) {
+                    result.pid = job.popen.pid();
+                    std::tie(result.out, result.err) =
+                        job.popen.communicate(job.input, job.timeout);
+                    result.error = job.popen.error_code();
+                    result.returncode = job.popen.returncode();
+                    result.usage = job.popen.resource_usage();
+                } else {
+                    result.error = job.popen.error_code();
+                    result.error_msg = std::move(error_msg);
+                }
+                job.popen = Popen();
+
+                std::lock_guard<std::mutex> lock(mutex);
+                done.push_back(std::move(result));
+                done_cv.notify_one();
+            }
+        };
+
+        size_t workers = std::min(size_t(impl.max_running), queue.size());
+        std::vector<std::thread> threads;
+        threads.reserve(workers);
+        for (size_t i = 0; i < workers; ++i) {
+            threads.emplace_back(work);
+        }
+
+        for (size_t delivered = 0; delivered < queue.size();) {
+            std::deque<Result> batch;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                done_cv.wait(lock, [&done] { return !done.empty(); });
+                batch.swap(done);
+            }
+            for (auto &result : batch) {
+                on_result(std::move(result));
+                ++delivered;
+            }
+        }
+
+        for (auto &thread : threads) {
+            thread.join();
+        }
+    }
+
+}
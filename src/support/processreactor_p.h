@@ -0,0 +1,102 @@
+// SPDX-License-Identifier: MIT
+
+#ifndef STDCORELIB_PROCESSREACTOR_P_H
+#define STDCORELIB_PROCESSREACTOR_P_H
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include <poll.h>
+
+#include <stdcorelib/support/processreactor.h>
+
+#include "popen_p.h"
+
+namespace stdc {
+
+    /// The descriptors of every running child, waited on together. \c epoll on Linux, where the
+    /// set is handed to the kernel once rather than on every wait, and \c poll elsewhere.
+    class fd_poller {
+    public:
+        struct event {
+            uint64_t token;
+            bool hangup; // the other end is gone, or the descriptor is in error
+        };
+
+        fd_poller();
+        ~fd_poller();
+
+        bool is_valid() const;
+
+        /// The epoll set, or -1 where there is none.
+        int fd() const;
+
+        bool add(int fd, bool write, uint64_t token);
+        void remove(int fd);
+
+        /// False if the wait failed for a reason other than a signal.
+        bool wait(int timeout, std::vector<event> &ready);
+
+    private:
+#ifdef __linux__
+        int _epfd;
+#else
+        std::vector<struct pollfd> _fds;
+        std::vector<uint64_t> _tokens;
+#endif
+
+        STDC_DISABLE_COPY_MOVE(fd_poller)
+    };
+
+    class ProcessReactor::Impl {
+    public:
+        using steady = std::chrono::steady_clock;
+
+        struct child {
+            Popen popen;
+            Handlers handlers;
+            std::string input;
+            size_t written = 0;
+            std::optional<steady::time_point> deadline;
+            int in_fd = -1;
+            int out_fd = -1;
+            int err_fd = -1;
+            int exit_fd = -1;
+        };
+
+        // What a token says about the descriptor it came with. The slot of the child is the
+        // rest of it.
+        enum token_kind : uint64_t {
+            token_stdin,
+            token_stdout,
+            token_stderr,
+            token_exit,
+            token_kinds,
+        };
+
+        static constexpr uint64_t sigchld_token = UINT64_MAX;
+
+        fd_poller poller;
+        int poller_errno = 0; // why there is no poller, for add() to report
+        std::vector<fd_poller::event> ready;
+
+        // A free slot is null, and taken again by the next child, so the tokens stay small.
+        std::vector<std::unique_ptr<child>> slots;
+        size_t count = 0;
+
+        // Only wanted for children without a pidfd, and made when the first of them comes.
+        std::optional<sigchld_waiter> waiter;
+
+        void close_stream(int &fd, Popen::Stream &stream);
+        void handle(const fd_poller::event &ev);
+        void finish(size_t slot, std::error_code error);
+
+        /// Kills it and waits for it, which after SIGKILL does not take long.
+        void abandon(size_t slot, std::error_code error);
+    };
+
+}
+
+#endif // STDCORELIB_PROCESSREACTOR_P_H
@@ -0,0 +1,419 @@
+// SPDX-License-Identifier: MIT
+
+#include "processreactor.h"
+#include "processreactor_p.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#  include <sys/epoll.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <tuple>
+
+#include "pimpl.h"
+
+namespace stdc {
+
+#ifdef __linux__
+    fd_poller::fd_poller() : _epfd(epoll_create1(EPOLL_CLOEXEC)) {
+    }
+
+    fd_poller::~fd_poller() {
+        if (_epfd != -1) {
+            close(_epfd);
+        }
+    }
+
+    bool fd_poller::is_valid() const {
+        return _epfd != -1;
+    }
+
+    int fd_poller::fd() const {
+        return _epfd;
+    }
+
+    bool fd_poller::add(int fd, bool write, uint64_t token) {
+        struct epoll_event ev{};
+        ev.events = write ? EPOLLOUT : EPOLLIN;
+        ev.data.u64 = token;
+        return epoll_ctl(_epfd, EPOLL_CTL_ADD, fd, &ev) == 0;
+    }
+
+    void fd_poller::remove(int fd) {
+        struct epoll_event ev{};
+        epoll_ctl(_epfd, EPOLL_CTL_DEL, fd, &ev);
+    }
+
+    bool fd_poller::wait(int timeout, std::vector<event> &ready) {
+        ready.clear();
+        struct epoll_event evs[64];
+        int n = epoll_wait(_epfd, evs, 64, timeout);
+        if (n < 0) {
+            return errno == EINTR;
+        }
+        for (int i = 0; i < n; ++i) {
+            ready.push_back({evs[i].data.u64, (evs[i].events & (EPOLLERR | EPOLLHUP)) != 0});
+        }
+        return true;
+    }
+#else
+    fd_poller::fd_poller() = default;
+
+    fd_poller::~fd_poller() = default;
+
+    bool fd_poller::is_valid() const {
+        return true;
+    }
+
+    int fd_poller::fd() const {
+        return -1;
+    }
+
+    bool fd_poller::add(int fd, bool write, uint64_t token) {
+        _fds.push_back({fd, short(write ? POLLOUT : POLLIN), 0});
+        _tokens.push_back(token);
+        return true;
+    }
+
+    void fd_poller::remove(int fd) {
+        for (size_t i = 0; i < _fds.size(); ++i) {
+            if (_fds[i].fd == fd) {
+                _fds.erase(_fds.begin() + i);
+                _tokens.erase(_tokens.begin() + i);
+                return;
+            }
+        }
+    }
+
+    bool fd_poller::wait(int timeout, std::vector<event> &ready) {
+        ready.clear();
+        int n = ::poll(_fds.data(), nfds_t(_fds.size()), timeout);
+        if (n < 0) {
+            return errno == EINTR;
+        }
+        for (size_t i = 0; i < _fds.size() && n > 0; ++i) {
+            short revents = _fds[i].revents;
+            if (revents) {
+                ready.push_back({_tokens[i], (revents & (POLLERR | POLLHUP | POLLNVAL)) != 0});
+                --n;
+            }
+        }
+        return true;
+    }
+#endif
+
+    static void set_nonblocking(int fd) {
+        int flags = fcntl(fd, F_GETFL, 0);
+        if (flags >= 0) {
+            fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+        }
+    }
+
+    // Until it would block, since one readable event can carry more than one bufferful. False at
+    // the end of the pipe, or when reading it failed.
+    static bool drain(int fd, const std::function<void(std::string_view)> &on_chunk) {
+        char buf[65536];
+        for (;;) {
+            ssize_t n = ::read(fd, buf, sizeof(buf));
+            if (n > 0) {
+                if (on_chunk) {
+                    on_chunk(std::string_view(buf, size_t(n)));
+                }
+                continue;
+            }
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            return n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+        }
+    }
+
+    void ProcessReactor::Impl::close_stream(int &fd, Popen::Stream &stream) {
+        if (fd != -1) {
+            poller.remove(fd);
+            fd = -1;
+        }
+        stream.close();
+    }
+
+    void ProcessReactor::Impl::handle(const fd_poller::event &ev) {
+        size_t slot = size_t(ev.token / token_kinds);
+        if (slot >= slots.size() || !slots[slot]) {
+            return;
+        }
+        auto &c = *slots[slot];
+        switch (ev.token % token_kinds) {
+            case token_stdin: {
+                if (c.in_fd == -1) {
+                    break;
+                }
+                if (ev.hangup) {
+                    close_stream(c.in_fd, c.popen.stdin_());
+                    break;
+                }
+                ssize_t n =
+                    ::write(c.in_fd, c.input.data() + c.written, c.input.size() - c.written);
+                if (n > 0) {
+                    c.written += size_t(n);
+                } else if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                    close_stream(c.in_fd, c.popen.stdin_());
+                    break;
+                }
+                // End of input is what lets a child reading to the end finish.
+                if (c.written == c.input.size()) {
+                    close_stream(c.in_fd, c.popen.stdin_());
+                }
+                break;
+            }
+            case token_stdout: {
+                if (c.out_fd != -1 && !drain(c.out_fd, c.handlers.on_stdout_chunk)) {
+                    close_stream(c.out_fd, c.popen.stdout_());
+                }
+                break;
+            }
+            case token_stderr: {
+                if (c.err_fd != -1 && !drain(c.err_fd, c.handlers.on_stderr_chunk)) {
+                    close_stream(c.err_fd, c.popen.stderr_());
+                }
+                break;
+            }
+            case token_exit: {
+                // Readable for as long as the Popen has it open, so out of the set once seen.
+                if (c.exit_fd != -1) {
+                    poller.remove(c.exit_fd);
+                    c.exit_fd = -1;
+                    std::ignore = c.popen.wait();
+                }
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    void ProcessReactor::Impl::finish(size_t slot, std::error_code error) {
+        // Out of the slot before the handler runs, so a handler that adds another child may
+        // have it straight away.
+        auto c = std::move(slots[slot]);
+        --count;
+
+        // A child may exit without reading all its input, and the Popen is about to close the
+        // pipe, which has to leave the set first.
+        close_stream(c->in_fd, c->popen.stdin_());
+        if (c->exit_fd != -1) {
+            poller.remove(c->exit_fd);
+        }
+        if (c->handlers.on_exit) {
+            c->handlers.on_exit(c->popen, error);
+        }
+    }
+
+    void ProcessReactor::Impl::abandon(size_t slot, std::error_code error) {
+        auto &c = *slots[slot];
+        std::ignore = c.popen.kill();
+        close_stream(c.in_fd, c.popen.stdin_());
+        close_stream(c.out_fd, c.popen.stdout_());
+        close_stream(c.err_fd, c.popen.stderr_());
+        std::ignore = c.popen.wait();
+        finish(slot, error);
+    }
+
+    ProcessReactor::ProcessReactor() : _impl(new Impl()) {
+        stdc_impl_t;
+        if (!impl.poller.is_valid()) {
+            impl.poller_errno = errno;
+        }
+    }
+
+    ProcessReactor::~ProcessReactor() = default;
+
+    bool ProcessReactor::add(Popen &&popen, Handlers handlers, std::string input, int timeout) {
+        stdc_impl_t;
+        if (!impl.poller.is_valid()) {
+            errno = impl.poller_errno;
+            return false;
+        }
+        if (popen.pid() <= 0 || popen.detached()) {
+            errno = ECHILD;
+            return false;
+        }
+
+        auto found = std::find(impl.slots.begin(), impl.slots.end(), nullptr);
+        size_t slot = size_t(found - impl.slots.begin());
+
+        // Everything is added before anything about the Popen changes, so that a failure part of
+        // the way leaves it as it came.
+        auto c = std::make_unique<Impl::child>();
+        bool ok = true;
+        const auto &watch = [&](Popen::Stream &stream, int &fd, bool write, uint64_t kind) {
+            if (!ok || !stream.is_open()) {
+                return;
+            }
+            if (!impl.poller.add(stream.fd(), write, slot * Impl::token_kinds + kind)) {
+                ok = false;
+                return;
+            }
+            fd = stream.fd();
+        };
+        if (!input.empty()) {
+            // Whatever the caller wrote through the stream goes out ahead of the input given
+            // here, as communicate() has it, and while the descriptor still blocks. Left in the
+            // buffer, it would follow the input at the close and could be lost to EAGAIN.
+            popen.stdin_().flush();
+            watch(popen.stdin_(), c->in_fd, true, Impl::token_stdin);
+        }
+        watch(popen.stdout_(), c->out_fd, false, Impl::token_stdout);
+        watch(popen.stderr_(), c->err_fd, false, Impl::token_stderr);
+
+        bool exited = popen.returncode().has_value();
+        if (ok && !exited && popen.exit_fd() != -1) {
+            // Not a failure if it will not go in. The exit is polled for instead.
+            uint64_t token = slot * Impl::token_kinds + Impl::token_exit;
+            if (impl.poller.add(popen.exit_fd(), false, token)) {
+                c->exit_fd = popen.exit_fd();
+            }
+        }
+        if (!ok) {
+            int saved = errno;
+            for (int fd : {c->in_fd, c->out_fd, c->err_fd}) {
+                if (fd != -1) {
+                    impl.poller.remove(fd);
+                }
+            }
+            errno = saved;
+            return false;
+        }
+        if (!exited && c->exit_fd == -1 && !impl.waiter) {
+            impl.waiter.emplace();
+            if (impl.waiter->fd() != -1) {
+                impl.poller.add(impl.waiter->fd(), false, Impl::sigchld_token);
+            }
+        }
+
+        for (int fd : {c->in_fd, c->out_fd, c->err_fd}) {
+            if (fd != -1) {
+                set_nonblocking(fd);
+            }
+        }
+        if (input.empty()) {
+            // Nothing to say, so the child hears that now rather than waiting for it.
+            popen.stdin_().close();
+        }
+        c->popen = std::move(popen);
+        c->handlers = std::move(handlers);
+        c->input = std::move(input);
+        if (timeout >= 0) {
+            c->deadline = Impl::steady::now() + std::chrono::milliseconds(timeout);
+        }
+
+        if (found == impl.slots.end()) {
+            impl.slots.push_back(std::move(c));
+        } else {
+            *found = std::move(c);
+        }
+        ++impl.count;
+        return true;
+    }
+
+    size_t ProcessReactor::size() const {
+        stdc_impl_t;
+        return impl.count;
+    }
+
+    int ProcessReactor::fd() const {
+        stdc_impl_t;
+        return impl.poller.fd();
+    }
+
+    int ProcessReactor::next_timeout() const {
+        stdc_impl_t;
+        int timeout = -1;
+        bool unwatched = false;
+        auto now = Impl::steady::now();
+        for (const auto &c : impl.slots) {
+            if (!c) {
+                continue;
+            }
+            bool exited = c->popen.returncode().has_value();
+            if (exited && c->out_fd == -1 && c->err_fd == -1) {
+                return 0; // done, and only waiting to be reported
+            }
+            if (!exited && c->exit_fd == -1) {
+                unwatched = true;
+            }
+            if (c->deadline) {
+                auto left = std::chrono::ceil<std::chrono::milliseconds>(*c->deadline - now);
+                int ms = left.count() > 0 ? int(left.count()) : 0;
+                timeout = timeout < 0 ? ms : std::min(timeout, ms);
+            }
+        }
+        if (unwatched) {
+            // As Popen::wait() does: a second where SIGCHLD wakes us, in case somebody else took
+            // it over, and the old sleep where nothing does.
+            int cap = impl.waiter && impl.waiter->fd() != -1 ? 1000 : 50;
+            timeout = timeout < 0 ? cap : std::min(timeout, cap);
+        }
+        return timeout;
+    }
+
+    size_t ProcessReactor::process_events(int timeout) {
+        stdc_impl_t;
+        if (impl.count == 0) {
+            return 0;
+        }
+
+        // Held while writing, for the same reason communicate() holds it.
+        sigpipe_guard guard;
+
+        int limit = next_timeout();
+        if (limit >= 0) {
+            timeout = timeout < 0 ? limit : std::min(timeout, limit);
+        }
+        if (!impl.poller.wait(timeout, impl.ready)) {
+            auto error = std::error_code(errno, std::generic_category());
+            for (size_t slot = 0; slot < impl.slots.size(); ++slot) {
+                if (impl.slots[slot]) {
+                    impl.abandon(slot, error);
+                }
+            }
+            return impl.count;
+        }
+        for (const auto &ev : impl.ready) {
+            if (ev.token == Impl::sigchld_token) {
+                impl.waiter->drain();
+                continue;
+            }
+            impl.handle(ev);
+        }
+
+        // Done is exited and read to the end. Past its deadline is killed, whatever else. Nothing
+        // is finished until every event has been handled, so none of them can be taken for a
+        // child that came into the same slot afterwards.
+        auto now = Impl::steady::now();
+        for (size_t slot = 0; slot < impl.slots.size(); ++slot) {
+            if (!impl.slots[slot]) {
+                continue;
+            }
+            auto &c = *impl.slots[slot];
+            if (!c.popen.returncode() && c.exit_fd == -1) {
+                std::ignore = c.popen.poll();
+            }
+            if (c.popen.returncode() && c.out_fd == -1 && c.err_fd == -1) {
+                impl.finish(slot, {});
+            } else if (c.deadline && now >= *c.deadline) {
+                impl.abandon(slot, std::make_error_code(std::errc::timed_out));
+            }
+        }
+        return impl.count;
+    }
+
+    void ProcessReactor::run() {
+        while (process_events() > 0) {
+        }
+    }
+
+}
@@ -1,6 +1,7 @@
 // SPDX-License-Identifier: MIT
 
 #include "utf.h"
+#include "utf_p.h"
 
 #include <cstdint>
 #include <memory>
@@ -18,107 +19,13 @@ namespace stdc::utf {
             return char32_t(std::make_unsigned_t<Char>(c));
         }
 
-        // How many bytes a lead byte announces, or 0 if it cannot start a sequence. C0 and C1
-        // are missing on purpose: the only things they could encode are already spelled in one
-        // byte, and accepting the longer form lets the same text be written two ways. F5 and
-        // above would run past U+10FFFF.
-        int sequence_length(uint8_t lead) {
-            if (lead < 0x80) {
-                return 1;
-            }
-            if (lead >= 0xC2 && lead <= 0xDF) {
-                return 2;
-            }
-            if (lead >= 0xE0 && lead <= 0xEF) {
-                return 3;
-            }
-            if (lead >= 0xF0 && lead <= 0xF4) {
-                return 4;
-            }
-            return 0;
-        }
-
-        bool is_continuation(uint8_t c) {
-            return (c & 0xC0) == 0x80;
-        }
-
-        // The second byte carries the constraint that the lead byte alone cannot express: which
-        // of the values in its range would be an overlong encoding, a surrogate, or past the end
-        // of Unicode.
-        bool second_byte_ok(uint8_t lead, uint8_t second) {
-            switch (lead) {
-                case 0xE0:
-                    return second >= 0xA0 && second <= 0xBF; // shorter form exists below A0
-                case 0xED:
-                    return second >= 0x80 && second <= 0x9F; // above 9F is a surrogate
-                case 0xF0:
-                    return second >= 0x90 && second <= 0xBF; // shorter form exists below 90
-                case 0xF4:
-                    return second >= 0x80 && second <= 0x8F; // above 8F is past U+10FFFF
-                default:
-                    return is_continuation(second);
-            }
-        }
-
         // One type per encoding, rather than a pair of function pointers, so that the walk in
         // convert() calls them directly and they inline into it.
 
         struct utf8_codec {
-            /// Reads one code point starting at \a pos.
-            ///
-            /// On success \a pos moves past it and the code point comes back. On invalid input
-            /// \a pos moves past the maximal part that could still have been the start of
-            /// something valid, which is at least one unit, and the result is nothing. Consuming
-            /// exactly that much is what stops one bad byte turning the rest of the text into
-            /// replacement characters.
+            /// Reads one code point starting at \a pos, as detail::decode_utf8() does.
             static bool decode(std::string_view s, size_t &pos, char32_t &out) {
-                const uint8_t lead = uint8_t(s[pos]);
-                const int length = sequence_length(lead);
-                if (length == 0) {
-                    pos += 1;
-                    return false;
-                }
-                if (length == 1) {
-                    out = lead;
-                    pos += 1;
-                    return true;
-                }
-
-                // A sequence cut off by the end of the input is not valid, but it is not garbage
-                // either, so what there is of it is consumed whole rather than one byte at a
-                // time. Only the part that was still on its way to being valid counts: E0 80 at
-                // the end of the input is not a truncated sequence, it is E0 followed by a byte
-                // that could never have come after it.
-                if (pos + size_t(length) > s.size()) {
-                    size_t taken = 1;
-                    if (pos + 1 < s.size() && second_byte_ok(lead, uint8_t(s[pos + 1]))) {
-                        taken = 2;
-                        while (pos + taken < s.size() && is_continuation(uint8_t(s[pos + taken]))) {
-                            ++taken;
-                        }
-                    }
-                    pos += taken;
-                    return false;
-                }
-
-                if (!second_byte_ok(lead, uint8_t(s[pos + 1]))) {
-                    pos += 1;
-                    return false;
-                }
-                for (int i = 2; i < length; ++i) {
-                    if (!is_continuation(uint8_t(s[pos + i]))) {
-                        pos += size_t(i);
-                        return false;
-                    }
-                }
-
-                char32_t c = lead & (0xFF >> (length + 1));
-                for (int i = 1; i < length; ++i) {
-                    c = (c << 6) | (uint8_t(s[pos + i]) & 0x3F);
-                }
-                pos += size_t(length);
-                out = c;
-                return true;
+                return detail::decode_utf8(s, pos, out);
             }
 
             /// Writes \a c at \a p and returns how many units that took. There is always room for
@@ -0,0 +1,116 @@
+// SPDX-License-Identifier: MIT
+
+#ifndef STDCORELIB_UTF_P_H
+#define STDCORELIB_UTF_P_H
+
+#include <cstdint>
+#include <string_view>
+
+#include <stdcorelib/utf.h>
+
+namespace stdc::utf::detail {
+
+    // How many bytes a lead byte announces, or 0 if it cannot start a sequence. C0 and C1
+    // are missing on purpose: the only things they could encode are already spelled in one
+    // byte, and accepting the longer form lets the same text be written two ways. F5 and
+    // above would run past U+10FFFF.
+    inline int sequence_length(uint8_t lead) {
+        if (lead < 0x80) {
+            return 1;
+        }
+        if (lead >= 0xC2 && lead <= 0xDF) {
+            return 2;
+        }
+        if (lead >= 0xE0 && lead <= 0xEF) {
+            return 3;
+        }
+        if (lead >= 0xF0 && lead <= 0xF4) {
+            return 4;
+        }
+        return 0;
+    }
+
+    inline bool is_continuation(uint8_t c) {
+        return (c & 0xC0) == 0x80;
+    }
+
+    // The second byte carries the constraint that the lead byte alone cannot express: which
+    // of the values in its range would be an overlong encoding, a surrogate, or past the end
+    // of Unicode.
+    inline bool second_byte_ok(uint8_t lead, uint8_t second) {
+        switch (lead) {
+            case 0xE0:
+                return second >= 0xA0 && second <= 0xBF; // shorter form exists below A0
+            case 0xED:
+                return second >= 0x80 && second <= 0x9F; // above 9F is a surrogate
+            case 0xF0:
+                return second >= 0x90 && second <= 0xBF; // shorter form exists below 90
+            case 0xF4:
+                return second >= 0x80 && second <= 0x8F; // above 8F is past U+10FFFF
+            default:
+                return is_continuation(second);
+        }
+    }
+
+    /// Reads one code point of UTF-8 starting at \a pos, where it sits, without converting
+    /// the rest. The converters walk with it, and so does anything else that reads text a code
+    /// point at a time.
+    ///
+    /// On success \a pos moves past it and the code point comes back. On invalid input
+    /// \a pos moves past the maximal part that could still have been the start of
+    /// something valid, which is at least one unit, and the result is nothing. Consuming
+    /// exactly that much is what stops one bad byte turning the rest of the text into
+    /// replacement characters.
+    inline bool decode_utf8(std::string_view s, size_t &pos, char32_t &out) {
+        const uint8_t lead = uint8_t(s[pos]);
+        const int length = sequence_length(lead);
+        if (length == 0) {
+            pos += 1;
+            return false;
+        }
+        if (length == 1) {
+            out = lead;
+            pos += 1;
+            return true;
+        }
+
+        // A sequence cut off by the end of the input is not valid, but it is not garbage
+        // either, so what there is of it is consumed whole rather than one byte at a
+        // time. Only the part that was still on its way to being valid counts: E0 80 at
+        // the end of the input is not a truncated sequence, it is E0 followed by a byte
+        // that could never have come after it.
+        if (pos + size_t(length) > s.size()) {
+            size_t taken = 1;
+            if (pos + 1 < s.size() && second_byte_ok(lead, uint8_t(s[pos + 1]))) {
+                taken = 2;
+                while (pos + taken < s.size() && is_continuation(uint8_t(s[pos + taken]))) {
+                    ++taken;
+                }
+            }
+            pos += taken;
+            return false;
+        }
+
+        if (!second_byte_ok(lead, uint8_t(s[pos + 1]))) {
+            pos += 1;
+            return false;
+        }
+        for (int i = 2; i < length; ++i) {
+            if (!is_continuation(uint8_t(s[pos + i]))) {
+                pos += size_t(i);
+                return false;
+            }
+        }
+
+        char32_t c = lead & (0xFF >> (length + 1));
+        for (int i = 1; i < length; ++i) {
+            c = (c << 6) | (uint8_t(s[pos + i]) & 0x3F);
+        }
+        pos += size_t(length);
+        out = c;
+        return true;
+    }
+
+}
+
+#endif // STDCORELIB_UTF_P_H
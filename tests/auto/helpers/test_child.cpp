@@ -10,10 +10,12 @@
 // Deliberately built against nothing but the standard library, so a defect in stdcorelib cannot
 // be hidden by the same defect on both sides of the pipe.
 
+#include <chrono>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <string>
+#include <thread>
 
 #ifdef _WIN32
 #  include <fcntl.h>
@@ -32,7 +34,7 @@ namespace {
     }
 
     int usage() {
-        std::fputs("usage: test_child arg0|argv|exit|fill|cat ...\n", stderr);
+        std::fputs("usage: test_child arg0|argv|exit|fill|cat|sleep ...\n", stderr);
         return 2;
     }
 
@@ -120,5 +122,12 @@ int main(int argc, char *argv[]) {
         return 0;
     }
 
+    // Sleeps for so many milliseconds, which the shells spell too differently to share.
+    if (mode == "sleep") {
+        long ms = argc > 2 ? std::atol(argv[2]) : 0;
+        std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+        return 0;
+    }
+
     return usage();
 }
@@ -0,0 +1,33 @@
+// SPDX-License-Identifier: MIT
+
+#ifndef STDC_TEST_CHILD_H
+#define STDC_TEST_CHILD_H
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <stdcorelib/support/popen.h>
+
+/// The helper program built from test_child.cpp, with its mode and whatever the mode takes.
+inline std::vector<std::string> child_args(std::vector<std::string> rest) {
+    std::vector<std::string> args = {TEST_CHILD_PATH};
+    args.insert(args.end(), rest.begin(), rest.end());
+    return args;
+}
+
+/// The same, ready to start, with its streams left as they are.
+inline stdc::Popen child(std::vector<std::string> rest) {
+    stdc::Popen p;
+    p.args(child_args(std::move(rest)));
+    return p;
+}
+
+/// The same, with a pipe to each of its streams.
+inline stdc::Popen piped_child(std::vector<std::string> rest) {
+    auto p = child(std::move(rest));
+    p.stdin_(stdc::Popen::PIPE).stdout_(stdc::Popen::PIPE).stderr_(stdc::Popen::PIPE);
+    return p;
+}
+
+#endif // STDC_TEST_CHILD_H
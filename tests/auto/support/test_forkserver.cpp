@@ -0,0 +1,172 @@
+// SPDX-License-Identifier: MIT
+
+#ifndef _WIN32
+
+#include <stdcorelib/support/forkserver.h>
+#include <stdcorelib/support/popen.h>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include <filesystem>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "../helpers/test_child.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace stdc;
+
+namespace {
+
+    const int Timeout = 15000;
+
+    // A server for the one test case, gone again at the end of it whatever happens.
+    struct ServerFixture {
+        ServerFixture() {
+            std::string err;
+            BOOST_REQUIRE_MESSAGE(ForkServer::start(&err), err);
+        }
+
+        ~ServerFixture() {
+            ForkServer::stop();
+        }
+    };
+
+    Popen shell(const char *script) {
+        Popen p;
+        p.args({"/bin/sh", "-c", script}).stdout_(Popen::PIPE);
+        return p;
+    }
+
+    std::string run(Popen &p) {
+        std::string err;
+        BOOST_REQUIRE_MESSAGE(p.start(&err), err);
+        auto [out, _] = p.communicate({}, Timeout);
+        return out;
+    }
+
+}
+
+BOOST_AUTO_TEST_SUITE(test_forkserver)
+
+BOOST_FIXTURE_TEST_CASE(test_children_come_from_the_server, ServerFixture) {
+    BOOST_CHECK(ForkServer::is_running());
+    BOOST_REQUIRE(ForkServer::pid() > 0);
+    BOOST_CHECK(ForkServer::pid() != getpid());
+    BOOST_CHECK(ForkServer::start()); // already running
+
+    auto p = shell("echo $PPID");
+    BOOST_CHECK_EQUAL(run(p), std::to_string(ForkServer::pid()) + "\n");
+    BOOST_REQUIRE(p.returncode());
+    BOOST_CHECK_EQUAL(*p.returncode(), 0);
+    BOOST_CHECK(p.resource_usage());
+}
+
+BOOST_FIXTURE_TEST_CASE(test_exit_status_and_signals, ServerFixture) {
+    Popen exits;
+    exits.args({"/bin/sh", "-c", "exit 7"});
+    BOOST_REQUIRE(exits.start());
+    BOOST_CHECK(exits.exit_fd() != -1);
+    BOOST_REQUIRE(exits.wait(Timeout));
+    BOOST_CHECK_EQUAL(exits.returncode().value_or(-1), 7);
+
+    Popen sleeper;
+    sleeper.args(child_args({"sleep", "60000"}));
+    BOOST_REQUIRE(sleeper.start());
+    BOOST_CHECK(!sleeper.poll());
+    BOOST_CHECK(!sleeper.wait(100));
+    BOOST_REQUIRE(sleeper.kill());
+    BOOST_REQUIRE(sleeper.wait(Timeout));
+    BOOST_CHECK_EQUAL(sleeper.returncode().value_or(0), -9);
+
+    // Reaped by the server before this process has heard, so its pid is free for another.
+    // The kill goes nowhere rather than to whoever has the pid now.
+    Popen gone;
+    gone.args({"/bin/sh", "-c", "exit 4"});
+    BOOST_REQUIRE(gone.start());
+    ::usleep(200 * 1000);
+    BOOST_CHECK(gone.kill());
+    BOOST_REQUIRE(gone.wait(Timeout));
+    BOOST_CHECK_EQUAL(gone.returncode().value_or(-1), 4);
+
+    // The exit pipe says when, for a loop of the caller's own.
+    Popen polled;
+    polled.args({"/bin/sh", "-c", "exit 2"});
+    BOOST_REQUIRE(polled.start());
+    struct pollfd pfd = {polled.exit_fd(), POLLIN, 0};
+    BOOST_REQUIRE_EQUAL(::poll(&pfd, 1, Timeout), 1);
+    BOOST_REQUIRE(polled.poll());
+    BOOST_CHECK_EQUAL(polled.returncode().value_or(-1), 2);
+}
+
+BOOST_FIXTURE_TEST_CASE(test_start_failures_are_reported, ServerFixture) {
+    Popen p;
+    p.args({"/nonexistent/forkserver-test-program"});
+    std::string err;
+    BOOST_CHECK(!p.start(&err));
+    BOOST_CHECK(!err.empty());
+    BOOST_CHECK(p.error_code());
+    BOOST_CHECK(ForkServer::is_running());
+}
+
+// What is sent along with each request rather than inherited from the server.
+BOOST_FIXTURE_TEST_CASE(test_cwd_env_and_fds_are_the_callers, ServerFixture) {
+    auto tmp = std::filesystem::canonical(std::filesystem::temp_directory_path());
+    auto in_cwd = shell("pwd");
+    in_cwd.cwd(tmp);
+    BOOST_CHECK_EQUAL(run(in_cwd), tmp.string() + "\n");
+
+    auto with_env = shell("echo \"$FORKSERVER_TEST\"");
+    with_env.env(std::map<std::string, std::string>{
+        {"FORKSERVER_TEST", "from the request"}
+    });
+    BOOST_CHECK_EQUAL(run(with_env), "from the request\n");
+
+    ::setenv("FORKSERVER_TEST", "set after the server started", 1);
+    auto inherited = shell("echo \"$FORKSERVER_TEST\"");
+    BOOST_CHECK_EQUAL(run(inherited), "set after the server started\n");
+    ::unsetenv("FORKSERVER_TEST");
+
+    int fds[2];
+    BOOST_REQUIRE_EQUAL(::pipe(fds), 0);
+    ::fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+    std::string script = "echo passed >&" + std::to_string(fds[1]);
+    Popen passing;
+    passing.args({"/bin/sh", "-c", script}).pass_fds({fds[1]});
+    BOOST_REQUIRE(passing.start());
+    ::close(fds[1]);
+    BOOST_REQUIRE(passing.wait(Timeout));
+    BOOST_CHECK_EQUAL(passing.returncode().value_or(-1), 0);
+    char buf[16] = {};
+    BOOST_CHECK_EQUAL(::read(fds[0], buf, sizeof(buf)), 7);
+    BOOST_CHECK_EQUAL(std::string(buf), "passed\n");
+    ::close(fds[0]);
+
+    // Input goes through the server's children as it does through ours.
+    Popen cat;
+    cat.args(child_args({"cat"})).stdin_(Popen::PIPE).stdout_(Popen::PIPE);
+    BOOST_REQUIRE(cat.start());
+    auto [out, _] = cat.communicate("round trip", Timeout);
+    BOOST_CHECK_EQUAL(out, "round trip");
+}
+
+// A preexec_fn needs this process's memory, so that child is forked here.
+BOOST_FIXTURE_TEST_CASE(test_preexec_fn_and_stop_fork_here, ServerFixture) {
+    auto p = shell("echo $PPID");
+    p.preexec_fn([]() {});
+    BOOST_CHECK_EQUAL(run(p), std::to_string(getpid()) + "\n");
+
+    ForkServer::stop();
+    BOOST_CHECK(!ForkServer::is_running());
+    BOOST_CHECK_EQUAL(ForkServer::pid(), -1);
+    auto after = shell("echo $PPID");
+    BOOST_CHECK_EQUAL(run(after), std::to_string(getpid()) + "\n");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+#endif
@@ -1,7 +1,17 @@
 // SPDX-License-Identifier: MIT
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
 #include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -17,6 +27,7 @@
 #  define stdc_fileno _fileno
 #  define NullDevice  "NUL"
 #else
+#  include <sys/wait.h>
 #  include <unistd.h>
 #  define stdc_dup    dup
 #  define stdc_dup2   dup2
@@ -79,6 +90,62 @@ namespace {
         g_lastContext = context;
     }
 
+    // The async writer calls the sink from a thread of its own, so what it records is guarded,
+    // and the sink can be held shut to let the queue fill up behind it.
+    struct AsyncRecorder {
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::vector<std::string> messages;
+        std::vector<std::thread::id> threads;
+        bool gateOpen = true;
+        bool entered = false;
+
+        void add(const std::string_view &message) {
+            std::unique_lock lock(mutex);
+            entered = true;
+            cv.notify_all();
+            cv.wait(lock, [this]() { return gateOpen; });
+            messages.emplace_back(message);
+            threads.push_back(std::this_thread::get_id());
+        }
+
+        void waitUntilEntered() {
+            std::unique_lock lock(mutex);
+            cv.wait(lock, [this]() { return entered; });
+        }
+
+        void open() {
+            std::lock_guard lock(mutex);
+            gateOpen = true;
+            cv.notify_all();
+        }
+    };
+
+    AsyncRecorder *g_async = nullptr;
+
+    void asyncSink(int, const LogContext &, const std::string_view &message) {
+        g_async->add(message);
+    }
+
+    // Stops the writer and puts the sink back, whatever the case did in between.
+    struct AsyncGuard {
+        Logger::LogCallback prev = Logger::logCallback();
+
+        explicit AsyncGuard(AsyncRecorder &recorder) {
+            g_async = &recorder;
+            Logger::setLogCallback(asyncSink);
+        }
+
+        ~AsyncGuard() {
+            if (g_async) {
+                g_async->open();
+            }
+            Logger::stopAsync();
+            Logger::setLogCallback(prev);
+            g_async = nullptr;
+        }
+    };
+
     // Redirects stdout and stderr into a scratch file for as long as it lives, and hands back
     // what was written. The default sink writes to them directly, so this is the only way to see
     // what it produced.
@@ -325,6 +392,84 @@ BOOST_AUTO_TEST_CASE(test_custom_filter_replaces_the_default) {
     BOOST_CHECK(c.isLevelEnabled(Logger::Warning));
 }
 
+// Each kind of pattern is matched its own way, and it is still the order they were written in
+// that decides between them.
+BOOST_AUTO_TEST_CASE(test_rules_of_every_kind_apply_in_order) {
+    LoggingGuard guard;
+    LogCategory c("stdc.net.http");
+    LogCategory other("app.net.http.client");
+
+    setRules("*http*.debug = false\n"
+             "stdc.* = false\n"
+             "*.http.warning = true\n"
+             "stdc.net.http.critical = true\n"
+             "stdc.net.*.trace = true\n"
+             "stdc.net*.info = true");
+    BOOST_CHECK(c.isLevelEnabled(Logger::Warning));
+    BOOST_CHECK(c.isLevelEnabled(Logger::Critical));
+    BOOST_CHECK(c.isLevelEnabled(Logger::Information));
+    BOOST_CHECK(c.isLevelEnabled(Logger::Trace));
+    BOOST_CHECK(!c.isLevelEnabled(Logger::Debug));
+    BOOST_CHECK(!c.isLevelEnabled(Logger::Success));
+    BOOST_CHECK(!c.isLevelEnabled(Logger::Fatal));
+    BOOST_CHECK(!other.isLevelEnabled(Logger::Debug));
+    BOOST_CHECK(other.isLevelEnabled(Logger::Trace));
+
+    // the same rules the other way round
+    setRules("stdc.net*.info = true\n"
+             "stdc.net.http.critical = true\n"
+             "*.http.warning = true\n"
+             "stdc.* = false\n"
+             "*http*.debug = false");
+    BOOST_CHECK(allDisabled(c));
+    BOOST_CHECK_EQUAL(c.levelMask(), 0u);
+}
+
+// Categories created while the rules change under them still end up with the rules that were
+// set last, whichever side of each change they landed on.
+BOOST_AUTO_TEST_CASE(test_rules_change_while_categories_are_created) {
+    LoggingGuard guard;
+    constexpr int threads = 4;
+    constexpr int perThread = 500;
+
+    std::vector<std::vector<std::string>> names(threads);
+    std::vector<std::vector<std::unique_ptr<LogCategory>>> categories(threads);
+    for (int t = 0; t < threads; ++t) {
+        for (int i = 0; i < perThread; ++i) {
+            names[t].push_back("stdc.churn." + std::to_string(t) + "." + std::to_string(i));
+        }
+    }
+
+    std::atomic<bool> go{false};
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t]() {
+            while (!go.load()) {
+                std::this_thread::yield();
+            }
+            for (const auto &name : names[t]) {
+                categories[t].push_back(std::make_unique<LogCategory>(name.c_str()));
+            }
+        });
+    }
+    go.store(true);
+    for (int i = 0; i < 50; ++i) {
+        setRules(i % 2 ? "stdc.churn.* = false" : "");
+    }
+    setRules("stdc.churn.*.debug = false");
+    for (auto &worker : workers) {
+        worker.join();
+    }
+
+    int wrong = 0;
+    for (const auto &list : categories) {
+        for (const auto &c : list) {
+            wrong += c->isLevelEnabled(Logger::Debug) || !c->isLevelEnabled(Logger::Warning);
+        }
+    }
+    BOOST_CHECK_EQUAL(wrong, 0);
+}
+
 // The rules have to gate emission, not just the isLevelEnabled() flags.
 BOOST_AUTO_TEST_CASE(test_disabled_level_never_reaches_the_callback) {
     LoggingGuard guard;
@@ -378,6 +523,39 @@ BOOST_AUTO_TEST_CASE(test_macros) {
     BOOST_CHECK_EQUAL(g_lastLevel, int(Logger::Warning));
 }
 
+// The macros used to expand to an ordinary call, so an argument was computed before the level
+// was ever looked at. They short circuit now, and a disabled level costs the check and nothing
+// else, while an enabled one still evaluates each argument exactly once.
+BOOST_AUTO_TEST_CASE(test_macros_skip_arguments_of_disabled_levels) {
+    LoggingGuard guard;
+    auto prev = Logger::logCallback();
+    Logger::setLogCallback(captureSink);
+
+    LogCategory lc("stdc.lazy");
+    setRules("stdc.lazy.debug=false");
+
+    int evaluated = 0;
+    auto expensive = [&evaluated]() {
+        ++evaluated;
+        return 42;
+    };
+
+    g_emitCount = 0;
+    lc.stdcDebug("%1", expensive());
+    lc.stdcDebugF("%d", expensive());
+    int afterDisabled = evaluated;
+    lc.stdcWarning("%1", expensive());
+    lc.stdcWarningF("%d", expensive());
+    int afterEnabled = evaluated;
+    int emitted = g_emitCount;
+
+    Logger::setLogCallback(prev);
+
+    BOOST_CHECK_EQUAL(afterDisabled, 0);
+    BOOST_CHECK_EQUAL(afterEnabled, 2);
+    BOOST_CHECK_EQUAL(emitted, 2);
+}
+
 // Every case above replaces the sink, so the built-in one had never been run. It dropped
 // Information, which is 4 against Success's 3 and so clears the level gate and reaches the
 // switch, where it had no case of its own. A debug build aborted on the assert there, a release
@@ -543,4 +721,745 @@ BOOST_AUTO_TEST_CASE(test_the_installed_filter_can_be_read_back) {
     BOOST_CHECK(c.isLevelEnabled(Logger::Debug));
 }
 
+// Async delivery keeps the order records were logged in, and flush() is the point at which all
+// of them have been seen.
+BOOST_AUTO_TEST_CASE(test_async_delivers_in_order) {
+    AsyncRecorder recorder;
+    AsyncGuard guard(recorder);
+
+    BOOST_REQUIRE(Logger::startAsync(16));
+    BOOST_CHECK(Logger::isAsync());
+    BOOST_CHECK(!Logger::startAsync(16)); // already on
+
+    LogCategory lc("stdc.async");
+    for (int i = 0; i < 500; ++i) {
+        lc.stdcInfo("%1", i);
+    }
+    Logger::flush();
+
+    std::vector<std::string> messages;
+    {
+        std::lock_guard lock(recorder.mutex);
+        messages = recorder.messages;
+    }
+    BOOST_REQUIRE_EQUAL(messages.size(), 500u);
+    for (int i = 0; i < 500; ++i) {
+        BOOST_CHECK_EQUAL(messages[i], std::to_string(i));
+    }
+    for (const auto &id : recorder.threads) {
+        BOOST_CHECK(id != std::this_thread::get_id());
+    }
+    BOOST_CHECK_EQUAL(Logger::droppedCount(), 0u);
+
+    Logger::stopAsync();
+    BOOST_CHECK(!Logger::isAsync());
+}
+
+// With the async mode on, numbers and strings are captured and formatted on the writer thread.
+// The text has to come out as the eager path would have made it, including for a temporary that
+// is long gone by the time the writer gets to it, and an argument that cannot be captured takes
+// the eager path in the same record.
+BOOST_AUTO_TEST_CASE(test_async_deferred_formatting_matches_eager) {
+    AsyncRecorder recorder;
+    AsyncGuard guard(recorder);
+
+    const char *fmt = "%1|%2|%3|%4|%5|%6|%7|%8|%9|%10";
+    auto expected = stdc::formatN(fmt, 42, -1.5, true, 'x', "literal", std::string("temporary"),
+                                  std::string_view("view"), uint64_t(-1), 0.25f, short(-7));
+    auto expectedPath = stdc::formatN("%1 %2", std::filesystem::path("a/b"), 3);
+
+    BOOST_REQUIRE(Logger::startAsync(16));
+    {
+        Logger logger(__FILE__, __LINE__, __FUNCTION__, "stdc.deferred");
+        logger.info(fmt, 42, -1.5, true, 'x', "literal", std::string("temporary"),
+                    std::string_view("view"), uint64_t(-1), 0.25f, short(-7));
+        logger.info("%1 %2", std::filesystem::path("a/b"), 3);
+        logger.info("%1<", static_cast<const char *>(nullptr));
+        logger.info("no arguments");
+    }
+    Logger::stopAsync();
+
+    BOOST_REQUIRE_EQUAL(recorder.messages.size(), 4u);
+    BOOST_CHECK_EQUAL(recorder.messages[0], expected);
+    BOOST_CHECK_EQUAL(recorder.messages[1], expectedPath);
+    BOOST_CHECK_EQUAL(recorder.messages[2], "<");
+    BOOST_CHECK_EQUAL(recorder.messages[3], "no arguments");
+}
+
+// Several producers on a small ring under Block: nothing is lost, and each thread's own records
+// stay in its order.
+BOOST_AUTO_TEST_CASE(test_async_multiple_producers) {
+    AsyncRecorder recorder;
+    AsyncGuard guard(recorder);
+
+    BOOST_REQUIRE(Logger::startAsync(8, Logger::Block));
+
+    constexpr int Threads = 4;
+    constexpr int PerThread = 300;
+    std::vector<std::thread> producers;
+    for (int t = 0; t < Threads; ++t) {
+        producers.emplace_back([t]() {
+            for (int i = 0; i < PerThread; ++i) {
+                stdcInfo("%1 %2", t, i);
+            }
+        });
+    }
+    for (auto &p : producers) {
+        p.join();
+    }
+    Logger::stopAsync(); // drains
+
+    std::vector<int> next(Threads, 0);
+    bool ordered = true;
+    for (const auto &message : recorder.messages) {
+        int t = 0, i = 0;
+        BOOST_REQUIRE_EQUAL(std::sscanf(message.c_str(), "%d %d", &t, &i), 2);
+        ordered = ordered && i == next[t];
+        next[t] = i + 1;
+    }
+    BOOST_CHECK_EQUAL(recorder.messages.size(), size_t(Threads * PerThread));
+    BOOST_CHECK(ordered);
+    BOOST_CHECK_EQUAL(Logger::droppedCount(), 0u);
+}
+
+namespace {
+
+    // Holds the sink shut on the first record, fills the ring of four behind it, then logs three
+    // more that cannot fit, and returns what came out once the sink opens again.
+    std::vector<std::string> overflowWith(Logger::OverflowPolicy policy, uint64_t &dropped) {
+        AsyncRecorder recorder;
+        AsyncGuard guard(recorder);
+        recorder.gateOpen = false;
+
+        BOOST_REQUIRE(Logger::startAsync(4, policy));
+        stdcInfo("0");
+        recorder.waitUntilEntered(); // the writer has taken it and is stuck in the sink
+        for (int i = 1; i < 8; ++i) {
+            stdcInfo("%1", i);
+        }
+        dropped = Logger::droppedCount();
+
+        recorder.open();
+        Logger::stopAsync();
+        return recorder.messages;
+    }
+
+}
+
+BOOST_AUTO_TEST_CASE(test_async_drop_newest) {
+    uint64_t dropped = 0;
+    auto messages = overflowWith(Logger::DropNewest, dropped);
+    BOOST_CHECK_EQUAL(dropped, 3u);
+    std::vector<std::string> expected{"0", "1", "2", "3", "4"};
+    BOOST_CHECK_EQUAL_COLLECTIONS(messages.begin(), messages.end(), expected.begin(),
+                                  expected.end());
+}
+
+BOOST_AUTO_TEST_CASE(test_async_drop_oldest) {
+    uint64_t dropped = 0;
+    auto messages = overflowWith(Logger::DropOldest, dropped);
+    BOOST_CHECK_EQUAL(dropped, 3u);
+    std::vector<std::string> expected{"0", "4", "5", "6", "7"};
+    BOOST_CHECK_EQUAL_COLLECTIONS(messages.begin(), messages.end(), expected.begin(),
+                                  expected.end());
+}
+
+// A Fatal record is what explains the abort that follows it, so it cannot be left in a queue the
+// abort will throw away. It is delivered on the thread that logged it, after everything queued
+// ahead of it. print() is called directly because fatal() would go on to abort.
+BOOST_AUTO_TEST_CASE(test_async_fatal_is_synchronous) {
+    AsyncRecorder recorder;
+    AsyncGuard guard(recorder);
+
+    BOOST_REQUIRE(Logger::startAsync(64));
+    for (int i = 0; i < 50; ++i) {
+        stdcInfo("%1", i);
+    }
+    Logger(__FILE__, __LINE__, __FUNCTION__, "stdc.fatal").print(Logger::Fatal, "fatal");
+
+    std::vector<std::string> messages;
+    std::vector<std::thread::id> threads;
+    {
+        std::lock_guard lock(recorder.mutex);
+        messages = recorder.messages;
+        threads = recorder.threads;
+    }
+    BOOST_REQUIRE_EQUAL(messages.size(), 51u);
+    BOOST_CHECK_EQUAL(messages.back(), "fatal");
+    BOOST_CHECK(threads.back() == std::this_thread::get_id());
+}
+
+namespace {
+
+    // Remembers what it was given, and how, for the sink cases below.
+    class RecordingSink : public LogSink {
+    public:
+        void write(const LogRecord &record) override {
+            std::lock_guard lock(mutex);
+            messages.emplace_back(record.message);
+            categories.emplace_back(record.context.category ? record.context.category : "");
+        }
+
+        void writeBatch(const array_view<LogRecord> &records) override {
+            {
+                std::unique_lock lock(mutex);
+                cv.wait(lock, [this]() { return gateOpen; });
+                ++batches;
+                largestBatch = std::max(largestBatch, records.size());
+            }
+            LogSink::writeBatch(records);
+        }
+
+        void flush() override {
+            std::lock_guard lock(mutex);
+            ++flushes;
+        }
+
+        void open() {
+            std::lock_guard lock(mutex);
+            gateOpen = true;
+            cv.notify_all();
+        }
+
+        std::mutex mutex;
+        std::condition_variable cv;
+        bool gateOpen = true;
+        std::vector<std::string> messages;
+        std::vector<std::string> categories;
+        size_t batches = 0;
+        size_t largestBatch = 0;
+        int flushes = 0;
+    };
+
+    // Takes the sinks back out whatever the case did, so that none outlives it.
+    struct SinkGuard {
+        std::vector<std::shared_ptr<LogSink>> sinks;
+        Logger::LogCallback prev = Logger::logCallback();
+
+        SinkGuard() {
+            Logger::setLogCallback(captureSink);
+        }
+
+        ~SinkGuard() {
+            for (const auto &sink : sinks) {
+                Logger::removeSink(sink);
+            }
+            Logger::setLogCallback(prev);
+        }
+    };
+
+}
+
+// Sinks sit beside the callback, each with its own level floor and category pattern, and are
+// handed the record's context as it was.
+BOOST_AUTO_TEST_CASE(test_sinks_filter_by_level_and_category) {
+    SinkGuard guard;
+    auto all = std::make_shared<RecordingSink>();
+    auto warnings = std::make_shared<RecordingSink>();
+    auto io = std::make_shared<RecordingSink>();
+    warnings->setMinimumLevel(Logger::Warning);
+    io->setCategoryFilter("*.io");
+    guard.sinks = {all, warnings, io};
+
+    BOOST_REQUIRE(Logger::addSink(all));
+    BOOST_REQUIRE(Logger::addSink(warnings));
+    BOOST_REQUIRE(Logger::addSink(io));
+    BOOST_CHECK(!Logger::addSink(all)); // once only
+    BOOST_CHECK(!Logger::addSink(std::shared_ptr<LogSink>()));
+
+    LogCategory net("stdc.net");
+    LogCategory disk("stdc.io");
+
+    g_emitCount = 0;
+    net.stdcInfo("net info");
+    net.stdcWarning("net warning");
+    disk.stdcDebug("io debug");
+
+    BOOST_CHECK_EQUAL(g_emitCount, 3); // the callback still sees everything
+    BOOST_CHECK_EQUAL(all->messages.size(), 3u);
+    BOOST_REQUIRE_EQUAL(warnings->messages.size(), 1u);
+    BOOST_CHECK_EQUAL(warnings->messages[0], "net warning");
+    BOOST_REQUIRE_EQUAL(io->messages.size(), 1u);
+    BOOST_CHECK_EQUAL(io->messages[0], "io debug");
+    BOOST_CHECK_EQUAL(io->categories[0], "stdc.io");
+
+    // removed, it hears nothing more
+    BOOST_CHECK(Logger::removeSink(all));
+    BOOST_CHECK(!Logger::removeSink(all));
+    net.stdcWarning("after removal");
+    BOOST_CHECK_EQUAL(all->messages.size(), 3u);
+    BOOST_CHECK_EQUAL(warnings->messages.size(), 2u);
+}
+
+// A function stands in for a subclass, with whatever it captures as its context.
+BOOST_AUTO_TEST_CASE(test_function_sink) {
+    SinkGuard guard;
+    std::vector<std::string> seen;
+    auto sink = Logger::addSink(
+        [&seen](const LogRecord &record) { seen.emplace_back(record.message); }, Logger::Success);
+    BOOST_REQUIRE(sink);
+    guard.sinks = {sink};
+
+    stdcDebug("dropped by the level");
+    stdcSuccess("kept %1", 1);
+    BOOST_CHECK(Logger::removeSink(sink));
+    stdcSuccess("kept %1", 2);
+
+    BOOST_REQUIRE_EQUAL(seen.size(), 1u);
+    BOOST_CHECK_EQUAL(seen[0], "kept 1");
+}
+
+// A queued sink runs on a thread of its own. Stalled, it holds up neither the thread that logs
+// nor the other sinks, and once it moves again it is handed what piled up in batches, in order.
+BOOST_AUTO_TEST_CASE(test_queued_sink_does_not_stall_the_others) {
+    SinkGuard guard;
+    auto slow = std::make_shared<RecordingSink>();
+    auto fast = std::make_shared<RecordingSink>();
+    slow->gateOpen = false;
+    guard.sinks = {slow, fast};
+
+    BOOST_REQUIRE(Logger::addSink(slow, 256));
+    BOOST_REQUIRE(Logger::addSink(fast));
+
+    for (int i = 0; i < 100; ++i) {
+        stdcInfo("%1", i);
+    }
+    BOOST_CHECK_EQUAL(fast->messages.size(), 100u);
+
+    slow->open();
+    Logger::flush();
+
+    std::vector<std::string> messages;
+    size_t batches, largest;
+    int flushes;
+    {
+        std::lock_guard lock(slow->mutex);
+        messages = slow->messages;
+        batches = slow->batches;
+        largest = slow->largestBatch;
+        flushes = slow->flushes;
+    }
+    BOOST_REQUIRE_EQUAL(messages.size(), 100u);
+    for (int i = 0; i < 100; ++i) {
+        BOOST_CHECK_EQUAL(messages[i], std::to_string(i));
+    }
+    BOOST_CHECK(largest > 1);
+    BOOST_CHECK(batches < 100u);
+    BOOST_CHECK(flushes >= 1);
+}
+
+// Fatal flushes every sink, queued or not, since nothing buffered survives the abort after it.
+BOOST_AUTO_TEST_CASE(test_fatal_flushes_the_sinks) {
+    SinkGuard guard;
+    auto queued = std::make_shared<RecordingSink>();
+    auto direct = std::make_shared<RecordingSink>();
+    guard.sinks = {queued, direct};
+    Logger::addSink(queued, 64);
+    Logger::addSink(direct);
+
+    stdcInfo("before");
+    Logger(__FILE__, __LINE__, __FUNCTION__, "stdc.fatal").print(Logger::Fatal, "fatal");
+
+    std::lock_guard lock(queued->mutex);
+    BOOST_REQUIRE_EQUAL(queued->messages.size(), 2u);
+    BOOST_CHECK_EQUAL(queued->messages[1], "fatal");
+    BOOST_CHECK_EQUAL(queued->flushes, 1);
+    BOOST_CHECK_EQUAL(direct->flushes, 1);
+}
+
+// Every call passes through the same call site, so they share one limiter, and the records
+// that do go out carry a count of the ones held back before them.
+BOOST_AUTO_TEST_CASE(test_every_n_and_first_n) {
+    LoggingGuard guard;
+    auto prev = Logger::logCallback();
+    Logger::setLogCallback(recordingSink);
+    LogCategory lc("stdc.limited");
+
+    g_records.clear();
+    for (int i = 0; i < 7; ++i) {
+        lc.stdcLogEveryN(Warning, 3, "every %1", i);
+    }
+    for (int i = 0; i < 4; ++i) {
+        lc.stdcLogFirstNF(Information, 2, "first %d", i);
+    }
+    Logger::setLogCallback(prev);
+
+    BOOST_REQUIRE_EQUAL(g_records.size(), 5u);
+    BOOST_CHECK_EQUAL(g_records[0].second, "every 0");
+    BOOST_CHECK_EQUAL(g_records[1].second, "every 3 (2 similar suppressed)");
+    BOOST_CHECK_EQUAL(g_records[2].second, "every 6 (2 similar suppressed)");
+    BOOST_CHECK_EQUAL(g_records[2].first, Logger::Warning);
+    BOOST_CHECK_EQUAL(g_records[3].second, "first 0");
+    BOOST_CHECK_EQUAL(g_records[4].second, "first 1 (limit reached, further ones suppressed)");
+}
+
+// Held back, a record's arguments are not evaluated, and a disabled level does not use up the
+// limit.
+BOOST_AUTO_TEST_CASE(test_limited_macros_skip_suppressed_arguments) {
+    LoggingGuard guard;
+    auto prev = Logger::logCallback();
+    Logger::setLogCallback(recordingSink);
+    LogCategory lc("stdc.limited.lazy");
+
+    int evaluated = 0;
+    auto expensive = [&evaluated]() { return ++evaluated; };
+
+    g_records.clear();
+    for (int i = 0; i < 4; ++i) {
+        lc.setLevelEnabled(Logger::Debug, i >= 2);
+        lc.stdcLogFirstN(Debug, 1, "%1", expensive());
+    }
+    Logger::setLogCallback(prev);
+
+    BOOST_CHECK_EQUAL(evaluated, 1);
+    BOOST_REQUIRE_EQUAL(g_records.size(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(test_per_second) {
+    LogLimiter limiter(LogLimiter::PerSecond, 5);
+    int passed = 0;
+    uint64_t reported = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 100; ++i) {
+        if (auto admission = limiter.admit()) {
+            ++passed;
+            reported += admission.suppressed;
+        }
+    }
+    // Five a second, and the loop may have straddled the turn of one.
+    auto seconds = std::chrono::duration_cast<std::chrono::seconds>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+    BOOST_CHECK_GE(passed, 5);
+    BOOST_CHECK_LE(passed, 5 * (seconds + 2));
+
+    // A later second starts over, and says what the last one held back.
+    std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+    auto admission = limiter.admit();
+    BOOST_CHECK(admission);
+    BOOST_CHECK_EQUAL(reported + admission.suppressed, uint64_t(100 - passed));
+}
+
+// Shared by every thread through the call site, the count still comes out exact.
+BOOST_AUTO_TEST_CASE(test_every_n_across_threads) {
+    LogLimiter limiter(LogLimiter::EveryN, 10);
+    std::atomic<int> passed{0};
+    std::atomic<uint64_t> suppressed{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&]() {
+            for (int i = 0; i < 1000; ++i) {
+                if (auto admission = limiter.admit()) {
+                    ++passed;
+                    suppressed += admission.suppressed;
+                }
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    BOOST_CHECK_EQUAL(passed.load(), 400);
+    // Less whatever was held back after the last one to pass, which nothing has reported yet.
+    BOOST_CHECK_LE(suppressed.load(), 3600u);
+}
+
+// The callback takes text, so it sees the fields appended to the message. A sink sees them as
+// they were given, types and all, whether the record went straight there or through the queue.
+BOOST_AUTO_TEST_CASE(test_structured_fields) {
+    SinkGuard guard;
+    Logger::setLogCallback(recordingSink);
+
+    struct Seen {
+        std::string message;
+        std::vector<std::pair<std::string, LogField::Type>> fields;
+        std::string text;
+    };
+    std::mutex mutex;
+    std::vector<Seen> seen;
+    auto sink = Logger::addSink([&](const LogRecord &record) {
+        Seen s{std::string(record.message), {}, {}};
+        for (const auto &field : record.fields) {
+            s.fields.emplace_back(std::string(field.key), field.type);
+        }
+        LogField::appendTo(s.text, record.fields);
+        std::lock_guard lock(mutex);
+        seen.push_back(std::move(s));
+    });
+    guard.sinks = {sink};
+
+    LogCategory lc("stdc.kv");
+    std::string peer = "db 1";
+    g_records.clear();
+    lc.stdcWarningKV("request failed", {"status", 503}, {"bytes", 12u}, {"ms", 1.5},
+                     {"peer", peer}, {"retry", true}, {"path", std::string("/a=b")});
+
+    BOOST_REQUIRE_EQUAL(g_records.size(), 1u);
+    BOOST_CHECK_EQUAL(g_records[0].second, "request failed status=503 bytes=12 ms=1.5 "
+                                           "peer=\"db 1\" retry=true path=\"/a=b\"");
+    BOOST_REQUIRE_EQUAL(seen.size(), 1u);
+    BOOST_CHECK_EQUAL(seen[0].message, "request failed");
+    BOOST_REQUIRE_EQUAL(seen[0].fields.size(), 6u);
+    BOOST_CHECK(seen[0].fields[0].second == LogField::Int);
+    BOOST_CHECK(seen[0].fields[1].second == LogField::UInt);
+    BOOST_CHECK(seen[0].fields[2].second == LogField::Double);
+    BOOST_CHECK(seen[0].fields[3].second == LogField::String);
+    BOOST_CHECK(seen[0].fields[4].second == LogField::Bool);
+
+    // Through the queue, the strings are copied and the values come back the same.
+    Logger::startAsync(64);
+    lc.stdcInfoKV("queued", {"peer", std::string("temporary")}, {"n", -7});
+    Logger::flush();
+    Logger::stopAsync();
+
+    std::lock_guard lock(mutex);
+    BOOST_REQUIRE_EQUAL(seen.size(), 2u);
+    BOOST_CHECK_EQUAL(seen[1].message, "queued");
+    BOOST_CHECK_EQUAL(seen[1].text, " peer=temporary n=-7");
+}
+
+// Every record is stamped where it is made, with the time and the thread, whichever way it
+// goes from there.
+BOOST_AUTO_TEST_CASE(test_records_carry_time_and_thread) {
+    SinkGuard guard;
+    std::mutex mutex;
+    std::vector<LogContext> seen;
+    auto sink = Logger::addSink([&](const LogRecord &record) {
+        std::lock_guard lock(mutex);
+        seen.push_back(record.context);
+    });
+    guard.sinks = {sink};
+
+    auto before = Logger::timestamp();
+    stdcInfo("here");
+    std::thread([]() { stdcInfo("there"); }).join();
+    Logger::startAsync(64);
+    stdcInfo("queued %1", 1);
+    Logger::flush();
+    Logger::stopAsync();
+    auto after = Logger::timestamp();
+
+    std::lock_guard lock(mutex);
+    BOOST_REQUIRE_EQUAL(seen.size(), 3u);
+    for (const auto &context : seen) {
+        BOOST_CHECK(context.time >= before && context.time <= after);
+        BOOST_CHECK(context.thread != 0);
+    }
+    BOOST_CHECK_EQUAL(seen[0].thread, Logger::currentThreadId());
+    BOOST_CHECK(seen[1].thread != seen[0].thread);
+    BOOST_CHECK_EQUAL(seen[2].thread, seen[0].thread); // the thread that logged, not the writer
+}
+
+// Whatever the clock, it counts from the same epoch as the system clock, and never goes back.
+BOOST_AUTO_TEST_CASE(test_timestamp_clocks) {
+    const auto tolerance = int64_t(100) * 1000000;
+    auto now = []() {
+        using namespace std::chrono;
+        return duration_cast<nanoseconds>(system_clock::now().time_since_epoch()).count();
+    };
+
+    BOOST_CHECK(Logger::timestampClock() == Logger::PreciseClock);
+    for (auto clock : {Logger::PreciseClock, Logger::CoarseClock, Logger::CycleCounter}) {
+        if (!Logger::setTimestampClock(clock)) {
+            continue; // not on this platform, or this processor
+        }
+        BOOST_CHECK(Logger::timestampClock() == clock);
+        auto t = Logger::timestamp();
+        BOOST_CHECK(std::abs(t - now()) < tolerance);
+        BOOST_CHECK(Logger::timestamp() >= t);
+    }
+#ifdef __linux__
+    BOOST_CHECK(Logger::setTimestampClock(Logger::CoarseClock));
+#endif
+    BOOST_CHECK(Logger::setTimestampClock(Logger::PreciseClock));
+}
+
+BOOST_AUTO_TEST_CASE(test_time_formatter) {
+    const int64_t second = 1000000000;
+    LogTimeFormatter formatter;
+    BOOST_CHECK_EQUAL(formatter.format(0), "1970-01-01 00:00:00.000");
+    BOOST_CHECK_EQUAL(formatter.format(61 * second + 5000000), "1970-01-01 00:01:01.005");
+
+    // Within the minute only the seconds change, and past it everything may.
+    BOOST_CHECK_EQUAL(formatter.format(119 * second + 999999999), "1970-01-01 00:01:59.999");
+    BOOST_CHECK_EQUAL(formatter.format(1792337400 * second), "2026-10-18 15:30:00.000");
+    BOOST_CHECK_EQUAL(formatter.format(-1), "1969-12-31 23:59:59.999");
+
+    LogTimeFormatter fine(true, LogTimeFormatter::Nanoseconds);
+    BOOST_CHECK_EQUAL(fine.format(3 * second + 42), "1970-01-01 00:00:03.000000042");
+    LogTimeFormatter coarse(true, LogTimeFormatter::Seconds);
+    BOOST_CHECK_EQUAL(coarse.format(3 * second + 42), "1970-01-01 00:00:03");
+}
+
+namespace {
+
+    std::string readWhole(const std::filesystem::path &path) {
+        std::string text;
+        if (FILE *f = std::fopen(path.string().c_str(), "rb")) {
+            char buf[4096];
+            size_t n;
+            while ((n = std::fread(buf, 1, sizeof(buf), f)) > 0) {
+                text.append(buf, n);
+            }
+            std::fclose(f);
+        }
+        return text;
+    }
+
+    // The lines of a dump that carry \a marker, with the time and the thread cut off the front.
+    std::vector<std::string> dumpedLines(const std::string &dump, const std::string &marker) {
+        std::vector<std::string> lines;
+        size_t pos = 0;
+        while (pos < dump.size()) {
+            auto end = dump.find('\n', pos);
+            auto line = dump.substr(pos, end - pos);
+            pos = end == std::string::npos ? dump.size() : end + 1;
+            if (line.find(marker) != std::string::npos) {
+                lines.push_back(line.substr(line.find("] ") + 2));
+            }
+        }
+        return lines;
+    }
+
+    struct FlightGuard {
+        std::filesystem::path path;
+
+        explicit FlightGuard(const std::string &name)
+            : path(std::filesystem::temp_directory_path() / name) {
+            std::filesystem::remove(path);
+        }
+
+        ~FlightGuard() {
+            Logger::stopFlightRecorder();
+            std::error_code ec;
+            std::filesystem::remove(path, ec);
+        }
+    };
+
+}
+
+// The recorder keeps what the filter rules switch off, and dumps it in the order it was logged
+// across threads, while the callback hears nothing more than before.
+BOOST_AUTO_TEST_CASE(test_flight_recorder_keeps_what_the_filters_drop) {
+    LoggingGuard guard;
+    FlightGuard flight("stdc_flight_filters.log");
+    auto prev = Logger::logCallback();
+    Logger::setLogCallback(recordingSink);
+    setRules("stdc.flight.trace = false");
+
+    Logger::FlightRecorderOptions options;
+    options.slotsPerThread = 16;
+    options.dumpPath = flight.path.string();
+    BOOST_REQUIRE(Logger::startFlightRecorder(options));
+
+    LogCategory lc("stdc.flight");
+    g_records.clear();
+    lc.stdcTrace("hidden %1", 1);
+    std::thread([&lc]() { lc.stdcInfo("from a thread"); }).join();
+    lc.stdcTraceF("hidden %d", 2);
+    lc.stdcLogEveryN(Trace, 1000, "hidden %1", 3);
+    lc.stdcTraceKV("hidden 4", {"field", 4});
+    lc.stdcWarning("shown");
+    Logger::setLogCallback(prev);
+    Logger::dumpFlightRecorder();
+
+    BOOST_CHECK_EQUAL(g_records.size(), 2u);
+    auto lines = dumpedLines(readWhole(flight.path), "stdc.flight:");
+    BOOST_REQUIRE_EQUAL(lines.size(), 6u);
+    BOOST_CHECK_EQUAL(lines[0], "trace stdc.flight: hidden 1");
+    BOOST_CHECK_EQUAL(lines[1], "info stdc.flight: from a thread");
+    BOOST_CHECK_EQUAL(lines[2], "trace stdc.flight: hidden 2");
+    BOOST_CHECK_EQUAL(lines[3], "trace stdc.flight: hidden 3");
+    BOOST_CHECK_EQUAL(lines[4], "trace stdc.flight: hidden 4");
+    BOOST_CHECK_EQUAL(lines[5], "warning stdc.flight: shown");
+}
+
+// A ring keeps the newest records it has room for, and a message too long for its slot is cut.
+BOOST_AUTO_TEST_CASE(test_flight_recorder_wraps_and_truncates) {
+    LoggingGuard guard;
+    FlightGuard flight("stdc_flight_wrap.log");
+    auto prev = Logger::logCallback();
+    Logger::setLogCallback(recordingSink);
+
+    Logger::FlightRecorderOptions options;
+    options.slotsPerThread = 4;
+    options.slotSize = 96;
+    options.dumpPath = flight.path.string();
+    BOOST_REQUIRE(Logger::startFlightRecorder(options));
+
+    LogCategory lc("stdc.wrap");
+    for (int i = 0; i < 9; ++i) {
+        lc.stdcInfo("record %1", i);
+    }
+    lc.stdcInfo(std::string(200, 'x'));
+    Logger::setLogCallback(prev);
+    Logger::dumpFlightRecorder();
+
+    auto lines = dumpedLines(readWhole(flight.path), "stdc.wrap:");
+    BOOST_REQUIRE_EQUAL(lines.size(), 4u);
+    BOOST_CHECK_EQUAL(lines[0], "info stdc.wrap: record 6");
+    BOOST_CHECK_EQUAL(lines[2], "info stdc.wrap: record 8");
+    BOOST_CHECK(lines[3].size() < 100);
+    BOOST_CHECK_EQUAL(lines[3].substr(lines[3].size() - 4), "x...");
+}
+
+#ifndef _WIN32
+// A crash dumps the rings on its way out, and the process still dies of the signal.
+BOOST_AUTO_TEST_CASE(test_flight_recorder_dumps_on_a_crash) {
+    FlightGuard flight("stdc_flight_crash.log");
+
+    pid_t child = fork();
+    BOOST_REQUIRE(child >= 0);
+    if (child == 0) {
+        // Not the test framework's handler, which the dump would chain to.
+        std::signal(SIGSEGV, SIG_DFL);
+        Logger::setLogCallback([](int, const LogContext &, const std::string_view &) {});
+        Logger::FlightRecorderOptions options;
+        options.dumpPath = flight.path.string();
+        options.crashHandler = true;
+        Logger::startFlightRecorder(options);
+        LogCategory lc("stdc.crash");
+        lc.stdcDebug("last words");
+        std::raise(SIGSEGV);
+        _exit(0);
+    }
+
+    int status = 0;
+    BOOST_REQUIRE_EQUAL(waitpid(child, &status, 0), child);
+    BOOST_CHECK(WIFSIGNALED(status));
+    BOOST_CHECK_EQUAL(WTERMSIG(status), SIGSEGV);
+    auto lines = dumpedLines(readWhole(flight.path), "stdc.crash:");
+    BOOST_REQUIRE_EQUAL(lines.size(), 1u);
+    BOOST_CHECK_EQUAL(lines[0], "debug stdc.crash: last words");
+}
+
+// A handler that was there first, a crash reporter's say, still gets the signal after the dump.
+BOOST_AUTO_TEST_CASE(test_flight_recorder_chains_to_the_previous_handler) {
+    FlightGuard flight("stdc_flight_chain.log");
+
+    pid_t child = fork();
+    BOOST_REQUIRE(child >= 0);
+    if (child == 0) {
+        std::signal(SIGSEGV, [](int) { _exit(42); });
+        Logger::setLogCallback([](int, const LogContext &, const std::string_view &) {});
+        Logger::FlightRecorderOptions options;
+        options.dumpPath = flight.path.string();
+        options.crashHandler = true;
+        Logger::startFlightRecorder(options);
+        LogCategory lc("stdc.chain");
+        lc.stdcDebug("before the reporter");
+        std::raise(SIGSEGV);
+        _exit(0);
+    }
+
+    int status = 0;
+    BOOST_REQUIRE_EQUAL(waitpid(child, &status, 0), child);
+    BOOST_REQUIRE(WIFEXITED(status));
+    BOOST_CHECK_EQUAL(WEXITSTATUS(status), 42);
+    auto lines = dumpedLines(readWhole(flight.path), "stdc.chain:");
+    BOOST_REQUIRE_EQUAL(lines.size(), 1u);
+    BOOST_CHECK_EQUAL(lines[0], "debug stdc.chain: before the reporter");
+}
+#endif
+
 BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
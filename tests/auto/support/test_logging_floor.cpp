@@ -0,0 +1,66 @@
+// SPDX-License-Identifier: MIT
+
+// A file of its own, since the floor is read where the macros expand and the rest of the logging
+// tests need every level compiled in. 4 is Information, so Trace, Debug and Success go.
+#define STDC_LOG_MIN_LEVEL 4
+
+#include <stdcorelib/support/logging.h>
+
+#include <boost/test/unit_test.hpp>
+
+using namespace stdc;
+
+BOOST_AUTO_TEST_SUITE(test_logging_floor)
+
+namespace {
+
+    int g_emitCount = 0;
+    int g_lastLevel = 0;
+
+    void countingSink(int level, const LogContext &, const std::string_view &) {
+        ++g_emitCount;
+        g_lastLevel = level;
+    }
+
+}
+
+// Below the floor nothing is emitted and nothing is evaluated, even though the filter rules have
+// every level on. At and above it the macros behave as they always do.
+BOOST_AUTO_TEST_CASE(test_levels_below_the_floor_are_compiled_out) {
+    auto prev = Logger::logCallback();
+    Logger::setLogCallback(countingSink);
+
+    LogCategory lc("stdc.floor");
+    BOOST_REQUIRE(lc.isLevelEnabled(Logger::Trace));
+
+    int evaluated = 0;
+    auto expensive = [&evaluated]() {
+        ++evaluated;
+        return 1;
+    };
+
+    g_emitCount = 0;
+    g_lastLevel = 0;
+    lc.stdcTrace("%1", expensive());
+    lc.stdcDebug("%1", expensive());
+    lc.stdcSuccessF("%d", expensive());
+    stdcDebug("%1", expensive());
+    int belowEvaluated = evaluated;
+    int belowEmitted = g_emitCount;
+
+    lc.stdcInfo("%1", expensive());
+    lc.stdcWarningF("%d", expensive());
+    int aboveEvaluated = evaluated;
+    int aboveEmitted = g_emitCount;
+    int lastLevel = g_lastLevel;
+
+    Logger::setLogCallback(prev);
+
+    BOOST_CHECK_EQUAL(belowEvaluated, 0);
+    BOOST_CHECK_EQUAL(belowEmitted, 0);
+    BOOST_CHECK_EQUAL(aboveEvaluated, 2);
+    BOOST_CHECK_EQUAL(aboveEmitted, 2);
+    BOOST_CHECK_EQUAL(lastLevel, int(Logger::Warning));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,279 @@
+// SPDX-License-Identifier: MIT
+
+#include <stdcorelib/support/logsinks.h>
+#include <stdcorelib/scope_guard.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+using namespace stdc;
+
+namespace fs = std::filesystem;
+
+BOOST_AUTO_TEST_SUITE(test_logsinks)
+
+namespace {
+
+    // A directory of its own for each case, emptied before and removed after.
+    class TempDir {
+    public:
+        explicit TempDir(const std::string &name)
+            : _path(fs::temp_directory_path() / ("stdc_logsinks_" + name)) {
+            std::error_code ec;
+            fs::remove_all(_path, ec);
+            fs::create_directories(_path);
+        }
+
+        ~TempDir() {
+            std::error_code ec;
+            fs::remove_all(_path, ec);
+        }
+
+        const fs::path &path() const {
+            return _path;
+        }
+
+    private:
+        fs::path _path;
+    };
+
+    std::string readFile(const fs::path &path) {
+        std::ifstream in(path, std::ios::binary);
+        std::ostringstream ss;
+        ss << in.rdbuf();
+        return ss.str();
+    }
+
+    // Everything in \a dir but the live file, by name.
+    std::vector<std::string> segments(const fs::path &dir, const fs::path &live) {
+        std::vector<std::string> names;
+        for (const auto &entry : fs::directory_iterator(dir)) {
+            if (entry.path().filename() != live.filename()) {
+                names.push_back(entry.path().filename().string());
+            }
+        }
+        std::sort(names.begin(), names.end());
+        return names;
+    }
+
+    LogRecord record(int level, const char *category, std::string_view message) {
+        LogRecord r;
+        r.level = level;
+        r.context.category = category;
+        r.message = message;
+        return r;
+    }
+
+}
+
+BOOST_AUTO_TEST_CASE(test_file_sink_buffers_until_flushed) {
+    TempDir dir("buffer");
+    FileLogSink::Options options;
+    options.path = dir.path() / "app.log";
+    options.flushInterval = {};
+
+    FileLogSink sink(options);
+    BOOST_REQUIRE(sink.isOpen());
+    BOOST_CHECK(!sink.error());
+
+    sink.write(record(Logger::Warning, "stdc.io", "cannot read"));
+    sink.write(record(Logger::Information, nullptr, "plain"));
+    BOOST_CHECK_EQUAL(readFile(options.path), "");
+
+    sink.flush();
+    BOOST_CHECK_EQUAL(readFile(options.path), "warning stdc.io: cannot read\ninfo: plain\n");
+}
+
+// With the interval set, a record that never fills the buffer still reaches the file, without
+// anybody flushing.
+BOOST_AUTO_TEST_CASE(test_file_sink_flushes_on_the_interval) {
+    TempDir dir("interval");
+    FileLogSink::Options options;
+    options.path = dir.path() / "app.log";
+    options.flushInterval = std::chrono::milliseconds(20);
+
+    FileLogSink sink(options);
+    sink.write(record(Logger::Information, nullptr, "soon"));
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (readFile(options.path).empty() && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    BOOST_CHECK_EQUAL(readFile(options.path), "info: soon\n");
+}
+
+// A buffer of one byte flushes every record, so every record past the first rotates the file.
+// Of the nine segments that makes, the two newest are kept, and they are the two records before
+// the last.
+BOOST_AUTO_TEST_CASE(test_file_sink_rotates_by_size_and_prunes) {
+    TempDir dir("size");
+    FileLogSink::Options options;
+    options.path = dir.path() / "app.log";
+    options.bufferSize = 1;
+    options.maxFileSize = 8;
+    options.maxFiles = 2;
+
+    // Named like a segment of some other file, and like nothing at all, neither of which the
+    // pruning may touch.
+    std::ofstream(dir.path() / "application.20200101-000000.log") << "x";
+    std::ofstream(dir.path() / "app.conf") << "x";
+
+    {
+        FileLogSink sink(options);
+        for (int i = 0; i < 10; ++i) {
+            sink.write(record(Logger::Information, nullptr, std::to_string(i)));
+        }
+    }
+
+    BOOST_CHECK_EQUAL(readFile(options.path), "info: 9\n");
+    BOOST_CHECK(fs::exists(dir.path() / "application.20200101-000000.log"));
+    BOOST_CHECK(fs::exists(dir.path() / "app.conf"));
+
+    std::vector<std::string> contents;
+    for (const auto &name : segments(dir.path(), options.path)) {
+        if (name.rfind("app.2", 0) == 0) {
+            contents.push_back(readFile(dir.path() / name));
+        }
+    }
+    std::sort(contents.begin(), contents.end());
+    BOOST_REQUIRE_EQUAL(contents.size(), 2u);
+    BOOST_CHECK_EQUAL(contents[0], "info: 7\n");
+    BOOST_CHECK_EQUAL(contents[1], "info: 8\n");
+}
+
+BOOST_AUTO_TEST_CASE(test_file_sink_archives_rotated_segments) {
+    TempDir dir("archive");
+    std::vector<fs::path> archived;
+
+    FileLogSink::Options options;
+    options.path = dir.path() / "app.log";
+    options.archive = [&archived](const fs::path &segment) {
+        // Stands in for compressing it: the segment is replaced by a file of its own stem.
+        auto target = segment;
+        target += ".gz";
+        fs::rename(segment, target);
+        archived.push_back(target);
+    };
+
+    {
+        FileLogSink sink(options);
+        sink.write(record(Logger::Information, nullptr, "first"));
+        BOOST_CHECK(sink.rotate());
+        sink.write(record(Logger::Information, nullptr, "second"));
+    }
+
+    BOOST_REQUIRE_EQUAL(archived.size(), 1u);
+    BOOST_CHECK_EQUAL(readFile(archived[0]), "info: first\n");
+    BOOST_CHECK_EQUAL(readFile(options.path), "info: second\n");
+    BOOST_CHECK_EQUAL(archived[0].filename().string().substr(0, 4), "app.");
+}
+
+BOOST_AUTO_TEST_CASE(test_file_sink_reports_an_open_failure) {
+    TempDir dir("missing");
+    FileLogSink::Options options;
+    options.path = dir.path() / "no" / "such" / "app.log";
+
+    FileLogSink sink(options);
+    BOOST_CHECK(!sink.isOpen());
+    BOOST_CHECK(sink.error());
+
+    // Dropped, not crashed on.
+    sink.write(record(Logger::Information, nullptr, "lost"));
+    sink.flush();
+}
+
+// Logger::flush() reaches the file, which is what a Fatal record relies on before the abort.
+BOOST_AUTO_TEST_CASE(test_file_sink_is_flushed_with_the_logger) {
+    TempDir dir("logger");
+    FileLogSink::Options options;
+    options.path = dir.path() / "app.log";
+    options.flushInterval = {};
+
+    auto sink = std::make_shared<FileLogSink>(options);
+    sink->setCategoryFilter("stdc.logsinks");
+    BOOST_REQUIRE(Logger::addSink(sink));
+
+    // The record is for the sink, not the console.
+    auto prev = Logger::logCallback();
+    Logger::setLogCallback([](int, const LogContext &, const std::string_view &) {});
+    auto restore = make_scope_guard([&]() {
+        Logger::removeSink(sink);
+        Logger::setLogCallback(prev);
+    });
+
+    LogCategory lc("stdc.logsinks");
+    lc.stdcInfo("value %1", 42);
+    BOOST_CHECK_EQUAL(readFile(options.path), "");
+
+    // Stamped by the logger, so the line starts with the time, "2026-10-18 15:30:00.123 ".
+    Logger::flush();
+    auto text = readFile(options.path);
+    BOOST_REQUIRE_EQUAL(text.size(), 24 + std::strlen("info stdc.logsinks: value 42\n"));
+    BOOST_CHECK_EQUAL(text.substr(24), "info stdc.logsinks: value 42\n");
+    BOOST_CHECK_EQUAL(text[4], '-');
+    BOOST_CHECK_EQUAL(text[19], '.');
+}
+
+BOOST_AUTO_TEST_CASE(test_structured_sink_json_lines) {
+    TempDir dir("jsonl");
+    StructuredLogSink::Options options;
+    options.path = dir.path() / "app.jsonl";
+
+    const LogField fields[] = {{"status", 503}, {"peer", "db 1"}, {"ok", false}};
+    auto r = record(Logger::Warning, "stdc.net", "request failed");
+    r.fields = fields;
+    {
+        StructuredLogSink sink(options);
+        sink.write(r);
+        sink.write(record(Logger::Information, nullptr, "plain"));
+    }
+
+    auto text = readFile(options.path);
+    auto newline = text.find('\n');
+    BOOST_REQUIRE(newline != std::string::npos);
+    std::string error;
+    auto first = JsonValue::fromJson(text.substr(0, newline), false, &error);
+    BOOST_REQUIRE(error.empty());
+    BOOST_CHECK(first == StructuredLogSink::toJsonValue(r));
+    BOOST_CHECK_EQUAL(first["level"].toString(), "warning");
+    BOOST_CHECK_EQUAL(first["category"].toString(), "stdc.net");
+    BOOST_CHECK_EQUAL(first["fields"]["status"].toInt(), 503);
+    BOOST_CHECK_EQUAL(first["fields"]["peer"].toString(), "db 1");
+    BOOST_CHECK(!first["fields"]["ok"].toBool(true));
+
+    auto second = JsonValue::fromJson(text.substr(newline + 1), false, &error);
+    BOOST_REQUIRE(error.empty());
+    BOOST_CHECK_EQUAL(second["message"].toString(), "plain");
+    BOOST_CHECK(second["category"].isNull());
+}
+
+BOOST_AUTO_TEST_CASE(test_structured_sink_cbor) {
+    TempDir dir("cbor");
+    StructuredLogSink::Options options;
+    options.path = dir.path() / "app.cbor";
+
+    const LogField fields[] = {{"bytes", uint64_t(1) << 40}, {"ms", 0.25}};
+    auto r = record(Logger::Critical, "stdc.io", "slow");
+    r.fields = fields;
+    {
+        StructuredLogSink sink(options, StructuredLogSink::Cbor);
+        sink.write(r);
+    }
+
+    auto data = readFile(options.path);
+    std::string error;
+    auto value = JsonValue::fromCbor(
+        array_view<uint8_t>(reinterpret_cast<const uint8_t *>(data.data()), data.size()), &error);
+    BOOST_REQUIRE(error.empty());
+    BOOST_CHECK(value == StructuredLogSink::toJsonValue(r));
+    BOOST_CHECK_EQUAL(value["fields"]["bytes"].toInt(), int64_t(1) << 40);
+    BOOST_CHECK(data.size() < StructuredLogSink::toJsonValue(r).toJson().size());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
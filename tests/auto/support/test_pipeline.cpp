@@ -0,0 +1,103 @@
+// SPDX-License-Identifier: MIT
+
+#include <stdcorelib/support/pipeline.h>
+
+#include <string>
+#include <vector>
+
+#include "../helpers/test_child.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace stdc;
+
+BOOST_AUTO_TEST_SUITE(test_pipeline)
+
+// A megabyte through three stages, more than any pipe holds, so every stage has to be reading
+// while the one before it writes.
+BOOST_AUTO_TEST_CASE(test_output_flows_from_stage_to_stage) {
+    Pipeline pipeline;
+    pipeline.add(child({"fill", "1000000"}))
+        .add(child({"cat"}))
+        .add(std::move(child({"cat"}).stdout_(Popen::PIPE)));
+    BOOST_CHECK_EQUAL(pipeline.size(), 3u);
+
+    std::string err;
+    BOOST_REQUIRE_MESSAGE(pipeline.start(&err), err);
+    auto output = pipeline.communicate({}, 30000);
+    BOOST_CHECK(!pipeline.error_code());
+    BOOST_CHECK_EQUAL(output.out.size(), 1000000u);
+    BOOST_REQUIRE_EQUAL(output.err.size(), 3u);
+
+    auto codes = pipeline.returncodes();
+    BOOST_REQUIRE_EQUAL(codes.size(), 3u);
+    for (const auto &code : codes) {
+        BOOST_CHECK_EQUAL(code.value_or(-1), 0);
+    }
+}
+
+// Input goes to the first stage. A stage that fails early on shows in returncodes() and not in
+// returncode(), as in a shell.
+BOOST_AUTO_TEST_CASE(test_input_and_pipestatus) {
+    Pipeline pipeline;
+    pipeline.add(std::move(child({"cat"}).stdin_(Popen::PIPE)))
+        .add(std::move(child({"cat"}).stdout_(Popen::PIPE)));
+    BOOST_REQUIRE(pipeline.start());
+    auto output = pipeline.communicate("one end to the other\n");
+    BOOST_CHECK_EQUAL(output.out, "one end to the other\n");
+
+    Pipeline failing;
+    failing.add(child({"exit", "3"}))
+        .add(child({"cat"}))
+        .add(std::move(child({"cat"}).stdout_(Popen::PIPE)));
+    BOOST_REQUIRE(failing.start());
+    BOOST_CHECK(failing.wait(30000));
+    auto codes = failing.returncodes();
+    BOOST_REQUIRE_EQUAL(codes.size(), 3u);
+    BOOST_CHECK_EQUAL(codes[0].value_or(-1), 3);
+    BOOST_CHECK_EQUAL(codes[1].value_or(-1), 0);
+    BOOST_CHECK_EQUAL(codes[2].value_or(-1), 0);
+    BOOST_CHECK_EQUAL(failing.returncode().value_or(-1), 0);
+}
+
+// stderr set to STDOUT goes down the pipe with the rest, and stderr set to PIPE comes back on
+// its own, for the stage it belongs to.
+BOOST_AUTO_TEST_CASE(test_stderr_merged_or_captured_per_stage) {
+    Pipeline merged;
+    merged.add(std::move(child({"fill", "3000", "both"}).stderr_(Popen::STDOUT)))
+        .add(std::move(child({"cat"}).stdout_(Popen::PIPE)));
+    BOOST_REQUIRE(merged.start());
+    auto output = merged.communicate({}, 30000);
+    BOOST_CHECK_EQUAL(output.out.size(), 6000u);
+    BOOST_CHECK(output.err[0].empty());
+
+    Pipeline captured;
+    captured.add(std::move(child({"fill", "3000", "both"}).stderr_(Popen::PIPE)))
+        .add(std::move(child({"cat"}).stdout_(Popen::PIPE).stderr_(Popen::PIPE)));
+    BOOST_REQUIRE(captured.start());
+    output = captured.communicate({}, 30000);
+    BOOST_CHECK_EQUAL(output.out.size(), 3000u);
+    BOOST_CHECK_EQUAL(output.err[0].size(), 3000u);
+    BOOST_CHECK(output.err[1].empty());
+}
+
+// A stage that cannot start takes the ones already running down with it, rather than leaving
+// them on pipes with nobody at the other end.
+BOOST_AUTO_TEST_CASE(test_a_stage_that_cannot_start) {
+    Pipeline pipeline;
+    pipeline.add(child({"cat"}));
+    Popen missing;
+    missing.args({"stdc-no-such-program-anywhere"});
+    pipeline.add(std::move(missing)).add(child({"cat"}));
+
+    std::string err;
+    BOOST_CHECK(!pipeline.start(&err));
+    BOOST_CHECK(pipeline.error_code());
+    BOOST_CHECK_EQUAL(err.rfind("stage 1: ", 0), 0u);
+    BOOST_CHECK(pipeline.stage(0).returncode());
+    BOOST_CHECK(!pipeline.stage(2).returncode());
+
+    BOOST_CHECK(!Pipeline().start());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -7,6 +7,7 @@
 #include <filesystem>
 #include <fstream>
 #include <iterator>
+#include <sstream>
 #include <string>
 #include <thread>
 #include <vector>
@@ -15,6 +16,8 @@
 #include <stdcorelib/support/popen.h>
 #include <stdcorelib/system.h>
 
+#include "../helpers/test_child.h"
+
 #include <boost/test/unit_test.hpp>
 
 #ifdef _WIN32
@@ -24,7 +27,9 @@
 #  include <cstring>
 #  include <dirent.h>
 #  include <fcntl.h>
+#  include <pthread.h>
 #  include <pwd.h>
+#  include <sys/resource.h>
 #  include <sys/wait.h>
 #  include <unistd.h>
 #endif
@@ -118,13 +123,6 @@ namespace {
         return {ShellExe, ShellFlag, script};
     }
 
-    // The helper program, with its mode and whatever the mode takes.
-    std::vector<std::string> child_args(std::vector<std::string> rest) {
-        std::vector<std::string> args = {TEST_CHILD_PATH};
-        args.insert(args.end(), rest.begin(), rest.end());
-        return args;
-    }
-
     // A path of our own under the temporary directory, removed by the guard that owns it.
     class TempFile {
     public:
@@ -203,6 +201,24 @@ BOOST_AUTO_TEST_CASE(test_run_and_returncode) {
     }
 }
 
+// What the child used arrives with its exit status, and not before. The child writes 64 MiB to
+// the null device, which is enough CPU to register and cannot be done in no memory at all.
+BOOST_AUTO_TEST_CASE(test_resource_usage) {
+    Popen p;
+    std::string err;
+    p.args(child_args({"fill", std::to_string(64L << 20)})).stdout_(Popen::DEVNULL);
+    BOOST_CHECK(!p.resource_usage());
+    BOOST_REQUIRE_MESSAGE(p.start(&err), err);
+    BOOST_REQUIRE(p.wait(Timeout));
+
+    auto usage = p.resource_usage();
+    BOOST_REQUIRE(usage);
+    BOOST_CHECK(usage->user_time + usage->system_time > std::chrono::microseconds(0));
+    BOOST_CHECK_GT(usage->max_rss, 0);
+    BOOST_CHECK_GE(usage->voluntary_switches, 0);
+    BOOST_CHECK_GE(usage->involuntary_switches, 0);
+}
+
 // A failed start is retryable after correcting the setup; stale error state must not turn a
 // successfully created child into a reported failure.
 BOOST_AUTO_TEST_CASE(test_start_retry) {
@@ -820,6 +836,55 @@ BOOST_AUTO_TEST_CASE(test_pass_fds) {
     }
 }
 
+// Closing is done in ranges between the descriptors to keep, so the ones on either side of a
+// kept one, and the far end of the table, are where an off by one would show.
+BOOST_AUTO_TEST_CASE(test_pass_fds_keep_exactly_what_they_name) {
+#ifdef __APPLE__
+    const char *script = "ls /dev/fd";
+#else
+    const char *script = "ls /proc/self/fd";
+#endif
+
+    // Plain descriptors, which a child would get without close_fds, in a row and one far off.
+    // Moved up from the lowest free numbers, one of which ls takes for the directory it lists.
+    std::vector<int> plain;
+    for (int i = 0; i < 3; i++) {
+        int fds[2];
+        BOOST_REQUIRE_EQUAL(pipe(fds), 0);
+        for (int fd : fds) {
+            plain.push_back(fcntl(fd, F_DUPFD, 100));
+            close(fd);
+        }
+    }
+    int far = dup2(plain[0], 900);
+    BOOST_REQUIRE_EQUAL(far, 900);
+    plain.push_back(far);
+    auto close_plain = make_scope_guard([&] {
+        for (int fd : plain) {
+            close(fd);
+        }
+    });
+
+    const std::vector<int> kept = {plain[1], plain[3], far};
+    Popen p;
+    std::string err;
+    p.args({"/bin/sh", "-c", script}).pass_fds(kept).stdout_(Popen::PIPE);
+    BOOST_REQUIRE_MESSAGE(p.start(&err), err);
+    auto [out, errout] = p.communicate({}, Timeout);
+
+    std::vector<int> listed;
+    std::istringstream lines(out);
+    for (std::string line; std::getline(lines, line);) {
+        listed.push_back(std::stoi(line));
+    }
+    for (int fd : plain) {
+        bool wanted = std::find(kept.begin(), kept.end(), fd) != kept.end();
+        bool seen = std::find(listed.begin(), listed.end(), fd) != listed.end();
+        BOOST_CHECK_MESSAGE(seen == wanted, "descriptor " + std::to_string(fd) +
+                                                (wanted ? " was closed" : " was left open"));
+    }
+}
+
 BOOST_AUTO_TEST_CASE(test_umask) {
     Popen p;
     std::string err;
@@ -851,6 +916,33 @@ BOOST_AUTO_TEST_CASE(test_session_and_process_group) {
     }
 }
 
+// Each limit is in place by the time the program runs, and one the kernel refuses fails the
+// start with the call named, rather than starting the child without it.
+BOOST_AUTO_TEST_CASE(test_rlimit) {
+    {
+        Popen p;
+        std::string err;
+        p.args({"/bin/sh", "-c", "ulimit -n; ulimit -t"})
+            .rlimit(RLIMIT_NOFILE, 64)
+            .rlimit(RLIMIT_CPU, 100)
+            .rlimit(RLIMIT_CPU, 30) // the later one wins
+            .stdout_(Popen::PIPE);
+        BOOST_REQUIRE_MESSAGE(p.start(&err), err);
+        auto [out, errout] = p.communicate({}, Timeout);
+        BOOST_CHECK_EQUAL(out, "64\n30\n");
+    }
+
+    {
+        Popen p;
+        std::string err;
+        p.args({"/bin/sh", "-c", "exit 0"}).rlimit(RLIMIT_NOFILE, 64, 32);
+        BOOST_CHECK(!p.start(&err));
+        BOOST_CHECK(p.error_code() == std::errc::invalid_argument);
+        BOOST_CHECK_MESSAGE(err.find("setrlimit") != std::string::npos, err);
+        BOOST_CHECK(!p.resource_usage());
+    }
+}
+
 #  ifdef F_GETPIPE_SZ
 BOOST_AUTO_TEST_CASE(test_pipesize) {
     Popen p;
@@ -901,6 +993,58 @@ BOOST_AUTO_TEST_CASE(test_restore_signals) {
     }
 }
 
+// Starting a child blocks every signal around the vfork on Linux. What the child gets is our
+// mask and default handlers, and what we get back afterwards is the mask we had.
+BOOST_AUTO_TEST_CASE(test_start_keeps_the_signal_mask_on_both_sides) {
+    struct CatchAndBlock {
+        CatchAndBlock() {
+            prev_usr1 = signal(SIGUSR1, [](int) {});
+            sigset_t usr2;
+            sigemptyset(&usr2);
+            sigaddset(&usr2, SIGUSR2);
+            pthread_sigmask(SIG_BLOCK, &usr2, &prev_mask);
+        }
+        ~CatchAndBlock() {
+            pthread_sigmask(SIG_SETMASK, &prev_mask, nullptr);
+            signal(SIGUSR1, prev_usr1);
+        }
+        void (*prev_usr1)(int);
+        sigset_t prev_mask;
+    } guard;
+
+    sigset_t before;
+    pthread_sigmask(SIG_SETMASK, nullptr, &before);
+
+    // Caught here, so the default in the child, which ends it.
+    {
+        Popen p;
+        std::string err;
+        p.args({"/bin/sh", "-c", "kill -USR1 $$; echo survived"}).stdout_(Popen::PIPE);
+        BOOST_REQUIRE_MESSAGE(p.start(&err), err);
+        auto [out, errout] = p.communicate({}, Timeout);
+        BOOST_CHECK(out.empty());
+        BOOST_REQUIRE(p.returncode());
+        BOOST_CHECK_EQUAL(*p.returncode(), -SIGUSR1);
+    }
+
+    // Blocked here, so blocked there too, and nothing is delivered.
+    {
+        Popen p;
+        std::string err;
+        p.args({"/bin/sh", "-c", "kill -USR2 $$; echo survived"}).stdout_(Popen::PIPE);
+        BOOST_REQUIRE_MESSAGE(p.start(&err), err);
+        auto [out, errout] = p.communicate({}, Timeout);
+        BOOST_CHECK_EQUAL(first_line(out), "survived");
+        BOOST_CHECK_EQUAL(p.returncode().value_or(-1), 0);
+    }
+
+    sigset_t after;
+    pthread_sigmask(SIG_SETMASK, nullptr, &after);
+    for (int sig = 1; sig < NSIG; ++sig) {
+        BOOST_CHECK_EQUAL(sigismember(&after, sig), sigismember(&before, sig));
+    }
+}
+
 // The guard communicate() holds over its poll loop, watched from outside.
 //
 // What the guard is for is the gap between poll saying a descriptor is writable and the write
@@ -1169,6 +1313,43 @@ BOOST_AUTO_TEST_CASE(test_polling_neither_kills_the_child_nor_misses_its_exit) {
     BOOST_CHECK_EQUAL(p.returncode().value_or(-1), 0);
 }
 
+// A wait with a timeout sleeps until the child exits or the time is up, whichever is first, and
+// running out of time is not an error.
+BOOST_AUTO_TEST_CASE(test_a_timed_wait_ends_with_the_child) {
+    Popen p;
+    std::string err;
+    p.args(child_args({"cat"})).stdin_(Popen::PIPE).stdout_(Popen::PIPE);
+    BOOST_REQUIRE_MESSAGE(p.start(&err), err);
+
+    auto started = std::chrono::steady_clock::now();
+    BOOST_CHECK(!p.wait(100));
+    BOOST_CHECK(std::chrono::steady_clock::now() - started >= std::chrono::milliseconds(100));
+    BOOST_CHECK(!p.returncode().has_value());
+    BOOST_CHECK(!p.error_code());
+
+    // Its input ends while the wait is under way, and the wait ends with it rather than at the
+    // timeout.
+    std::chrono::steady_clock::time_point closed;
+    std::thread closer([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        closed = std::chrono::steady_clock::now();
+        p.stdin_().close();
+    });
+    bool exited = p.wait(Timeout);
+    auto returned = std::chrono::steady_clock::now();
+    closer.join();
+
+    BOOST_REQUIRE(exited);
+    BOOST_CHECK_EQUAL(p.returncode().value_or(-1), 0);
+    // Woken by the exit rather than by a sleep, which by then would have grown to 50 ms. What
+    // is left is the child seeing the end of its input and exiting.
+    BOOST_CHECK_LT(std::chrono::duration_cast<std::chrono::milliseconds>(returned - closed).count(),
+                   20);
+#ifdef __linux__
+    BOOST_CHECK(p.exit_fd() != -1);
+#endif
+}
+
 BOOST_AUTO_TEST_CASE(test_argument_quoting) {
     const std::vector<std::string> tricky = {
         "plain",     "a b",   "  ",         "a\"b",   "\"lead",   "trail\"",
@@ -1373,6 +1554,76 @@ BOOST_AUTO_TEST_CASE(test_writing_one_character_at_a_time) {
     BOOST_CHECK_EQUAL(*p.returncode(), 0);
 }
 
+// The stream buffers what it can and gets out of the way of what it cannot: a transfer as large
+// as the buffer goes to the pipe in one call, and a smaller one waits in the buffer for more.
+// Both sides of that line have to arrive whole and in order, whatever bufsize() says.
+BOOST_AUTO_TEST_CASE(test_stream_buffer_sizes) {
+    const size_t bytes = 300 * 1000;
+    std::string payload(bytes, '\0');
+    for (size_t i = 0; i < bytes; ++i) {
+        payload[i] = char('a' + i % 26);
+    }
+
+    for (int bufsize : {-1, 0, 1, 4096}) {
+        BOOST_TEST_CONTEXT("bufsize " << bufsize) {
+            Popen p;
+            std::string err;
+            p.args(child_args({"cat"})).stdin_(Popen::PIPE).stdout_(Popen::PIPE).bufsize(bufsize);
+            BOOST_REQUIRE_MESSAGE(p.start(&err), err);
+
+            // The child echoes as it reads, so the writer gets a thread of its own to keep both
+            // pipes moving: small pieces, one character, and one piece larger than any buffer.
+            std::thread writer([&] {
+                auto &in = p.stdin_();
+                in.write(payload.data(), 1000);
+                for (size_t i = 1000; i < 2000; ++i) {
+                    in.put(payload[i]);
+                }
+                in.write(payload.data() + 2000, std::streamsize(bytes - 2000));
+                in.close();
+            });
+
+            std::string out(bytes, '\0');
+            auto &stream = p.stdout_();
+            stream.read(&out[0], 10);
+            for (size_t i = 10; i < 100; ++i) {
+                out[i] = char(stream.get());
+            }
+            stream.read(&out[100], std::streamsize(bytes - 100));
+            BOOST_CHECK_EQUAL(size_t(stream.gcount()), bytes - 100);
+            writer.join();
+
+            BOOST_CHECK(out == payload);
+            BOOST_CHECK(stream.get() == std::char_traits<char>::eof());
+            BOOST_REQUIRE(p.wait(Timeout));
+        }
+    }
+
+    // What the stream still holds goes out before anything written through file().
+    {
+        Popen p;
+        std::string err;
+        p.args(child_args({"cat"})).stdin_(Popen::PIPE).stdout_(Popen::PIPE);
+        BOOST_REQUIRE_MESSAGE(p.start(&err), err);
+
+        p.stdin_() << "first ";
+        FILE *raw = p.stdin_().file();
+        BOOST_REQUIRE(raw != nullptr);
+#ifdef _WIN32
+        BOOST_CHECK_EQUAL(_fileno(raw), p.stdin_().fd());
+#else
+        BOOST_CHECK_EQUAL(fileno(raw), p.stdin_().fd());
+#endif
+        std::fputs("second", raw);
+        p.stdin_().close();
+
+        std::string out((std::istreambuf_iterator<char>(p.stdout_())),
+                        std::istreambuf_iterator<char>());
+        BOOST_CHECK_EQUAL(out, "first second");
+        BOOST_REQUIRE(p.wait(Timeout));
+    }
+}
+
 // ---------------------------------------------------------------------------------------------
 // The lifetime of the Popen itself
 // ---------------------------------------------------------------------------------------------
@@ -1610,6 +1861,146 @@ BOOST_AUTO_TEST_CASE(test_both_pipes_fill) {
     }
 }
 
+// communicate() handing output over as it arrives rather than in a string at the end, to each of
+// the three places a Sink can send it.
+BOOST_AUTO_TEST_CASE(test_communicate_to_sinks) {
+    const long bytes = 512 * 1024;
+
+    // What fill writes, so that order can be checked as well as size.
+    std::string expected;
+    {
+        const std::string block =
+            "0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcde\n";
+        while (expected.size() < size_t(bytes)) {
+            expected += block.substr(0, std::min(block.size(), size_t(bytes) - expected.size()));
+        }
+    }
+
+    // to callbacks, both streams at once
+    {
+        Popen p;
+        std::string err;
+        p.args(child_args({"fill", std::to_string(bytes), "both"}))
+            .stdout_(Popen::PIPE)
+            .stderr_(Popen::PIPE);
+        BOOST_REQUIRE_MESSAGE(p.start(&err), err);
+
+        std::string out, errout;
+        size_t calls = 0;
+        BOOST_CHECK(p.communicate(
+            {},
+            Popen::Sink([&](std::string_view chunk) {
+                BOOST_CHECK(!chunk.empty());
+                out.append(chunk);
+                ++calls;
+            }),
+            Popen::Sink([&](std::string_view chunk) { errout.append(chunk); }), Timeout));
+        BOOST_CHECK(out == expected);
+        BOOST_CHECK(errout == expected);
+        BOOST_CHECK(calls > 1);
+        BOOST_REQUIRE(p.returncode());
+        BOOST_CHECK_EQUAL(*p.returncode(), 0);
+    }
+
+    // into a buffer of ours, which comes back full every time but the last
+    {
+        Popen p;
+        std::string err;
+        p.args(child_args({"fill", std::to_string(bytes)})).stdout_(Popen::PIPE);
+        BOOST_REQUIRE_MESSAGE(p.start(&err), err);
+
+        char buffer[1000];
+        std::string out;
+        std::vector<size_t> sizes;
+        BOOST_CHECK(p.communicate({},
+                                  Popen::Sink(buffer, sizeof(buffer),
+                                              [&](std::string_view chunk) {
+                                                  BOOST_CHECK(chunk.data() == buffer);
+                                                  out.append(chunk);
+                                                  sizes.push_back(chunk.size());
+                                              }),
+                                  Popen::Sink(), Timeout));
+        BOOST_CHECK(out == expected);
+        BOOST_REQUIRE_EQUAL(sizes.size(), (size_t(bytes) + sizeof(buffer) - 1) / sizeof(buffer));
+        for (size_t i = 0; i + 1 < sizes.size(); ++i) {
+            BOOST_CHECK_EQUAL(sizes[i], sizeof(buffer));
+        }
+        BOOST_CHECK_EQUAL(sizes.back(), size_t(bytes) % sizeof(buffer));
+    }
+
+    // into a descriptor of ours, which on Linux never passes through this process's memory
+    {
+        TempFile file("sink");
+        FILE *f = std::fopen(file.path().string().c_str(), "wb");
+        BOOST_REQUIRE(f != nullptr);
+#ifdef _WIN32
+        int fd = _fileno(f);
+#else
+        int fd = fileno(f);
+#endif
+
+        Popen p;
+        std::string err;
+        p.args(child_args({"fill", std::to_string(bytes), "both"}))
+            .stdout_(Popen::PIPE)
+            .stderr_(Popen::PIPE);
+        BOOST_REQUIRE_MESSAGE(p.start(&err), err);
+        BOOST_CHECK(p.communicate({}, Popen::Sink(fd), Popen::Sink(), Timeout));
+        std::fclose(f);
+        BOOST_CHECK(file.read() == expected);
+        BOOST_CHECK_EQUAL(*p.returncode(), 0);
+    }
+
+    // A descriptor that cannot be written fails the call, but the rest of the output is still
+    // read and thrown away, so the child is not left blocked on a full pipe.
+    {
+        TempFile file("readonly");
+        std::ofstream(file.path()) << "x";
+        FILE *f = std::fopen(file.path().string().c_str(), "rb");
+        BOOST_REQUIRE(f != nullptr);
+#ifdef _WIN32
+        int fd = _fileno(f);
+#else
+        int fd = fileno(f);
+#endif
+
+        Popen p;
+        std::string err;
+        p.args(child_args({"fill", std::to_string(bytes)})).stdout_(Popen::PIPE);
+        BOOST_REQUIRE_MESSAGE(p.start(&err), err);
+        BOOST_CHECK(!p.communicate({}, Popen::Sink(fd), Popen::Sink(), Timeout));
+        std::fclose(f);
+        BOOST_CHECK(p.error_code());
+        BOOST_CHECK(p.error_code() != std::errc::timed_out);
+        BOOST_REQUIRE(p.returncode());
+        BOOST_CHECK_EQUAL(*p.returncode(), 0);
+    }
+
+#ifndef _WIN32
+    // A descriptor nobody takes from holds the call no longer than its timeout, which then
+    // kills the child as for any other.
+    {
+        int fds[2];
+        BOOST_REQUIRE_EQUAL(::pipe(fds), 0);
+        ::fcntl(fds[1], F_SETFL, ::fcntl(fds[1], F_GETFL) | O_NONBLOCK);
+
+        Popen p;
+        std::string err;
+        p.args(child_args({"fill", std::to_string(bytes)})).stdout_(Popen::PIPE);
+        BOOST_REQUIRE_MESSAGE(p.start(&err), err);
+        auto started = std::chrono::steady_clock::now();
+        BOOST_CHECK(!p.communicate({}, Popen::Sink(fds[1]), Popen::Sink(), 300));
+        auto elapsed = std::chrono::steady_clock::now() - started;
+        ::close(fds[0]);
+        ::close(fds[1]);
+        BOOST_CHECK(p.error_code() == std::errc::timed_out);
+        BOOST_CHECK(elapsed < std::chrono::milliseconds(Timeout / 2));
+        BOOST_REQUIRE(p.returncode());
+        BOOST_CHECK_EQUAL(*p.returncode(), -SIGKILL);
+    }
+#endif
+}
+
 // A Popen can be moved, which is what lets a function build one and hand it back.
 BOOST_AUTO_TEST_CASE(test_move) {
     // Move construction takes the running child, its pipes and its pid across.
@@ -0,0 +1,113 @@
+// SPDX-License-Identifier: MIT
+
+#include <stdcorelib/support/processpool.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "../helpers/test_child.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace stdc;
+
+BOOST_AUTO_TEST_SUITE(test_processpool)
+
+// Input goes in, both pipes come out whole, even when the child fills them together, and each
+// result lands where its job was submitted.
+BOOST_AUTO_TEST_CASE(test_results_come_back_in_submitted_order) {
+    ProcessPool pool(2);
+    BOOST_CHECK_EQUAL(pool.max_running(), 2);
+
+    BOOST_CHECK_EQUAL(pool.submit(piped_child({"fill", "1000000", "both"})), 0u);
+    BOOST_CHECK_EQUAL(pool.submit(piped_child({"cat"}), "through the pool\n"), 1u);
+    BOOST_CHECK_EQUAL(pool.submit(piped_child({"exit", "7"})), 2u);
+    BOOST_CHECK_EQUAL(pool.submit(piped_child({"cat"})), 3u);
+
+    auto results = pool.run();
+    BOOST_REQUIRE_EQUAL(results.size(), 4u);
+    for (size_t i = 0; i < results.size(); ++i) {
+        BOOST_CHECK_EQUAL(results[i].index, i);
+        BOOST_CHECK(!results[i].error);
+        BOOST_CHECK_GT(results[i].pid, 0);
+        BOOST_REQUIRE(results[i].usage);
+        BOOST_CHECK_GT(results[i].usage->max_rss, 0);
+    }
+
+    BOOST_CHECK_EQUAL(results[0].returncode.value_or(-1), 0);
+    BOOST_CHECK_EQUAL(results[0].out.size(), 1000000u);
+    BOOST_CHECK_EQUAL(results[0].err.size(), 1000000u);
+
+    BOOST_CHECK_EQUAL(results[1].out, "through the pool\n");
+    BOOST_CHECK_EQUAL(results[2].returncode.value_or(-1), 7);
+    BOOST_CHECK_EQUAL(results[3].returncode.value_or(-1), 0);
+    BOOST_CHECK(results[3].out.empty());
+
+    // Ran, so the queue is empty for the next one.
+    BOOST_CHECK(pool.run().empty());
+}
+
+// Six jobs of 300 ms with two at a time take three rounds. Finishing sooner would mean more than
+// two ran at once.
+BOOST_AUTO_TEST_CASE(test_no_more_than_max_running_at_once) {
+    ProcessPool pool(2);
+    for (int i = 0; i < 6; ++i) {
+        pool.submit(piped_child({"sleep", "300"}));
+    }
+    auto started = std::chrono::steady_clock::now();
+    std::vector<size_t> order;
+    pool.run([&order](ProcessPool::Result &&result) {
+        BOOST_CHECK_EQUAL(result.returncode.value_or(-1), 0);
+        order.push_back(result.index);
+    });
+    auto elapsed = std::chrono::steady_clock::now() - started;
+
+    BOOST_CHECK_EQUAL(order.size(), 6u);
+    BOOST_CHECK(elapsed >= std::chrono::milliseconds(900));
+}
+
+// One job running past its timeout is killed and says so. The rest are not held up by it, and
+// one that never starts does not stop the others either.
+BOOST_AUTO_TEST_CASE(test_timeouts_and_start_failures_stay_with_their_job) {
+    ProcessPool pool(4);
+    pool.submit(piped_child({"sleep", "20000"}), {}, 200);
+    pool.submit(piped_child({"exit", "3"}), {}, 10000);
+
+    Popen missing;
+    missing.args({"stdc-no-such-program-anywhere"});
+    pool.submit(std::move(missing));
+
+    auto started = std::chrono::steady_clock::now();
+    auto results = pool.run(ProcessPool::Completed);
+    auto elapsed = std::chrono::steady_clock::now() - started;
+    BOOST_REQUIRE_EQUAL(results.size(), 3u);
+    BOOST_CHECK(elapsed < std::chrono::seconds(10));
+
+    // The failure is known at once, and the sleeper is the last to go.
+    BOOST_CHECK_EQUAL(results[0].index, 2u);
+    BOOST_CHECK(results[0].error);
+    BOOST_CHECK(!results[0].returncode);
+    BOOST_CHECK_EQUAL(results.back().index, 0u);
+    BOOST_CHECK(results.back().error == std::errc::timed_out);
+    BOOST_REQUIRE(results.back().returncode);
+    BOOST_CHECK_NE(*results.back().returncode, 0);
+
+    BOOST_CHECK_EQUAL(results[1].index, 1u);
+    BOOST_CHECK(!results[1].error);
+    BOOST_CHECK_EQUAL(results[1].returncode.value_or(-1), 3);
+}
+
+BOOST_AUTO_TEST_CASE(test_run_many) {
+    std::vector<Popen> jobs;
+    for (int i = 0; i < 20; ++i) {
+        jobs.push_back(piped_child({"exit", std::to_string(i)}));
+    }
+    auto results = run_many(std::move(jobs), 4);
+    BOOST_REQUIRE_EQUAL(results.size(), 20u);
+    for (size_t i = 0; i < results.size(); ++i) {
+        BOOST_CHECK_EQUAL(results[i].returncode.value_or(-1), int(i));
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,184 @@
+// SPDX-License-Identifier: MIT
+
+#ifndef _WIN32
+
+#include <algorithm>
+#include <chrono>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <poll.h>
+
+#include <stdcorelib/support/processreactor.h>
+
+#include "../helpers/test_child.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace stdc;
+using namespace std::chrono;
+
+BOOST_AUTO_TEST_SUITE(test_processreactor)
+
+namespace {
+
+    Popen started(std::vector<std::string> args) {
+        Popen p;
+        p.args(std::move(args)).stdin_(Popen::PIPE).stdout_(Popen::PIPE).stderr_(Popen::PIPE);
+        BOOST_REQUIRE(p.start());
+        return p;
+    }
+
+}
+
+// The point of chunks: the first line is heard while the child is still going, not once it ends.
+BOOST_AUTO_TEST_CASE(test_chunks_arrive_before_the_child_exits) {
+    ProcessReactor reactor;
+    std::string out;
+    std::string err;
+    steady_clock::time_point first_chunk;
+    steady_clock::time_point exited;
+    std::optional<int> code;
+
+    ProcessReactor::Handlers handlers;
+    handlers.on_stdout_chunk = [&](std::string_view chunk) {
+        if (out.empty()) {
+            first_chunk = steady_clock::now();
+        }
+        out.append(chunk);
+    };
+    handlers.on_stderr_chunk = [&](std::string_view chunk) {
+        err.append(chunk);
+    };
+    handlers.on_exit = [&](Popen &p, std::error_code error) {
+        exited = steady_clock::now();
+        code = p.returncode();
+        BOOST_CHECK(!error);
+    };
+    BOOST_REQUIRE(reactor.add(
+        started({"/bin/sh", "-c", "echo first; sleep 0.4; echo second; echo oops >&2; exit 3"}),
+        std::move(handlers)));
+    BOOST_CHECK_EQUAL(reactor.size(), 1u);
+
+    reactor.run();
+    BOOST_CHECK(reactor.empty());
+    BOOST_CHECK_EQUAL(out, "first\nsecond\n");
+    BOOST_CHECK_EQUAL(err, "oops\n");
+    BOOST_CHECK_EQUAL(code.value_or(-1), 3);
+    BOOST_CHECK(exited - first_chunk >= milliseconds(200));
+}
+
+// How an event loop of the caller's drives it: wait on fd() for no longer than next_timeout(),
+// then process_events(0), which never blocks.
+BOOST_AUTO_TEST_CASE(test_an_outside_loop_can_drive_it) {
+    ProcessReactor reactor;
+    std::vector<std::string> outs(3);
+    int exits = 0;
+    for (size_t i = 0; i < outs.size(); ++i) {
+        ProcessReactor::Handlers handlers;
+        handlers.on_stdout_chunk = [&outs, i](std::string_view chunk) {
+            outs[i].append(chunk);
+        };
+        handlers.on_exit = [&exits](Popen &p, std::error_code) {
+            BOOST_CHECK_EQUAL(p.returncode().value_or(-1), 0);
+            ++exits;
+        };
+        BOOST_REQUIRE(reactor.add(started(child_args({"cat"})), std::move(handlers),
+                                  "input " + std::to_string(i)));
+    }
+
+#ifdef __linux__
+    BOOST_CHECK_NE(reactor.fd(), -1);
+#endif
+    auto deadline = steady_clock::now() + seconds(30);
+    while (!reactor.empty() && steady_clock::now() < deadline) {
+        if (reactor.fd() != -1) {
+            struct pollfd pfd{reactor.fd(), POLLIN, 0};
+            ::poll(&pfd, 1, reactor.next_timeout());
+        } else {
+            std::this_thread::sleep_for(milliseconds(std::max(reactor.next_timeout(), 1)));
+        }
+        reactor.process_events(0);
+    }
+    BOOST_CHECK_EQUAL(exits, 3);
+    for (size_t i = 0; i < outs.size(); ++i) {
+        BOOST_CHECK_EQUAL(outs[i], "input " + std::to_string(i));
+    }
+}
+
+// What the caller already wrote through stdin_() reaches the child before the input handed to
+// add(), as it does with communicate().
+BOOST_AUTO_TEST_CASE(test_input_follows_what_the_stream_holds) {
+    ProcessReactor reactor;
+    std::string out;
+    ProcessReactor::Handlers handlers;
+    handlers.on_stdout_chunk = [&out](std::string_view chunk) {
+        out.append(chunk);
+    };
+    auto p = started(child_args({"cat"}));
+    p.stdin_() << "written first, ";
+    BOOST_REQUIRE(reactor.add(std::move(p), std::move(handlers), "then the input"));
+    reactor.run();
+    BOOST_CHECK_EQUAL(out, "written first, then the input");
+}
+
+// One that runs too long is killed and says why, and one that was never started is refused and
+// left where it was.
+BOOST_AUTO_TEST_CASE(test_timeouts_and_refusals) {
+    ProcessReactor reactor;
+    std::error_code why;
+    std::optional<int> code;
+    ProcessReactor::Handlers handlers;
+    handlers.on_exit = [&](Popen &p, std::error_code error) {
+        why = error;
+        code = p.returncode();
+    };
+    BOOST_REQUIRE(reactor.add(started(child_args({"sleep", "20000"})), std::move(handlers),
+                              {}, 100));
+
+    auto started_at = steady_clock::now();
+    reactor.run();
+    BOOST_CHECK(steady_clock::now() - started_at < seconds(10));
+    BOOST_CHECK(why == std::errc::timed_out);
+    BOOST_REQUIRE(code);
+    BOOST_CHECK_NE(*code, 0);
+
+    Popen never;
+    never.args(child_args({"exit", "0"}));
+    BOOST_CHECK(!reactor.add(std::move(never), {}));
+    BOOST_CHECK(reactor.empty());
+    BOOST_CHECK_EQUAL(never.args().size(), 3u);
+}
+
+// The descriptors on their own, for a loop that wants nothing else from this library.
+BOOST_AUTO_TEST_CASE(test_exit_fd_is_readable_once_the_child_exits) {
+    Popen p;
+    p.args(child_args({"sleep", "100"})).stdout_(Popen::PIPE);
+    BOOST_CHECK_EQUAL(p.exit_fd(), -1);
+    BOOST_CHECK_EQUAL(p.stdout_().fd(), -1);
+    BOOST_REQUIRE(p.start());
+
+    BOOST_CHECK_EQUAL(p.stdout_().fd(), ::fileno(p.stdout_().file()));
+    BOOST_CHECK_EQUAL(p.stdin_().fd(), -1);
+    p.stdout_().close();
+    BOOST_CHECK_EQUAL(p.stdout_().fd(), -1);
+
+    if (p.exit_fd() == -1) {
+        BOOST_TEST_MESSAGE("no pidfd here");
+        BOOST_CHECK(p.wait());
+        return;
+    }
+
+    struct pollfd pfd{p.exit_fd(), POLLIN, 0};
+    BOOST_CHECK_EQUAL(::poll(&pfd, 1, 0), 0);
+    BOOST_CHECK_EQUAL(::poll(&pfd, 1, 10000), 1);
+    BOOST_CHECK(!p.returncode());
+    BOOST_CHECK(p.poll());
+    BOOST_CHECK_EQUAL(p.returncode().value_or(-1), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+#endif // _WIN32
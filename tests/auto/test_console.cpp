@@ -2,6 +2,7 @@
 
 #include <stdcorelib/console.h>
 
+#include <chrono>
 #include <cstdio>
 #include <cstdlib>
 #include <memory>
@@ -407,6 +408,130 @@ BOOST_AUTO_TEST_CASE(test_attributes_compare) {
     BOOST_CHECK(attributes({bold, red, blue}) != attributes({bold, green, blue}));
 }
 
+// Attributes are written where they change and nowhere else, and dropping one goes through the
+// reset, since there is no code to turn it off on its own.
+BOOST_AUTO_TEST_CASE(test_styled_buffer_renders_only_the_changes) {
+    styled_buffer out;
+    out.append(nostyle, red, nocolor, "a");
+    out.append(nostyle, red, nocolor, "b");
+    out.append(bold, red, nocolor, "c");
+    out.append(nostyle, green, nocolor, "d");
+    out.append(nostyle, green, blue, "e");
+    out.append("f");
+
+    BOOST_CHECK_EQUAL(out.text(), "abcdef");
+    BOOST_CHECK_EQUAL(out.render(color_mode::never), "abcdef");
+    BOOST_CHECK_EQUAL(escaped(out.render(color_mode::vt)),
+                      "<ESC>[31mab<ESC>[1mc<ESC>[0m<ESC>[32md<ESC>[44me<ESC>[0mf");
+
+    // styled to the end, so the reset comes last
+    out.clear();
+    BOOST_CHECK(out.empty());
+    out.print(underline, nocolor, nocolor, "%1 of %2", 3, 4);
+    BOOST_CHECK_EQUAL(escaped(out.render(color_mode::vt)), "<ESC>[4m3 of 4<ESC>[0m");
+}
+
+BOOST_AUTO_TEST_CASE(test_styled_buffer_writes_what_it_renders) {
+    styled_buffer out;
+    out.append(bold, lightgreen, nocolor, "ok");
+    out.append(" done\n");
+
+    // a file under automatic gets the text alone
+    {
+        TempFile f;
+        BOOST_CHECK_EQUAL(out.write(f.get()), 8);
+        BOOST_CHECK_EQUAL(f.contents(), "ok done\n");
+    }
+
+    {
+        ColorModeGuard guard(color_mode::vt);
+        TempFile f;
+        BOOST_CHECK_EQUAL(out.write(f.get()), 8);
+        BOOST_CHECK_EQUAL(escaped(f.contents()), "<ESC>[92;1mok<ESC>[0m done<10>");
+    }
+}
+
+// Under vt the region draws in place: all of it the first time, then only the cells that
+// changed, and nothing at all while the interval holds the changes back.
+BOOST_AUTO_TEST_CASE(test_live_region_redraws_what_changed) {
+    ColorModeGuard guard(color_mode::vt);
+    TempFile f;
+    {
+        live_region region(2, f.get());
+        BOOST_CHECK(region.is_live());
+        region.set_interval(std::chrono::hours(1));
+
+        region.set_line(0, "copying abc");
+        region.set_line(0, "copying abd");
+        region.set_line(1, "12%");
+        region.refresh();
+
+        // narrower, so the tail goes
+        region.set_line(1, "9%");
+        region.refresh();
+
+        // the same again draws nothing
+        region.set_line(1, "9%");
+        region.refresh();
+
+        region.println("done with abc");
+    }
+    BOOST_CHECK_EQUAL(escaped(f.contents()),
+                      "copying abc<10><10>"
+                      "<ESC>[2A<ESC>[11Gd"
+                      "<ESC>[1B<ESC>[1G12%"
+                      "<ESC>[1B<13>"
+                      "<ESC>[1A<ESC>[1G9%<ESC>[K"
+                      "<ESC>[1B<13>"
+                      "<ESC>[2Adone with abc<ESC>[K<10>"
+                      "copying abd<ESC>[K<10>"
+                      "9%<ESC>[K<10>");
+}
+
+// Styled cells are compared with their attributes, and written with them.
+BOOST_AUTO_TEST_CASE(test_live_region_compares_attributes) {
+    ColorModeGuard guard(color_mode::vt);
+    TempFile f;
+    {
+        live_region region(1, f.get());
+        region.set_interval(std::chrono::hours(1));
+
+        styled_buffer line;
+        line.append("state ");
+        line.append(nostyle, green, nocolor, "ok");
+        region.set_line(0, line);
+
+        line.clear();
+        line.append("state ");
+        line.append(nostyle, red, nocolor, "ok");
+        region.set_line(0, line);
+    }
+    BOOST_CHECK_EQUAL(escaped(f.contents()),
+                      "state <ESC>[32mok<ESC>[0m<10>"
+                      "<ESC>[1A<ESC>[7G<ESC>[31mok<ESC>[0m<ESC>[1B<13>");
+}
+
+// Off a terminal there is no cursor to move, so the lines are printed whole, and only once the
+// plain interval has passed or the region is finished.
+BOOST_AUTO_TEST_CASE(test_live_region_prints_plainly_off_a_terminal) {
+    TempFile f;
+    {
+        live_region region(2, f.get());
+        BOOST_CHECK(!region.is_live());
+        region.set_plain_interval(std::chrono::hours(1));
+
+        region.set_line(0, "step 1");
+        region.set_line(0, "step 2");
+        region.println("a message");
+        region.set_line(0, "step 3");
+        region.set_line(1, "almost");
+    }
+    BOOST_CHECK_EQUAL(f.contents(), "step 1\n"
+                                    "a message\n"
+                                    "step 3\n"
+                                    "almost\n");
+}
+
 // How much room a piece of text takes on a terminal, which is not how long it is in bytes and
 // not how long it is in characters either.
 BOOST_AUTO_TEST_CASE(test_display_width_counts_columns) {
@@ -434,6 +559,54 @@ BOOST_AUTO_TEST_CASE(test_display_width_counts_columns) {
     BOOST_CHECK_EQUAL(display_width(U'\U0001F600'), 2);
 }
 
+// The whole of the tables rather than the blocks a program is likeliest to print, and the
+// sequences a terminal draws as one picture.
+BOOST_AUTO_TEST_CASE(test_display_width_follows_the_unicode_tables) {
+    // wide well outside the CJK blocks
+    BOOST_CHECK_EQUAL(display_width(U'\u231A'), 2);     // watch
+    BOOST_CHECK_EQUAL(display_width(U'\U00016FE0'), 2); // Tangut iteration mark
+    BOOST_CHECK_EQUAL(display_width(U'\U0001F680'), 2); // rocket, past the old emoji ranges
+    BOOST_CHECK_EQUAL(display_width(U'\U0002FFFD'), 2); // reserved for ideographs, unassigned
+
+    // zero width: enclosing marks, format characters, and the vowel half of a jamo syllable
+    BOOST_CHECK_EQUAL(display_width(U'\u20DD'), 0); // combining enclosing circle
+    BOOST_CHECK_EQUAL(display_width(U'\u200B'), 0); // zero width space
+    BOOST_CHECK_EQUAL(display_width(U'\u0591'), 0); // a Hebrew accent
+    BOOST_CHECK_EQUAL(display_width("\xe1\x84\x80\xe1\x85\xa1"), 2);
+
+    // narrow, and out of range
+    BOOST_CHECK_EQUAL(display_width(U'\u00E9'), 1);
+    BOOST_CHECK_EQUAL(display_width(U'\u2764'), 1);
+    BOOST_CHECK_EQUAL(display_width(char32_t(0x110000)), 1);
+
+    // a family joined by U+200D, a thumb with a skin tone, a flag, and a heart asked to be an
+    // emoji, each drawn as one picture of two columns
+    BOOST_CHECK_EQUAL(display_width("\xf0\x9f\x91\xa8\xe2\x80\x8d\xf0\x9f\x91\xa9\xe2\x80\x8d"
+                                    "\xf0\x9f\x91\xa7"),
+                      2);
+    BOOST_CHECK_EQUAL(display_width("\xf0\x9f\x91\x8d\xf0\x9f\x8f\xbd"), 2);
+    BOOST_CHECK_EQUAL(display_width("\xf0\x9f\x87\xaf\xf0\x9f\x87\xb5"), 2);
+    BOOST_CHECK_EQUAL(display_width("\xe2\x9d\xa4\xef\xb8\x8f"), 2);
+
+    // one flag letter alone, and three, which are a flag and a letter
+    BOOST_CHECK_EQUAL(display_width("\xf0\x9f\x87\xaf"), 1);
+    BOOST_CHECK_EQUAL(display_width("\xf0\x9f\x87\xaf\xf0\x9f\x87\xb5\xf0\x9f\x87\xaf"), 3);
+
+    // ASCII in between ends the cluster, and a joiner after it joins nothing
+    BOOST_CHECK_EQUAL(display_width("a\xe2\x80\x8d\xf0\x9f\x98\x80"), 3);
+
+    // long runs of ASCII, on either side of something that is not
+    std::string text(100, 'x');
+    BOOST_CHECK_EQUAL(display_width(text), 100);
+    text += "\xe4\xb8\xad";
+    text += std::string(13, 'y');
+    BOOST_CHECK_EQUAL(display_width(text), 115);
+
+    // a stray continuation byte and a truncated sequence each count as one replacement character
+    BOOST_CHECK_EQUAL(display_width("a\x80" "b"), 3);
+    BOOST_CHECK_EQUAL(display_width("a\xe4\xb8"), 2);
+}
+
 // A file is not a terminal, so there is nothing to ask and the fallback is the answer.
 BOOST_AUTO_TEST_CASE(test_width_falls_back_off_a_terminal) {
     TempFile file;
@@ -3,7 +3,9 @@
 #include <stdcorelib/str.h>
 
 #include <cstdarg>
+#include <cstdint>
 #include <map>
+#include <sstream>
 #include <string>
 #include <system_error>
 #include <vector>
@@ -18,6 +20,40 @@
 
 namespace fs = std::filesystem;
 
+namespace {
+
+    struct Point {
+        int x, y;
+    };
+
+    struct Counted {
+        int n;
+    };
+
+}
+
+// One of each kind of conversion: operator() alone, and the append hook formatN() prefers.
+template <>
+struct stdc::str::conv<Point> {
+    std::string operator()(const Point &p) const {
+        return "(" + std::to_string(p.x) + ", " + std::to_string(p.y) + ")";
+    }
+};
+
+template <>
+struct stdc::str::conv<Counted> {
+    static inline int appended = 0;
+
+    std::string operator()(const Counted &c) const {
+        return std::string(size_t(c.n), '*');
+    }
+
+    static void append(std::string &out, const Counted &c) {
+        ++appended;
+        out.append(size_t(c.n), '*');
+    }
+};
+
 using namespace stdc;
 
 BOOST_AUTO_TEST_SUITE(test_str)
@@ -374,6 +410,47 @@ BOOST_AUTO_TEST_CASE(test_format) {
     BOOST_CHECK_EQUAL(str::format("%1", {}), "%1");
 }
 
+// The engine formatN() now runs on writes into a caller's buffer. It appends rather than
+// replacing, and numbers come out as the stream they used to go through printed them.
+BOOST_AUTO_TEST_CASE(test_format_to) {
+    std::string buf = "> ";
+    formatN_to(buf, "%1 of %2", 3, "four");
+    BOOST_CHECK_EQUAL(buf, "> 3 of four");
+
+    buf.clear();
+    formatN_to(buf, "100%% %1", "done");
+    BOOST_CHECK_EQUAL(buf, "100% done");
+
+    // no arguments: appended verbatim, as formatN() returns it
+    buf.clear();
+    formatN_to(buf, "100%%");
+    BOOST_CHECK_EQUAL(buf, "100%%");
+
+    // the integer types all print as numbers, the character types among them
+    BOOST_CHECK_EQUAL(formatN("%1 %2 %3 %4", (signed char) -5, (unsigned char) 200, char32_t(65),
+                              uint64_t(-1)),
+                      "-5 200 65 18446744073709551615");
+    BOOST_CHECK_EQUAL(formatN("%1 %2", INT64_MIN, short(-7)), "-9223372036854775808 -7");
+
+    for (double value : {0.0, -0.0, 1.0, 0.1, 1.0 / 3, 123456.0, 1234567.0, 1e-5, 1e-4, 2.5e300,
+                         -7.25, 100.0, 1e21, 5e-324}) {
+        std::ostringstream oss;
+        oss << std::noshowpoint << value;
+        BOOST_CHECK_EQUAL(to_string(value), oss.str());
+        BOOST_CHECK_EQUAL(formatN("%1", float(value)), to_string(float(value)));
+    }
+    // a conv<> specialization of the caller's own, with and without an append hook
+    BOOST_CHECK_EQUAL(formatN("%1 %2", Point{1, 2}, Counted{3}), "(1, 2) ***");
+    BOOST_CHECK_EQUAL(str::conv<Counted>::appended, 1);
+    BOOST_CHECK_EQUAL(to_string(Counted{2}), "**");
+
+    {
+        std::ostringstream oss;
+        oss << std::noshowpoint << 3.14159265358979L;
+        BOOST_CHECK_EQUAL(to_string(3.14159265358979L), oss.str());
+    }
+}
+
 BOOST_AUTO_TEST_CASE(test_varexp) {
     const std::map<std::string, std::string> vars{
         {"FOO",   "Hello" },
@@ -0,0 +1,294 @@
+// SPDX-License-Identifier: MIT
+
+// What one log call costs, alone and with other threads logging at the same time.
+//
+//     test_logbenchmark                    every scenario at 1, 4, 16 and 64 threads
+//     test_logbenchmark -t 1,8 -n 50000    other thread counts, and records per thread
+//     test_logbenchmark file async         only the scenarios named
+//
+// Each thread makes its calls through a LogCategory, the way application code does, and times
+// every one of them on its own. The report gives the 50th, 99th and 99.9th percentile of those
+// times over all threads together, and the records per second all threads managed between them,
+// start to finish.
+//
+// The scenarios:
+//
+//     disabled   the level is switched off by a filter rule, so the call is the check alone
+//     null       enabled, into a callback that does nothing, which is the cost of formatting
+//     console    the default callback, with stdout and stderr sent to the null device
+//     file       a FileLogSink beside a callback that does nothing
+//     async      the async writer in front of a callback that does nothing
+//     async-file the async writer in front of a FileLogSink
+//
+// The timer is read twice around every call, which adds its own few tens of nanoseconds to each
+// figure. Compare scenarios with each other rather than against a number from elsewhere, and
+// build in release: a debug build measures the debug build.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <stdcorelib/support/logging.h>
+#include <stdcorelib/support/logsinks.h>
+
+#ifdef _WIN32
+#  include <io.h>
+#  define bench_dup    _dup
+#  define bench_dup2   _dup2
+#  define bench_close  _close
+#  define bench_fileno _fileno
+#  define NullDevice   "NUL"
+#else
+#  include <unistd.h>
+#  define bench_dup    dup
+#  define bench_dup2   dup2
+#  define bench_close  close
+#  define bench_fileno fileno
+#  define NullDevice   "/dev/null"
+#endif
+
+namespace fs = std::filesystem;
+using namespace std::chrono;
+using namespace stdc;
+
+namespace {
+
+    void nullCallback(int, const LogContext &, const std::string_view &) {
+    }
+
+    // Sends stdout and stderr to the null device for as long as it lives.
+    class Silenced {
+    public:
+        Silenced() {
+            std::fflush(stdout);
+            std::fflush(stderr);
+            _out = bench_dup(bench_fileno(stdout));
+            _err = bench_dup(bench_fileno(stderr));
+            if (FILE *null = std::fopen(NullDevice, "w")) {
+                bench_dup2(bench_fileno(null), bench_fileno(stdout));
+                bench_dup2(bench_fileno(null), bench_fileno(stderr));
+                std::fclose(null);
+            }
+        }
+
+        ~Silenced() {
+            std::fflush(stdout);
+            std::fflush(stderr);
+            bench_dup2(_out, bench_fileno(stdout));
+            bench_dup2(_err, bench_fileno(stderr));
+            bench_close(_out);
+            bench_close(_err);
+        }
+
+    private:
+        int _out;
+        int _err;
+    };
+
+    struct Scenario {
+        const char *name;
+        bool disabled;     // log at a level the rules switch off
+        bool console;      // leave the default callback in place
+        bool file;         // add a FileLogSink
+        bool async;        // start the async writer
+    };
+
+    const Scenario scenarios[] = {
+        {"disabled",   true,  false, false, false},
+        {"null",       false, false, false, false},
+        {"console",    false, true,  false, false},
+        {"file",       false, false, true,  false},
+        {"async",      false, false, false, true },
+        {"async-file", false, false, true,  true },
+    };
+
+    struct Result {
+        double p50 = 0;
+        double p99 = 0;
+        double p999 = 0;
+        double perSecond = 0;
+    };
+
+    double percentile(const std::vector<uint32_t> &sorted, double p) {
+        if (sorted.empty()) {
+            return 0;
+        }
+        auto i = size_t(p * double(sorted.size() - 1));
+        return sorted[i];
+    }
+
+    Result run(const Scenario &scenario, int threads, int records, const fs::path &dir) {
+        static LogCategory lc("bench.log");
+        lc.setFilterRules(scenario.disabled ? "bench.log.info = false" : "");
+
+        auto prevCallback = Logger::logCallback();
+        if (!scenario.console) {
+            Logger::setLogCallback(nullCallback);
+        }
+        std::shared_ptr<FileLogSink> sink;
+        if (scenario.file) {
+            FileLogSink::Options options;
+            options.path = dir / "bench.log";
+            options.maxFileSize = 64 << 20;
+            options.maxFiles = 2;
+            sink = std::make_shared<FileLogSink>(options);
+            Logger::addSink(sink);
+        }
+        if (scenario.async) {
+            Logger::startAsync(1 << 16);
+        }
+        std::unique_ptr<Silenced> silenced;
+        if (scenario.console) {
+            silenced = std::make_unique<Silenced>();
+        }
+
+        std::vector<std::vector<uint32_t>> latencies(threads);
+        std::atomic<int> ready{0};
+        std::atomic<bool> go{false};
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t]() {
+                auto &mine = latencies[t];
+                mine.reserve(records);
+                const std::string peer = "10.0.0." + std::to_string(t);
+                ready.fetch_add(1);
+                while (!go.load(std::memory_order_acquire)) {
+                    std::this_thread::yield();
+                }
+                for (int i = 0; i < records; ++i) {
+                    auto start = steady_clock::now();
+                    lc.stdcInfo("request %1 from %2 took %3 ms", i, peer, 1.5);
+                    auto end = steady_clock::now();
+                    mine.push_back(uint32_t(duration_cast<nanoseconds>(end - start).count()));
+                }
+            });
+        }
+        while (ready.load() < threads) {
+            std::this_thread::yield();
+        }
+        auto start = steady_clock::now();
+        go.store(true, std::memory_order_release);
+        for (auto &worker : workers) {
+            worker.join();
+        }
+        // A record is only written once it is out of the queue and the buffer, so the time
+        // includes getting there.
+        Logger::flush();
+        auto elapsed = duration_cast<duration<double>>(steady_clock::now() - start).count();
+
+        silenced.reset();
+        if (scenario.async) {
+            Logger::stopAsync();
+        }
+        if (sink) {
+            Logger::removeSink(sink);
+        }
+        Logger::setLogCallback(prevCallback);
+        lc.setFilterRules("");
+
+        std::vector<uint32_t> all;
+        all.reserve(size_t(threads) * size_t(records));
+        for (const auto &mine : latencies) {
+            all.insert(all.end(), mine.begin(), mine.end());
+        }
+        std::sort(all.begin(), all.end());
+
+        Result result;
+        result.p50 = percentile(all, 0.50);
+        result.p99 = percentile(all, 0.99);
+        result.p999 = percentile(all, 0.999);
+        result.perSecond = elapsed > 0 ? double(all.size()) / elapsed : 0;
+        return result;
+    }
+
+    std::vector<int> parseCounts(const char *text) {
+        std::vector<int> counts;
+        for (const char *p = text; *p;) {
+            char *end;
+            long n = std::strtol(p, &end, 10);
+            if (end == p || n <= 0) {
+                return {};
+            }
+            counts.push_back(int(n));
+            p = *end == ',' ? end + 1 : end;
+        }
+        return counts;
+    }
+
+    void usage(const char *argv0) {
+        std::fprintf(stderr, "usage: %s [-t 1,4,16,64] [-n records-per-thread] [scenario...]\n",
+                     argv0);
+        std::fprintf(stderr, "scenarios:");
+        for (const auto &scenario : scenarios) {
+            std::fprintf(stderr, " %s", scenario.name);
+        }
+        std::fprintf(stderr, "\n");
+    }
+
+}
+
+int main(int argc, char *argv[]) {
+    std::vector<int> threadCounts = {1, 4, 16, 64};
+    int records = 20000;
+    std::vector<const Scenario *> selected;
+
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "-t") && i + 1 < argc) {
+            threadCounts = parseCounts(argv[++i]);
+            if (threadCounts.empty()) {
+                usage(argv[0]);
+                return 2;
+            }
+            continue;
+        }
+        if (!std::strcmp(argv[i], "-n") && i + 1 < argc) {
+            records = std::atoi(argv[++i]);
+            if (records <= 0) {
+                usage(argv[0]);
+                return 2;
+            }
+            continue;
+        }
+        auto it = std::find_if(std::begin(scenarios), std::end(scenarios),
+                               [&](const Scenario &s) { return !std::strcmp(s.name, argv[i]); });
+        if (it == std::end(scenarios)) {
+            std::fprintf(stderr, "no scenario called %s\n", argv[i]);
+            usage(argv[0]);
+            return 2;
+        }
+        selected.push_back(&*it);
+    }
+    if (selected.empty()) {
+        for (const auto &scenario : scenarios) {
+            selected.push_back(&scenario);
+        }
+    }
+
+    auto dir = fs::temp_directory_path() / "stdc_logbenchmark";
+    std::error_code ec;
+    fs::remove_all(dir, ec);
+    fs::create_directories(dir, ec);
+
+    std::printf("%d records per thread, latencies in ns per call\n\n", records);
+    std::printf("  %-12s %7s %10s %10s %10s %14s\n", "scenario", "threads", "p50", "p99",
+                "p99.9", "records/s");
+    for (const auto *scenario : selected) {
+        for (int threads : threadCounts) {
+            auto result = run(*scenario, threads, records, dir);
+            std::printf("  %-12s %7d %10.0f %10.0f %10.0f %14.0f\n", scenario->name, threads,
+                        result.p50, result.p99, result.p999, result.perSecond);
+            std::fflush(stdout);
+        }
+    }
+
+    fs::remove_all(dir, ec);
+    return 0;
+}
@@ -0,0 +1,205 @@
+// SPDX-License-Identifier: MIT
+
+// How many children a second this process can start, and how that changes as it grows.
+//
+//     test_popenbenchmark                      0, 256, 1024 and 4096 MiB resident, both ways
+//     test_popenbenchmark -m 0,2048 -n 500     other sizes, and children per size
+//     test_popenbenchmark fork                 only the ways named
+//
+// Before each size the parent allocates that much and writes to every page of it, so it is
+// resident rather than reserved. Then it starts /bin/true over and over, waiting for each one,
+// and times start() on its own. The report gives the 50th and 99th percentile of those times
+// and the children per second, start and wait together.
+//
+// The ways:
+//
+//     spawn   what start() does by default, which on Linux is vfork()
+//     fork    the same child with a preexec_fn that does nothing, which forces a real fork()
+//
+// fork() copies the page tables of the parent, so its cost grows with what the parent has
+// resident. vfork() copies nothing, and its line should stay flat. The resident size printed is
+// what the system reports for the whole process, which includes the library and the allocator's
+// own overhead.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include <stdcorelib/support/popen.h>
+
+using namespace std::chrono;
+using namespace stdc;
+
+namespace {
+
+    struct Way {
+        const char *name;
+        bool fork; // set a preexec_fn
+    };
+
+    const Way ways[] = {
+        {"spawn", false},
+        {"fork",  true },
+    };
+
+    struct Result {
+        double p50 = 0;
+        double p99 = 0;
+        double perSecond = 0;
+        int failures = 0;
+    };
+
+    double percentile(const std::vector<uint32_t> &sorted, double p) {
+        if (sorted.empty()) {
+            return 0;
+        }
+        auto i = size_t(p * double(sorted.size() - 1));
+        return sorted[i];
+    }
+
+    // What is resident, in MiB, or -1 where the system does not say.
+    double residentMiB() {
+        FILE *statm = std::fopen("/proc/self/statm", "r");
+        if (!statm) {
+            return -1;
+        }
+        long size = 0, resident = 0;
+        int read = std::fscanf(statm, "%ld %ld", &size, &resident);
+        std::fclose(statm);
+        if (read != 2) {
+            return -1;
+        }
+        return double(resident) * double(sysconf(_SC_PAGESIZE)) / (1024 * 1024);
+    }
+
+    Result run(const Way &way, int children) {
+        std::vector<uint32_t> latencies;
+        latencies.reserve(children);
+        Result result;
+
+        auto start = steady_clock::now();
+        for (int i = 0; i < children; ++i) {
+            Popen p;
+            p.args({"/bin/true"});
+            if (way.fork) {
+                p.preexec_fn([] {});
+            }
+            auto before = steady_clock::now();
+            bool ok = p.start();
+            auto after = steady_clock::now();
+            if (!ok) {
+                result.failures++;
+                continue;
+            }
+            latencies.push_back(uint32_t(duration_cast<microseconds>(after - before).count()));
+            std::ignore = p.wait();
+        }
+        auto elapsed = duration_cast<duration<double>>(steady_clock::now() - start).count();
+
+        std::sort(latencies.begin(), latencies.end());
+        result.p50 = percentile(latencies, 0.50);
+        result.p99 = percentile(latencies, 0.99);
+        result.perSecond = elapsed > 0 ? double(latencies.size()) / elapsed : 0;
+        return result;
+    }
+
+    std::vector<int> parseCounts(const char *text) {
+        std::vector<int> counts;
+        for (const char *p = text; *p;) {
+            char *end;
+            long n = std::strtol(p, &end, 10);
+            if (end == p || n < 0) {
+                return {};
+            }
+            counts.push_back(int(n));
+            p = *end == ',' ? end + 1 : end;
+        }
+        return counts;
+    }
+
+    void usage(const char *argv0) {
+        std::fprintf(stderr, "usage: %s [-m 0,256,1024,4096] [-n children-per-size] [way...]\n",
+                     argv0);
+        std::fprintf(stderr, "ways:");
+        for (const auto &way : ways) {
+            std::fprintf(stderr, " %s", way.name);
+        }
+        std::fprintf(stderr, "\n");
+    }
+
+}
+
+int main(int argc, char *argv[]) {
+    std::vector<int> sizes = {0, 256, 1024, 4096};
+    int children = 200;
+    std::vector<const Way *> selected;
+
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "-m") && i + 1 < argc) {
+            sizes = parseCounts(argv[++i]);
+            if (sizes.empty()) {
+                usage(argv[0]);
+                return 2;
+            }
+            continue;
+        }
+        if (!std::strcmp(argv[i], "-n") && i + 1 < argc) {
+            children = std::atoi(argv[++i]);
+            if (children <= 0) {
+                usage(argv[0]);
+                return 2;
+            }
+            continue;
+        }
+        auto it = std::find_if(std::begin(ways), std::end(ways),
+                               [&](const Way &w) { return !std::strcmp(w.name, argv[i]); });
+        if (it == std::end(ways)) {
+            std::fprintf(stderr, "no way called %s\n", argv[i]);
+            usage(argv[0]);
+            return 2;
+        }
+        selected.push_back(&*it);
+    }
+    if (selected.empty()) {
+        for (const auto &way : ways) {
+            selected.push_back(&way);
+        }
+    }
+    std::sort(sizes.begin(), sizes.end());
+
+    std::printf("%d children per size, start() in us\n\n", children);
+    std::printf("  %-6s %12s %10s %10s %12s\n", "way", "rss MiB", "p50", "p99", "children/s");
+
+    // Grown in steps rather than allocated afresh for each size, so the sizes add up to the
+    // largest one and no more.
+    std::vector<std::unique_ptr<char[]>> ballast;
+    int held = 0;
+    for (int size : sizes) {
+        for (; held < size; ++held) {
+            std::unique_ptr<char[]> mib(new char[1 << 20]);
+            // Every page written, or it is only address space.
+            for (size_t offset = 0; offset < (1 << 20); offset += 4096) {
+                mib[offset] = char(offset);
+            }
+            ballast.push_back(std::move(mib));
+        }
+        for (const auto *way : selected) {
+            auto result = run(*way, children);
+            std::printf("  %-6s %12.0f %10.0f %10.0f %12.0f", way->name, residentMiB(),
+                        result.p50, result.p99, result.perSecond);
+            if (result.failures) {
+                std::printf("  (%d failed to start)", result.failures);
+            }
+            std::printf("\n");
+            std::fflush(stdout);
+        }
+    }
+    return 0;
+}